@@ -1,5 +1,6 @@
 import { RiveCanvas } from 'rive-canvas';
 import * as rive from './rive';
+import { MessageChannel } from 'worker_threads';
 
 // #region helper functions
 
@@ -380,6 +381,224 @@ test('Rive objects initialize correctly', done => {
   });
 });
 
+test('Rive objects release their runtime resources on cleanup', done => {
+  const canvas = document.createElement('canvas');
+  const r = new rive.Rive({
+    canvas: canvas,
+    buffer: pingPongRiveFileBuffer,
+    autoplay: true,
+    onload: () => {
+      expect(r.isPlaying).toBeTruthy();
+      r.cleanup();
+      expect(r.isStopped).toBeTruthy();
+      expect(r.bounds).toBeUndefined();
+      expect(r.contents).toBeUndefined();
+      done();
+    },
+  });
+});
+
+test('Rive objects loading the same file share it', done => {
+  const countBefore = rive.FileCache.count;
+  let loadCount = 0;
+  const onload = () => {
+    if (++loadCount < 2) {
+      return;
+    }
+    expect(rive.FileCache.count).toBeLessThanOrEqual(countBefore + 1);
+    first.cleanup();
+    second.cleanup();
+    done();
+  };
+  const first = new rive.Rive({
+    canvas: document.createElement('canvas'),
+    buffer: pingPongRiveFileBuffer,
+    onload: onload,
+  });
+  const second = new rive.Rive({
+    canvas: document.createElement('canvas'),
+    buffer: pingPongRiveFileBuffer,
+    onload: onload,
+  });
+});
+
+test('Rive objects loading different buffers get different files', done => {
+  // Same length and a single byte apart: the artboards are named
+  // 'New ArtboarX' and 'New ArtboarY', and no other test loads them
+  const renamed = (letter: number): ArrayBuffer => {
+    const bytes = pingPongRiveFileBytes.slice();
+    bytes[36] = letter;
+    return arrayToArrayBuffer(bytes);
+  };
+  const countBefore = rive.FileCache.count;
+  let loadCount = 0;
+  const onload = () => {
+    if (++loadCount < 2) {
+      return;
+    }
+    expect(rive.FileCache.count).toBe(countBefore + 2);
+    expect(first.contents.artboards[0].name).toBe('New ArtboarX');
+    expect(second.contents.artboards[0].name).toBe('New ArtboarY');
+    first.cleanup();
+    second.cleanup();
+    done();
+  };
+  const first = new rive.Rive({
+    canvas: document.createElement('canvas'),
+    buffer: renamed(0x58),
+    onload: onload,
+  });
+  const second = new rive.Rive({
+    canvas: document.createElement('canvas'),
+    buffer: renamed(0x59),
+    onload: onload,
+  });
+});
+
+test('File cache counts buffer copies and dedupes colliding buffers', async () => {
+  const runtime: RiveCanvas = await rive.RuntimeLoader.awaitInstance();
+  // Artboard names chosen so that the two files' FNV-1a hashes collide
+  const named = (name: string): ArrayBuffer => {
+    const bytes = pingPongRiveFileBytes.slice();
+    for (let i = 0; i < name.length; i++) {
+      bytes[25 + i] = name.charCodeAt(i);
+    }
+    return arrayToArrayBuffer(bytes);
+  };
+  const first = named('lcdaHyhJQgUL');
+  const second = named('kcUuAOfOUjUQ');
+
+  rive.FileCache.purge();
+  const bytesBefore = rive.FileCache.bytes;
+  const countBefore = rive.FileCache.count;
+  const firstFile = await rive.FileCache.loadBuffer(runtime, first);
+  // The imported data and the copy kept to compare with
+  expect(rive.FileCache.bytes - bytesBefore).toBe(2 * first.byteLength);
+  const secondFile = await rive.FileCache.loadBuffer(runtime, second);
+  expect(secondFile).not.toBe(firstFile);
+  expect(rive.FileCache.count).toBe(countBefore + 2);
+
+  // Evicting the first of the colliding files still finds the second
+  firstFile.release();
+  rive.FileCache.purge();
+  const secondAgain = await rive.FileCache.loadBuffer(runtime, second);
+  expect(secondAgain).toBe(secondFile);
+  expect(rive.FileCache.count).toBe(countBefore + 1);
+  secondFile.release();
+  secondAgain.release();
+});
+
+// The ping pong file's artboard has a solid background fill and a single
+// rectangle shape with a solid fill, which is moved back and forth
+test('Frame stats count what the first frame draws', done => {
+  const canvas = document.createElement('canvas');
+  const frames: rive.FrameStats[] = [];
+  const r = new rive.Rive({
+    canvas: canvas,
+    buffer: pingPongRiveFileBuffer,
+    autoplay: true,
+  });
+  // Enabled before loading, so that the first frame is measured too
+  r.enableFrameStats();
+  const endFrame = (r as any).endFrame.bind(r);
+  (r as any).endFrame = (result: number) => {
+    endFrame(result);
+    frames.push(r.frameStats);
+    if (frames.length < 2) {
+      return;
+    }
+    const [first, second] = frames;
+    expect(first.pathsDrawn).toBe(2);
+    // Both are rectangles: a move, three lines and a close each
+    expect(first.pathVerbs).toBeGreaterThanOrEqual(10);
+    expect(first.saveDepth).toBeGreaterThanOrEqual(1);
+    expect(first.gradientsRebuilt).toBe(0);
+    // The instance's paths are first built when it first advances
+    expect(first.pathsRebuilt).toBeGreaterThan(0);
+    // Moving the shape redraws the same paths
+    expect(second.pathsDrawn).toBe(2);
+    expect(second.gradientsRebuilt).toBe(0);
+    (r as any).endFrame = endFrame;
+    r.cleanup();
+    done();
+  };
+});
+
+test('Frame stats are only available while enabled', done => {
+  const canvas = document.createElement('canvas');
+  const r = new rive.Rive({
+    canvas: canvas,
+    buffer: pingPongRiveFileBuffer,
+    autoplay: true,
+    onload: () => {
+      expect(r.frameStats).toBeNull();
+      r.enableFrameStats();
+      expect(r.frameStats).not.toBeNull();
+      // Wait for a frame drawn with stats enabled
+      const check = () => {
+        const stats = r.frameStats;
+        if (stats.pathsDrawn === 0) {
+          setTimeout(check, 16);
+          return;
+        }
+        expect(stats.pathVerbs).toBeGreaterThan(0);
+        expect(stats.advanceMicros).toBeGreaterThanOrEqual(0);
+        expect(stats.applyMicros).toBeGreaterThanOrEqual(0);
+        expect(stats.drawMicros).toBeGreaterThanOrEqual(0);
+        r.disableFrameStats();
+        expect(r.frameStats).toBeNull();
+        r.cleanup();
+        done();
+      };
+      check();
+    },
+  });
+});
+
+test('Hit testing outside of the artboard finds nothing', done => {
+  const canvas = document.createElement('canvas');
+  const r = new rive.Rive({
+    canvas: canvas,
+    buffer: pingPongRiveFileBuffer,
+    onload: () => {
+      expect(r.hitTest(-10, -10)).toBeNull();
+      r.cleanup();
+      expect(r.hitTest(0, 0)).toBeNull();
+      done();
+    },
+  });
+});
+
+test('Hit testing finds the shape drawn at a point', done => {
+  // pingPong's square, named 'Square' and rotated about its center by the
+  // animation rather than moved, so its center is hit at any time. The
+  // canvas is the artboard's size, so canvas pixels are artboard pixels
+  // whether or not a frame has been drawn yet
+  const bytes = pingPongRiveFileBytes.slice();
+  const keyedX = bytes.findIndex(
+    (byte, i) => byte === 0x35 && bytes[i + 1] === 0x0D
+  );
+  bytes[keyedX + 1] = 0x0F;
+  // Byte 38 starts the shape; its name (property 4) goes first
+  const name = Array.from('Square', c => c.charCodeAt(0));
+  bytes.splice(39, 0, 0x04, name.length, ...name);
+
+  const canvas = document.createElement('canvas');
+  canvas.width = 500;
+  canvas.height = 500;
+  const r = new rive.Rive({
+    canvas: canvas,
+    buffer: arrayToArrayBuffer(bytes),
+    onload: () => {
+      expect(r.hitTest(250, 250)).toBe('Square');
+      // The artboard's background isn't a shape
+      expect(r.hitTest(5, 5)).toBeNull();
+      r.cleanup();
+      done();
+    },
+  });
+});
+
 test('Corrupt Rive file cause explosions', done => {
   const canvas = document.createElement('canvas');
   const r = new rive.Rive({
@@ -888,6 +1107,64 @@ test('Instanced state machine inputs can be retrieved', done => {
   });
 });
 
+test('State machine inputs set many times in a frame keep the last value', done => {
+  const canvas = document.createElement('canvas');
+  let changes = 0;
+  const r = new rive.Rive({
+    canvas: canvas,
+    buffer: stateMachineFileBuffer,
+    stateMachines: 'StateMachine',
+    autoplay: true,
+    onplay: () => {
+      const inputs = r.stateMachineInputs('StateMachine');
+      for (let i = 1; i <= 50; i++) {
+        inputs[0].value = i;
+        inputs[1].value = i % 2 === 0;
+      }
+      expect(inputs[0].value).toBe(50);
+      expect(inputs[1].value).toBe(true);
+    },
+    onstatechange: () => {
+      // Written to the runtime once the next frame began
+      if (++changes === 1) {
+        const inputs = r.stateMachineInputs('StateMachine');
+        expect(inputs[0].value).toBe(50);
+        expect(inputs[1].value).toBe(true);
+        done();
+      }
+    },
+  });
+});
+
+test('State machine inputs don\'t restart stopped rendering', done => {
+  const canvas = document.createElement('canvas');
+  let stopped = false;
+  const r = new rive.Rive({
+    canvas: canvas,
+    buffer: stateMachineFileBuffer,
+    stateMachines: 'StateMachine',
+    autoplay: true,
+    onplay: () => {
+      // Playing again below fires this once more
+      if (stopped) {
+        return;
+      }
+      stopped = true;
+      const scheduled = (r as any).scheduledTask;
+      r.stopRendering();
+      const inputs = r.stateMachineInputs('StateMachine');
+      inputs[0].value = 5;
+      inputs[1].value = !inputs[1].value;
+      r.play('StateMachine');
+      expect(rive.FrameScheduler.isPending(scheduled)).toBe(false);
+      r.startRendering();
+      expect(rive.FrameScheduler.isPending(scheduled)).toBe(true);
+      r.cleanup();
+      done();
+    },
+  });
+});
+
 test('Playing state machines can be manually started, paused, and restarted', done => {
   const canvas = document.createElement('canvas');
   let hasPaused = false;
@@ -992,4 +1269,265 @@ test('An animation can be played and scrubbed without altering playback state',
   });
 });
 
-// #endregion
\ No newline at end of file
+// #endregion
+
+// #region worker
+
+// The host and proxy talk over a node MessageChannel, which clones messages as
+// a worker's would; canvases can't be transferred under node, so the host
+// renders into a mock canvas of its own
+const hostWorkerChannel = (): MessageChannel => {
+  const channel = new MessageChannel();
+  rive.RiveWorkerHost.listen(channel.port1, {
+    createCanvas: () => document.createElement('canvas'),
+  });
+  return channel;
+}
+
+test('Rive objects can be played in a worker through a proxy', done => {
+  const channel = hostWorkerChannel();
+  const r = new rive.RiveProxy({
+    canvas: document.createElement('canvas'),
+    buffer: stateMachineFileBuffer,
+    worker: channel.port2,
+    onload: () => {
+      expect(r.animationNames.length).toBeGreaterThan(0);
+      expect(r.contents.artboards.length).toBeGreaterThan(0);
+      expect(r.bounds).toBeDefined();
+      r.play(r.animationNames[0]);
+      // State is mirrored from the worker's events, so isn't updated yet
+      expect(r.isPlaying).toBeFalsy();
+    },
+    onplay: () => {
+      expect(r.isPlaying).toBeTruthy();
+      expect(r.playingAnimationNames).toHaveLength(1);
+      r.cleanup();
+      expect(r.contents).toBeUndefined();
+      channel.port1.close();
+      done();
+    },
+  });
+});
+
+test('State machine inputs set through a proxy reach the worker', done => {
+  const channel = hostWorkerChannel();
+  let state = 0;
+  const r = new rive.RiveProxy({
+    canvas: document.createElement('canvas'),
+    buffer: stateMachineFileBuffer,
+    worker: channel.port2,
+    artboard: 'MyArtboard',
+    stateMachines: 'StateMachine',
+    autoplay: true,
+    onstatechange: ({data: stateNames}) => {
+      const inputs = r.stateMachineInputs('StateMachine');
+      expect(inputs).toHaveLength(3);
+      if (state === 0) {
+        expect((stateNames as string[])[0]).toBe('LoopingAnimation');
+        state++;
+        inputs[2].fire();
+      } else if (state === 1) {
+        expect((stateNames as string[])[0]).toBe('PingPongAnimation');
+        state++;
+        inputs[1].value = true;
+      } else if (state === 2) {
+        expect((stateNames as string[])[0]).toBe('exit');
+        r.cleanup();
+        channel.port1.close();
+        done();
+      }
+    },
+  });
+});
+
+test('Proxy state machine inputs stay live across worker events', done => {
+  const channel = hostWorkerChannel();
+  let held: rive.ProxyStateMachineInput[];
+  let state = 0;
+  const r = new rive.RiveProxy({
+    canvas: document.createElement('canvas'),
+    buffer: stateMachineFileBuffer,
+    worker: channel.port2,
+    artboard: 'MyArtboard',
+    stateMachines: 'StateMachine',
+    autoplay: true,
+    onstatechange: () => {
+      if (state === 0) {
+        held = r.stateMachineInputs('StateMachine');
+        state++;
+        held[2].fire();
+      } else if (state === 1) {
+        // The same objects are handed out after each event
+        expect(r.stateMachineInputs('StateMachine')).toBe(held);
+        state++;
+        held[1].value = true;
+      } else if (state === 2) {
+        expect(r.stateMachineInputs('StateMachine')).toBe(held);
+        // As reported back by the worker
+        expect(held[1].value).toBe(true);
+        r.cleanup();
+        channel.port1.close();
+        done();
+      }
+    },
+  });
+});
+
+test('Proxies keep rendering stopped when their canvas comes into view', done => {
+  // Stands in for the browser's, reporting visibility when the test says so
+  const observed = new Map<Element, (entries: any[]) => void>();
+  (global as any).IntersectionObserver = class {
+    constructor(private callback: (entries: any[]) => void) { }
+    observe(target: Element) { observed.set(target, this.callback); }
+    unobserve(target: Element) { observed.delete(target); }
+    disconnect() { }
+  };
+  const canvas = document.createElement('canvas');
+  const report = (visible: boolean) =>
+    observed.get(canvas)([{ target: canvas, isIntersecting: visible }]);
+  const startRendering = jest.spyOn(rive.Rive.prototype, 'startRendering');
+  const channel = hostWorkerChannel();
+  let starts = 0;
+  const r = new rive.RiveProxy({
+    canvas: canvas,
+    buffer: stateMachineFileBuffer,
+    worker: channel.port2,
+    onload: () => {
+      expect(r.stateMachineInputs('NoSuchStateMachine')).toEqual([]);
+      starts = startRendering.mock.calls.length;
+      r.stopRendering();
+      report(false);
+      report(true);
+      // The host runs commands in order, so has seen the above by the time
+      // it reports playing
+      r.play(r.animationNames[0]);
+    },
+    onplay: () => {
+      expect(startRendering.mock.calls.length).toBe(starts);
+      r.startRendering();
+      r.pause();
+    },
+    onpause: () => {
+      expect(startRendering.mock.calls.length).toBe(starts + 1);
+      startRendering.mockRestore();
+      delete (global as any).IntersectionObserver;
+      r.cleanup();
+      channel.port1.close();
+      done();
+    },
+  });
+});
+
+// Hosts above draw into mock canvases, so what their state machines render is
+// checked headlessly, with the runtime's software renderer
+test('State machine inputs change what renders headlessly', async () => {
+  const runtime: RiveCanvas = await rive.RuntimeLoader.awaitInstance();
+  const factory = runtime.renderFactory;
+  runtime.renderFactory = runtime.softwareRenderFactory;
+  const file = runtime.load(new Uint8Array(stateMachineFileBuffer));
+  runtime.renderFactory = factory;
+  const renderer = new runtime.SoftwareRenderer(64, 64);
+  const frame = { minX: 0, minY: 0, maxX: 64, maxY: 64 };
+  // Two instances played in step, only one of which has its trigger fired
+  const scenes = [0, 1].map(() => {
+    const artboard = file.artboardByName('MyArtboard').instance();
+    const stateMachine = new runtime.StateMachineInstance(
+      artboard.stateMachineByName('StateMachine'));
+    return { artboard, stateMachine };
+  });
+  const render = ({ artboard, stateMachine }): number[] => {
+    stateMachine.advance(0.5);
+    stateMachine.apply(artboard);
+    artboard.advance(0.5);
+    renderer.clear(0);
+    renderer.save();
+    renderer.align(runtime.Fit.contain, runtime.Alignment.center, frame,
+      artboard.bounds);
+    artboard.draw(renderer);
+    renderer.restore();
+    return Array.from(renderer.pixels());
+  };
+
+  let [played, fired] = scenes.map(render);
+  expect(played.some(value => value !== 0)).toBeTruthy();
+  expect(fired).toEqual(played);
+  // Fires MyTrig, moving to the ping pong animation from the next advance on
+  scenes[1].stateMachine.input(2).asTrigger().fire();
+  scenes.map(render);
+  [played, fired] = scenes.map(render);
+  expect(fired).not.toEqual(played);
+
+  for (const { artboard, stateMachine } of scenes) {
+    stateMachine.delete();
+    artboard.delete();
+  }
+  renderer.delete();
+  file.delete();
+});
+
+// Writes staged for one batched state machine are kept apart from another's
+test('Input writes are staged per state machine', async () => {
+  const runtime: RiveCanvas = await rive.RuntimeLoader.awaitInstance();
+  const file = runtime.load(new Uint8Array(stateMachineFileBuffer));
+  const artboard = file.artboardByName('MyArtboard').instance();
+  const batched = new runtime.BatchedArtboard(artboard);
+  const stateMachine = artboard.stateMachineByName('StateMachine');
+  const first = new runtime.StateMachineInstance(stateMachine);
+  const second = new runtime.StateMachineInstance(stateMachine);
+  const stray = new runtime.StateMachineInstance(stateMachine);
+  batched.addStateMachine(first, true);
+  batched.addStateMachine(second, true);
+
+  // Both are staged before either is applied; MyNum is input 0
+  batched.inputWrites(first, 1).set([0, 12]);
+  batched.inputWrites(second, 1).set([0, 34]);
+  expect(batched.applyInputWrites(first, 1)).toBe(1);
+  expect(batched.applyInputWrites(second, 1)).toBe(1);
+  expect(first.input(0).asNumber().value).toBe(12);
+  expect(second.input(0).asNumber().value).toBe(34);
+  // Instances outside the batch have nowhere to stage writes
+  expect(batched.inputWrites(stray, 1)).toBeNull();
+  expect(batched.applyInputWrites(stray, 1)).toBe(0);
+
+  batched.removeStateMachine(first);
+  batched.removeStateMachine(second);
+  for (const instance of [first, second, stray]) {
+    instance.delete();
+  }
+  batched.delete();
+  artboard.delete();
+  file.delete();
+});
+
+// The canvas renderer carries the paint state it set across its own saves,
+// restores and frames, until it's flushed
+test('Canvas renderer skips unchanged context state until flushed', async () => {
+  const runtime: RiveCanvas = await rive.RuntimeLoader.awaitInstance();
+  const assignments = { fillStyle: 0, globalCompositeOperation: 0 };
+  const ctx: any = { save: () => {}, restore: () => {}, fill: () => {} };
+  for (const name of Object.keys(assignments)) {
+    Object.defineProperty(ctx, name, { set: () => assignments[name]++ });
+  }
+  const renderer = new runtime.CanvasRenderer(ctx);
+  const path = runtime.canvasRenderFactory.makeRenderPath();
+  const paint = runtime.canvasRenderFactory.makeRenderPaint();
+  paint.color(0xFF336699);
+  const drawFrame = () => {
+    renderer.drawPath(path, paint);
+    renderer.save();
+    renderer.drawPath(path, paint);
+    renderer.restore();
+  };
+
+  drawFrame();
+  expect(assignments).toEqual({ fillStyle: 1, globalCompositeOperation: 1 });
+  drawFrame();
+  expect(assignments).toEqual({ fillStyle: 1, globalCompositeOperation: 1 });
+  renderer.flush();
+  drawFrame();
+  expect(assignments).toEqual({ fillStyle: 2, globalCompositeOperation: 2 });
+
+  renderer.delete();
+});
+
+// #endregion
@@ -18,6 +18,12 @@ enum PlaybackState {
  */
 export interface Bounds extends rc.AABB {}
 
+/**
+ * Interface for per-frame stats: counts of what was drawn and rebuilt, and the
+ * time spent advancing, applying and drawing in microseconds
+ */
+export interface FrameStats extends rc.FrameStats {}
+
 // #region layout
 
 // Fit options for the canvas
@@ -160,28 +166,59 @@ export class RuntimeLoader {
   private static wasmFilePath: string = 'dist/';
   // Are we in test mode?
   private static testMode: boolean = false;
+  // Whether the SIMD build may be loaded on engines supporting it. Off by
+  // default, as it only speeds up the runtime's software renderer
+  private static simdEnabled: boolean = false;
 
   // Class is never instantiated
   private constructor() { }
 
   // Loads the runtime
   private static loadRuntime(): void {
-    rc.default({
+    // The SIMD build is a module of its own, glue and wasm linked together,
+    // fetched only where it's used. Tests load the scalar build, as that's
+    // the one always present locally
+    const simd = RuntimeLoader.simdEnabled &&
+      !RuntimeLoader.testMode &&
+      RuntimeLoader.supportsSimd();
+    const loadModule: Promise<typeof rc.default> = simd ?
+      import(/* webpackChunkName: "rive.simd" */ 'rive-canvas/rive.simd.mjs')
+        .then(module => module.default) :
+      Promise.resolve(rc.default);
+    loadModule.then(Rive => Rive({
       // Loads Wasm bundle
       locateFile: (file: string) =>
         // if in test mode, attempts to load file locally 
         (RuntimeLoader.testMode ?
           RuntimeLoader.wasmFilePath :
           RuntimeLoader.wasmWebPath) + file
-    }).then((rive:  rc.RiveCanvas) => {
+    })).then((rive:  rc.RiveCanvas) => {
       RuntimeLoader.runtime = rive;
       // Fire all the callbacks
       while (RuntimeLoader.callBackQueue.length > 0) {
         RuntimeLoader.callBackQueue.shift()?.(RuntimeLoader.runtime);
       }
+    }).catch(e => {
+      if (!simd) {
+        console.error(e);
+        return;
+      }
+      // e.g. the SIMD chunk isn't hosted alongside rive.min.js
+      console.warn('Failed to load the SIMD runtime; falling back to scalar');
+      RuntimeLoader.simdEnabled = false;
+      RuntimeLoader.loadRuntime();
     });
   }
 
+  // Checks for Wasm SIMD support by validating a module with a function that
+  // uses SIMD instructions
+  private static supportsSimd(): boolean {
+    return typeof WebAssembly === 'object' && WebAssembly.validate(new Uint8Array([
+      0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10,
+      1, 8, 0, 65, 0, 253, 15, 253, 98, 11
+    ]));
+  }
+
   // Provides a runtime instance via a callback
   public static getInstance(callback: RuntimeCallback): void {
     // If it's not loading, start loading runtime
@@ -207,6 +244,310 @@ export class RuntimeLoader {
   public static setTestMode(mode: boolean): void {
     RuntimeLoader.testMode = mode;
   }
+
+  /**
+   * Sets whether the SIMD build of the runtime (rive.simd.mjs) is loaded on
+   * engines supporting Wasm SIMD; it isn't by default. The SIMD build only
+   * vectorizes the runtime's SoftwareRenderer, so enable it only when
+   * rendering through that, not the canvas renderer Rive objects use. Takes
+   * effect only before the runtime starts loading.
+   */
+  public static setSimdEnabled(enabled: boolean): void {
+    RuntimeLoader.simdEnabled = enabled;
+  }
+}
+
+// #endregion
+
+// #region files
+
+/**
+ * Reference counted handle to an imported runtime file. The file holds the
+ * immutable definitions (artboards, shapes, animations, state machines) which
+ * every artboard instance created from it shares; it's deleted from the runtime
+ * once the last reference is released.
+ */
+export class FileReference {
+  // Number of holders of this file
+  private refCount = 1;
+
+  /**
+   * @param file the imported runtime file
+   * @param onUnused called when only one reference is left, i.e. when the
+   * owner that created the reference is its last holder
+   */
+  constructor(
+    public readonly file: rc.File,
+    private onUnused?: (reference: FileReference) => void) {}
+
+  // Number of references currently held
+  public get referenceCount(): number {
+    return this.refCount;
+  }
+
+  // Takes an additional reference to the file
+  public retain(): FileReference {
+    this.refCount++;
+    return this;
+  }
+
+  // Drops a reference; the file is deleted when no references remain
+  public release(): void {
+    if (this.refCount <= 0) {
+      return;
+    }
+    this.refCount--;
+    if (this.refCount === 0) {
+      this.file.delete();
+    } else if (this.refCount === 1) {
+      this.onUnused?.(this);
+    }
+  }
+
+  // Creates an artboard instance, or returns null if there's no match
+  public instanceArtboard(name?: string): rc.Artboard | null {
+    const artboard = name ?
+      this.file.artboardByName(name) :
+      this.file.defaultArtboard();
+    return artboard ? artboard.instance() : null;
+  }
+}
+
+// A file imported into the runtime, or null if the data wasn't a valid file
+interface ImportedFile {
+  file: rc.File | null;
+  // Size of the .riv data it was imported from
+  bytes: number;
+}
+
+// Entry in the file cache
+interface FileCacheEntry {
+  key: string;
+  // Resolves to null if the file couldn't be imported
+  promise: Promise<FileReference | null>;
+  // The imported file, once available
+  reference: FileReference | null;
+  // Number of loads waiting on the promise
+  waiting: number;
+  // Size of the .riv data, used as an estimate of the imported file's size,
+  // plus that of the copy in data
+  bytes: number;
+  // Hash of the .riv data of entries loaded from buffers
+  hash: string | null;
+  // Copy of the .riv data of entries loaded from buffers, compared on hits
+  data: Uint8Array | null;
+}
+
+/**
+ * Process-wide cache of imported files, keyed by url or by the file's contents
+ * (a hash, checked against a copy of the bytes). Concurrent loads of the same
+ * key share one fetch and one import, and every Rive object showing the same
+ * file shares its definitions.
+ *
+ * The cache holds a reference to each file it imports. Files that nothing else
+ * references are evicted, least recently used first, once the cached data
+ * exceeds the memory budget. Files loaded from buffers count twice, for the
+ * copy of their bytes kept to compare with.
+ */
+export class FileCache {
+  // Entries in least to most recently used order
+  private static entries = new Map<string, FileCacheEntry>();
+  // Entries loaded from buffers, by hash; several if their contents collide
+  private static buckets = new Map<string, FileCacheEntry[]>();
+  // Tells apart the keys of entries in the same bucket
+  private static nextBucketKey = 0;
+  // Total size of the .riv data of imported entries
+  private static totalBytes = 0;
+  // Budget for cached data, in bytes of .riv data
+  private static memoryBudget = 32 * 1024 * 1024;
+
+  // Class is never instantiated
+  private constructor() { }
+
+  /**
+   * Sets the budget for the cache, in bytes of .riv data (counting the copies
+   * kept of buffers), and evicts unused files until the cache fits
+   */
+  public static setMemoryBudget(bytes: number): void {
+    FileCache.memoryBudget = bytes;
+    FileCache.evict();
+  }
+
+  // Number of cached and in-flight files
+  public static get count(): number {
+    return FileCache.entries.size;
+  }
+
+  // Size of the .riv data of the cached files
+  public static get bytes(): number {
+    return FileCache.totalBytes;
+  }
+
+  /**
+   * Provides a file loaded from a url, fetching and importing it only if it
+   * isn't already cached or loading. The returned reference must be released
+   * by the caller; resolves to null if the file couldn't be imported.
+   */
+  public static loadUrl(
+    runtime: rc.RiveCanvas,
+    src: string
+  ): Promise<FileReference | null> {
+    return FileCache.load(runtime, `url:${src}`, () => importRiveFile(runtime, src));
+  }
+
+  /**
+   * Provides a file imported from a buffer, reusing any cached file with the
+   * same contents. The returned reference must be released by the caller;
+   * resolves to null if the file couldn't be imported.
+   */
+  public static loadBuffer(
+    runtime: rc.RiveCanvas,
+    buffer: ArrayBuffer
+  ): Promise<FileReference | null> {
+    const bytes = new Uint8Array(buffer);
+    // Hashes can collide, so only an entry holding the same bytes is a hit;
+    // colliding contents get keys of their own in the same bucket
+    const hash = `buffer:${bytes.length}:${hashBytes(bytes)}`;
+    const match = FileCache.buckets.get(hash)
+      ?.find(entry => equalBytes(entry.data, bytes));
+    const key = match ? match.key : `${hash}:${FileCache.nextBucketKey++}`;
+    return FileCache.load(runtime, key, () => Promise.resolve({
+      file: runtime.load(bytes),
+      bytes: bytes.length,
+    }), hash, bytes);
+  }
+
+  // Releases every file that nothing else references
+  public static purge(): void {
+    const budget = FileCache.memoryBudget;
+    FileCache.memoryBudget = 0;
+    FileCache.evict();
+    FileCache.memoryBudget = budget;
+  }
+
+  private static load(
+    runtime: rc.RiveCanvas,
+    key: string,
+    importFile: () => Promise<ImportedFile>,
+    hash: string | null = null,
+    data: Uint8Array | null = null
+  ): Promise<FileReference | null> {
+    let entry = FileCache.entries.get(key);
+    if (entry) {
+      // Mark as most recently used
+      FileCache.entries.delete(key);
+      FileCache.entries.set(key, entry);
+    } else {
+      entry = {
+        key: key,
+        promise: null,
+        reference: null,
+        waiting: 0,
+        bytes: 0,
+        hash: hash,
+        // Copied, as the caller may reuse its buffer
+        data: data?.slice() ?? null,
+      };
+      entry.promise = FileCache.importEntry(entry, importFile);
+      FileCache.entries.set(key, entry);
+      if (hash) {
+        const bucket = FileCache.buckets.get(hash);
+        if (bucket) {
+          bucket.push(entry);
+        } else {
+          FileCache.buckets.set(hash, [entry]);
+        }
+      }
+    }
+    const loading = entry;
+    loading.waiting++;
+    const done = () => {
+      loading.waiting--;
+      FileCache.evict();
+    };
+    return loading.promise.then(reference => {
+      reference?.retain();
+      done();
+      return reference;
+    }, e => {
+      done();
+      throw e;
+    });
+  }
+
+  private static async importEntry(
+    entry: FileCacheEntry,
+    importFile: () => Promise<ImportedFile>
+  ): Promise<FileReference | null> {
+    let file: rc.File | null;
+    let bytes: number;
+    try {
+      ({ file, bytes } = await importFile());
+    } catch (e) {
+      FileCache.remove(entry);
+      throw e;
+    }
+    if (!file) {
+      // Don't cache failures so that a later load can try again
+      FileCache.remove(entry);
+      return null;
+    }
+    entry.bytes = bytes + (entry.data?.length ?? 0);
+    entry.reference = new FileReference(file, () => FileCache.evict());
+    FileCache.totalBytes += entry.bytes;
+    return entry.reference;
+  }
+
+  private static remove(entry: FileCacheEntry): void {
+    if (FileCache.entries.get(entry.key) !== entry) {
+      return;
+    }
+    FileCache.entries.delete(entry.key);
+    if (entry.hash) {
+      const bucket = FileCache.buckets.get(entry.hash);
+      bucket.splice(bucket.indexOf(entry), 1);
+      if (bucket.length === 0) {
+        FileCache.buckets.delete(entry.hash);
+      }
+    }
+  }
+
+  // Evicts unused files, least recently used first, until within budget
+  private static evict(): void {
+    for (const entry of Array.from(FileCache.entries.values())) {
+      if (FileCache.totalBytes <= FileCache.memoryBudget) {
+        return;
+      }
+      // Only the cache's own reference left and no loads about to take one
+      if (entry.reference?.referenceCount === 1 && entry.waiting === 0) {
+        FileCache.remove(entry);
+        FileCache.totalBytes -= entry.bytes;
+        entry.reference.release();
+      }
+    }
+  }
+}
+
+// Hashes bytes with 32 bit FNV-1a; used to key buffers in the file cache
+const hashBytes = (bytes: Uint8Array): string => {
+  let hash = 0x811c9dc5;
+  for (let i = 0; i < bytes.length; i++) {
+    hash = Math.imul(hash ^ bytes[i], 0x01000193);
+  }
+  return (hash >>> 0).toString(16);
+}
+
+// Whether a holds the same bytes as b
+const equalBytes = (a: Uint8Array | null, b: Uint8Array): boolean => {
+  if (!a || a.length !== b.length) {
+    return false;
+  }
+  for (let i = 0; i < a.length; i++) {
+    if (a[i] !== b[i]) {
+      return false;
+    }
+  }
+  return true;
 }
 
 // #endregion
@@ -218,23 +559,26 @@ export class RuntimeLoader {
 class Animation {
   public loopCount: number = 0;
   public readonly instance: rc.LinearAnimationInstance;
-
-  // Time to which the animation should move to on the next render
-  public scrubTo: number | null = null;
+  // Cached, as loop events are matched up with animations by name
+  public readonly name: string;
 
   /**
    * Constructs a new animation
    * @constructor
    * @param {any} animation: runtime animation object
-   * @param {any} instance: runtime animation instance object
+   * @param {any} runtime: the runtime, used to create the instance
+   * @param {boolean} playing: whether the animation starts playing
+   * @param {any} batched: the batch that advances the artboard's animations
    */
-  constructor(private animation: rc.LinearAnimation, runtime: rc.RiveCanvas, public playing: boolean) {
+  constructor(
+    private animation: rc.LinearAnimation,
+    runtime: rc.RiveCanvas,
+    private _playing: boolean,
+    private batched: rc.BatchedArtboard
+  ) {
     this.instance = new runtime.LinearAnimationInstance(animation);
-  }
-
-  // Returns the animation's name
-  public get name(): string {
-    return this.animation.name;
+    this.name = animation.name;
+    this.batched.addAnimation(this.instance, _playing);
   }
 
   // Returns the animation's current time
@@ -252,23 +596,33 @@ class Animation {
     return this.animation.loopValue;
   }
 
+  // Returns whether the animation advances when a frame is rendered
+  public get playing(): boolean {
+    return this._playing;
+  }
+
+  // Plays or pauses the animation
+  public set playing(value: boolean) {
+    this._playing = value;
+    this.batched.playAnimation(this.instance, value);
+  }
+
   /**
-   * Advances the animation by the give time. If the animation needs scrubbing,
-   * time is ignored and the stored scrub value is used.
-   * @param time the time to advance the animation by if no scrubbing required
+   * Moves the animation to the given time on the next render, instead of
+   * advancing it by the elapsed time
+   * @param time the time in seconds to move the animation to
    */
-  public advance(time: number) {
-    if (this.scrubTo === null) {
-      this.instance.advance(time);
-    } else {
-      this.instance.time = 0;
-      this.instance.advance(this.scrubTo);
-      this.scrubTo = null;
-    }
+  public scrub(time: number): void {
+    this.batched.scrubAnimation(this.instance, time);
   }
 
-  public get needsScrub(): boolean {
-    return this.scrubTo !== null;
+  /**
+   * Deletes the backing animation instance in the runtime; the animation can't
+   * be used afterwards
+   */
+  public cleanup(): void {
+    this.batched.removeAnimation(this.instance);
+    this.instance.delete();
   }
 }
 
@@ -287,7 +641,22 @@ export enum StateMachineInputType {
  */
 export class StateMachineInput {
 
-  constructor(public readonly type: StateMachineInputType, private runtimeInput: rc.SMIInput) { }
+  /**
+   * @constructor
+   * @param type the type of the input
+   * @param runtimeInput the runtime input
+   * @param onChange called when the input's value is set or it's fired
+   * @param writes if given, queues values to be written to the runtime in
+   * bulk before the state machine next advances
+   * @param index the index of the input in its state machine
+   */
+  constructor(
+    public readonly type: StateMachineInputType,
+    private runtimeInput: rc.SMIInput,
+    private onChange: VoidCallback = () => {},
+    private writes: InputWrites | null = null,
+    private index = -1
+  ) { }
 
   /**
    * Returns the name of the input
@@ -300,6 +669,13 @@ export class StateMachineInput {
    * Returns the current value of the input
    */
   public get value(): number | boolean {
+    // A value set since the last frame isn't in the runtime yet
+    if (this.writes && this.type !== StateMachineInputType.Trigger) {
+      const pending = this.writes.pending(this.index);
+      if (pending !== undefined) {
+        return this.type === StateMachineInputType.Boolean ? pending !== 0 : pending;
+      }
+    }
     return this.runtimeInput.value;
   }
 
@@ -307,7 +683,12 @@ export class StateMachineInput {
    * Sets the value of the input
    */
   public set value(value: number | boolean) {
-    this.runtimeInput.value = value;
+    if (this.writes) {
+      this.writes.write(this.index, Number(value));
+    } else {
+      this.runtimeInput.value = value;
+    }
+    this.onChange();
   }
 
   /**
@@ -315,8 +696,76 @@ export class StateMachineInput {
    */
   public fire(): void {
     if (this.type === StateMachineInputType.Trigger) {
-      this.runtimeInput.fire();
+      if (this.writes) {
+        this.writes.write(this.index, 1);
+      } else {
+        this.runtimeInput.fire();
+      }
+      this.onChange();
+    }
+  }
+}
+
+/**
+ * Input values set on a state machine since its last frame: the latest value
+ * of each number and bool input set, and each trigger fired. They're copied
+ * as (input index, value) pairs into the array the batch stages the state
+ * machine's writes in and applied in a single call right before it advances,
+ * rather than going through the runtime once per set.
+ */
+class InputWrites {
+  // Pending value by input index, undefined for none
+  private values: (number | undefined)[];
+  // Indices of the inputs with a pending value, in the order first set
+  private queued: number[] = [];
+
+  constructor(
+    private instance: rc.StateMachineInstance,
+    private batched: rc.BatchedArtboard
+  ) {
+    this.values = new Array(instance.inputCount());
+  }
+
+  /**
+   * Sets the input's pending value; for triggers, any value fires them. A
+   * trigger fired more than once before a frame fires once, as in the runtime
+   */
+  public write(index: number, value: number): void {
+    if (index < 0 || index >= this.values.length) {
+      return;
+    }
+    if (this.values[index] === undefined) {
+      this.queued.push(index);
+    }
+    this.values[index] = value;
+  }
+
+  /**
+   * Returns the value written to the input since the last flush, if any
+   */
+  public pending(index: number): number | undefined {
+    return this.values[index];
+  }
+
+  /**
+   * Applies the pending writes to the runtime instance
+   */
+  public flush(): void {
+    const count = this.queued.length;
+    if (count === 0) {
+      return;
+    }
+    const pairs = this.batched.inputWrites(this.instance, count);
+    for (let i = 0; i < count; i++) {
+      const index = this.queued[i];
+      if (pairs) {
+        pairs[i * 2] = index;
+        pairs[i * 2 + 1] = this.values[index] as number;
+      }
+      this.values[index] = undefined;
     }
+    this.batched.applyInputWrites(this.instance, count);
+    this.queued.length = 0;
   }
 }
 
@@ -332,13 +781,29 @@ class StateMachine {
    */
   public readonly instance: rc.StateMachineInstance;
 
+  /**
+   * Input values waiting for the next frame
+   */
+  public readonly inputWrites: InputWrites;
+
   /**
    * @constructor
    * @param stateMachine runtime state machine object
-   * @param instance runtime state machine instance object
+   * @param runtime the runtime, used to create the instance
+   * @param _playing whether the state machine starts playing
+   * @param batched the batch that advances the artboard's state machines
+   * @param onInputChanged called when an input is set or fired
    */
-  constructor(private stateMachine: rc.StateMachine, runtime: rc.RiveCanvas, public playing: boolean) {
+  constructor(
+    private stateMachine: rc.StateMachine,
+    runtime: rc.RiveCanvas,
+    private _playing: boolean,
+    private batched: rc.BatchedArtboard,
+    private onInputChanged: VoidCallback
+  ) {
     this.instance = new runtime.StateMachineInstance(stateMachine);
+    this.batched.addStateMachine(this.instance, _playing);
+    this.inputWrites = new InputWrites(this.instance, this.batched);
     this.initInputs(runtime);
   }
 
@@ -346,15 +811,24 @@ class StateMachine {
     return this.stateMachine.name;
   }
 
+  // Returns whether the state machine advances when a frame is rendered
+  public get playing(): boolean {
+    return this._playing;
+  }
+
+  // Plays or pauses the state machine
+  public set playing(value: boolean) {
+    this._playing = value;
+    this.batched.playStateMachine(this.instance, value);
+  }
+
   /**
-   * Returns a list of state names that have changed on this frame
+   * Deletes the backing state machine instance and its inputs in the runtime;
+   * the state machine can't be used afterwards
    */
-  public get statesChanged(): string[] {
-    const names: string[] = [];
-    for (let i = 0; i < this.instance.stateChangedCount(); i++) {
-      names.push(this.instance.stateChangedNameByIndex(i));
-    }
-    return names;
+  public cleanup(): void {
+    this.batched.removeStateMachine(this.instance);
+    this.instance.delete();
   }
 
   /**
@@ -365,23 +839,30 @@ class StateMachine {
     // Fetch the inputs from the runtime if we don't have them
     for (let i = 0; i < this.instance.inputCount(); i++) {
       const input = this.instance.input(i);
-      this.inputs.push(this.mapRuntimeInput(input, runtime));
+      this.inputs.push(this.mapRuntimeInput(input, i, runtime));
     }
   }
 
   /**
    * Maps a runtime input to it's appropriate type
    * @param input 
+   * @param index the input's index in the state machine
    */
-  private mapRuntimeInput(input: rc.SMIInput, runtime: rc.RiveCanvas): StateMachineInput {
+  private mapRuntimeInput(input: rc.SMIInput, index: number, runtime: rc.RiveCanvas): StateMachineInput {
     if (input.type === runtime.SMIInput.bool) {
-      return new StateMachineInput(StateMachineInputType.Boolean, input.asBool());
+      return new StateMachineInput(
+        StateMachineInputType.Boolean, input.asBool(), this.onInputChanged, this.inputWrites, index
+      );
     }
     else if (input.type === runtime.SMIInput.number) {
-      return new StateMachineInput(StateMachineInputType.Number, input.asNumber());
+      return new StateMachineInput(
+        StateMachineInputType.Number, input.asNumber(), this.onInputChanged, this.inputWrites, index
+      );
     }
     else if (input.type === runtime.SMIInput.trigger) {
-      return new StateMachineInput(StateMachineInputType.Trigger, input.asTrigger());
+      return new StateMachineInput(
+        StateMachineInputType.Trigger, input.asTrigger(), this.onInputChanged, this.inputWrites, index
+      );
     }
   }
 }
@@ -400,15 +881,29 @@ class Animator {
    * @constructor
    * @param runtime Rive runtime; needed to instance animations & state machines
    * @param artboard the artboard that holds all animations and state machines
+   * @param batched advances the animations and state machines on the artboard
+   * @param eventManager fires playback events
+   * @param onInputChanged called when a state machine input is set or fired
    * @param animations optional list of animations
    * @param stateMachines optional list of state machines
    */
   constructor(
     private runtime: rc.RiveCanvas,
-    private artboard: rc.Artboard,
+    public artboard: rc.Artboard,
+    private batched: rc.BatchedArtboard,
     private eventManager: EventManager,
+    private onInputChanged: VoidCallback,
     public readonly animations: Animation[] = [],
-    public readonly stateMachines: StateMachine[] = []) {}
+    public readonly stateMachines: StateMachine[] = []) {
+    this.eventsRead = batched.eventsWritten();
+  }
+
+  // Number of events read from the artboard's event ring, wrapping like the
+  // runtime's count, and the ring's view
+  private eventsRead: number;
+  private events: Uint32Array | null = null;
+  // Event names by id, as fetched from the runtime
+  private eventNames: string[] = [];
 
   /**
    * Adds animations and state machines by their names. If names are shared
@@ -442,12 +937,14 @@ class Animator {
           // Try to create a new animation instance
           const anim = this.artboard.animationByName(animatables[i]);
           if(anim) {
-            this.animations.push(new Animation(anim, this.runtime, playing));
+            this.animations.push(new Animation(anim, this.runtime, playing, this.batched));
           } else {
             // Try to create a new state machine instance
             const sm = this.artboard.stateMachineByName(animatables[i]);
             if (sm) {
-              this.stateMachines.push(new StateMachine(sm, this.runtime, playing));
+              this.stateMachines.push(
+                new StateMachine(sm, this.runtime, playing, this.batched, this.onInputChanged)
+              );
             }
           }
         }
@@ -498,7 +995,7 @@ class Animator {
      */
     public scrub(animatables: string[], value: number): string[] {
       const forScrubbing = this.animations.filter(a => animatables.includes(a.name));
-      forScrubbing.forEach(a => a.scrubTo = value);
+      forScrubbing.forEach(a => a.scrub(value));
       return forScrubbing.map(a => a.name);
     }
 
@@ -536,6 +1033,8 @@ class Animator {
       removedNames = this.animations.map(a => a.name).concat(
         this.stateMachines.map(m => m.name)
       );
+      this.animations.forEach(a => a.cleanup());
+      this.stateMachines.forEach(m => m.cleanup());
       this.animations.splice(0, this.animations.length);
       this.stateMachines.splice(0, this.stateMachines.length);
     } else {
@@ -543,15 +1042,17 @@ class Animator {
       const animationsToRemove = this.animations.filter(
         a => animatables.includes(a.name)
       );
-      animationsToRemove.forEach(a =>
-        this.animations.splice(this.animations.indexOf(a), 1)
-      );
+      animationsToRemove.forEach(a => {
+        a.cleanup();
+        this.animations.splice(this.animations.indexOf(a), 1);
+      });
       const machinesToRemove = this.stateMachines.filter(
         m => animatables.includes(m.name)
       );
-      machinesToRemove.forEach(m =>
-        this.stateMachines.splice(this.stateMachines.indexOf(m), 1)
-      );
+      machinesToRemove.forEach(m => {
+        m.cleanup();
+        this.stateMachines.splice(this.stateMachines.indexOf(m), 1);
+      });
       removedNames = animationsToRemove.map(a => a.name).concat(
         machinesToRemove.map(m => m.name));
     }
@@ -565,6 +1066,17 @@ class Animator {
     return removedNames;
   }
 
+  /**
+   * Releases all animation and state machine instances without firing stop
+   * events; used when the artboard they were made from is being deleted
+   */
+  public cleanup(): void {
+    this.animations.forEach(a => a.cleanup());
+    this.stateMachines.forEach(m => m.cleanup());
+    this.animations.splice(0, this.animations.length);
+    this.stateMachines.splice(0, this.stateMachines.length);
+  }
+
   /**
    * Returns true if at least one animation is active
    */
@@ -607,52 +1119,102 @@ class Animator {
   }
 
   /**
-   * Checks if any animations have looped and if so, fire the appropriate event
+   * Writes the input values set since the last frame into the state machines,
+   * in one runtime call per state machine; called before advancing them
    */
-  public handleLooping() {
-    for (const animation of this.animations.filter(a => a.playing)) {
-      // Emit if the animation looped
-      if (animation.loopValue === 0 && animation.loopCount) {
-        animation.loopCount = 0;
-        // This is a one-shot; if it has ended, delete the instance
-        this.stop(animation.name);
-      }
-      else if (animation.loopValue === 1 && animation.loopCount) {
-        this.eventManager.fire({
-          type: EventType.Loop,
-          data: { animation: animation.name, type: LoopType.Loop }
-        });
-        animation.loopCount = 0;
-      }
-      // Wasm indicates a loop at each time the animation
-      // changes direction, so a full loop/lap occurs every
-      // two loop counts
-      else if (animation.loopValue === 2 && animation.loopCount > 1) {
-        this.eventManager.fire({
-          type: EventType.Loop,
-          data: { animation: animation.name, type: LoopType.PingPong }
-        });
-        animation.loopCount = 0;
-      }
+  public flushInputs(): void {
+    for (const stateMachine of this.stateMachines) {
+      stateMachine.inputWrites.flush();
     }
   }
 
   /**
-   * Checks if states have changed in state machines and fires a statechange
-   * event
+   * Reads the loops and state changes written to the artboard's event ring
+   * since the last frame, firing loop and statechange events. Names are
+   * fetched from the runtime only the first time their id is seen.
    */
-  public handleStateChanges() {
-    const statesChanged: string[] = [];
-    for (const stateMachine of this.stateMachines.filter(sm => sm.playing)) {
-     statesChanged.push(...stateMachine.statesChanged);
+  public handleEvents(): void {
+    const written = this.batched.eventsWritten();
+    let read = this.eventsRead;
+    // Events more than a ring behind were overwritten
+    if ((written - read) >>> 0 > EVENT_CAPACITY) {
+      read = (written - EVENT_CAPACITY) >>> 0;
+    }
+    // The view detaches when wasm memory grows
+    if (!this.events || this.events.length === 0) {
+      this.events = this.batched.events();
+    }
+    let statesChanged: string[] | null = null;
+    for (; read !== written; read = (read + 1) >>> 0) {
+      const at = (read % EVENT_CAPACITY) * EVENT_STRIDE;
+      const name = this.eventName(this.events[at + 1]);
+      if (this.events[at] === EVENT_LOOPED) {
+        this.handleLoop(name);
+      } else {
+        if (!statesChanged) {
+          statesChanged = [];
+        }
+        statesChanged.push(name);
+      }
     }
-    if (statesChanged.length > 0) {
+    this.eventsRead = written;
+    if (statesChanged) {
       this.eventManager.fire({
         type: EventType.StateChange,
         data: statesChanged,
       });
     }
   }
+
+  // Returns the name an event id stands for
+  private eventName(id: number): string {
+    let name = this.eventNames[id];
+    if (name === undefined) {
+      name = this.eventNames[id] = this.batched.eventName(id);
+    }
+    return name;
+  }
+
+  /**
+   * Counts a loop of the named animation and, once it makes a full loop,
+   * fires the appropriate event
+   */
+  private handleLoop(name: string): void {
+    let animation: Animation | undefined;
+    for (let i = 0; i < this.animations.length; i++) {
+      if (this.animations[i].playing && this.animations[i].name === name) {
+        animation = this.animations[i];
+        break;
+      }
+    }
+    if (!animation) {
+      return;
+    }
+    animation.loopCount += 1;
+    // Emit if the animation looped
+    if (animation.loopValue === 0) {
+      animation.loopCount = 0;
+      // This is a one-shot; if it has ended, delete the instance
+      this.stop(animation.name);
+    }
+    else if (animation.loopValue === 1) {
+      this.eventManager.fire({
+        type: EventType.Loop,
+        data: { animation: animation.name, type: LoopType.Loop }
+      });
+      animation.loopCount = 0;
+    }
+    // Wasm indicates a loop at each time the animation
+    // changes direction, so a full loop/lap occurs every
+    // two loop counts
+    else if (animation.loopValue === 2 && animation.loopCount > 1) {
+      this.eventManager.fire({
+        type: EventType.Loop,
+        data: { animation: animation.name, type: LoopType.PingPong }
+      });
+      animation.loopCount = 0;
+    }
+  }
 }
 
 // #endregion
@@ -806,71 +1368,342 @@ class TaskQueueManager {
 
 // #endregion
 
-// #region Rive
-
-// Interface for the Rive static method contructor
-export interface RiveParameters {
-  canvas: HTMLCanvasElement | OffscreenCanvas, // canvas is required
-  src?: string, // one of src or buffer is required
-  buffer?: ArrayBuffer, // one of src or buffer is required
-  artboard?: string,
-  animations?: string | string[],
-  stateMachines?: string | string[],
-  layout?: Layout,
-  autoplay?: boolean,
-  onload?: EventCallback,
-  onloaderror?: EventCallback,
-  onplay?: EventCallback,
-  onpause?: EventCallback,
-  onstop?: EventCallback,
-  onloop?: EventCallback,
-  onstatechange?: EventCallback,
-}
+// #region frame scheduling
 
-// Interface to Rive.load function
-export interface RiveLoadParameters {
-  src?: string,
-  buffer?: ArrayBuffer,
-  autoplay?: boolean,
-  artboard?: string,
-  animations?: string | string[],
-  stateMachines?: string | string[],
+// Flags reported by the runtime when advancing an artboard; these must match
+// AdvanceResult in advance_batch.hpp
+enum AdvanceResult {
+  None = 0,
+  Looped = 1 << 0,
+  StateChanged = 1 << 1,
+  Changed = 1 << 2,
 }
 
-export class Rive {
-
-  // Canvas in which to render the artboard
-  private readonly canvas: HTMLCanvasElement | OffscreenCanvas;
+// Layout of EventRing in event_ring.hpp
+const EVENT_STRIDE = 2;
+const EVENT_CAPACITY = 256;
+const EVENT_LOOPED = 1;
 
-  // A url to a Rive file; may be undefined if a buffer is specified
-  private src: string;
+/**
+ * An object whose frames are driven by the scheduler
+ */
+export interface FrameTask {
+  // Called at the start of a frame; returns the seconds to advance by
+  begin(time: number): number;
+  // Called once the artboard has advanced with the AdvanceResult flags
+  end(result: number): void;
+}
 
-  // Raw Rive file data; may be undefined if a src is specified
-  private buffer: ArrayBuffer;
+// Scheduler bookkeeping for a registered task
+export interface ScheduledTask {
+  task: FrameTask;
+  canvas: HTMLCanvasElement | OffscreenCanvas;
+  batched: rc.BatchedArtboard;
+  // Index in the advance batch; -1 once unregistered
+  index: number;
+  // Whether a frame has been requested
+  pending: boolean;
+  // Whether the task is waiting in the queue
+  queued: boolean;
+  // Whether the canvas is on screen, as last reported by the observer
+  visible: boolean;
+  // Result of the last advance
+  result: number;
+}
 
-  // The layout for rendering in the canvas
-  private _layout: Layout;
+// Whether a canvas is an element of the document; false for OffscreenCanvas,
+// and in workers, where Element doesn't exist
+const isElement = (canvas: HTMLCanvasElement | OffscreenCanvas): canvas is HTMLCanvasElement =>
+  typeof Element !== 'undefined' && canvas instanceof Element;
 
-  // Flag to indicate if the layout has changed; used by the renderer to know
-  // when to align
-  private _updateLayout: boolean = true;
+// Requests an animation frame; workers without requestAnimationFrame (e.g.
+// under node) fall back to a timer at roughly 60fps
+const requestFrame = (callback: (time: number) => void): number =>
+  typeof requestAnimationFrame !== 'undefined' ?
+    requestAnimationFrame(callback) :
+    setTimeout(() => callback(performance.now()), 16) as unknown as number;
 
-  // The canvas 2D context
-  private ctx: CanvasRenderingContext2D | OffscreenCanvasRenderingContext2D | null;
+/**
+ * Drives the frames of every Rive object from a single animation frame
+ * callback. Artboards of all due objects are advanced through one call into
+ * the runtime, objects whose canvas is offscreen are skipped until it comes
+ * back into view, and when a frame's work exceeds the frame budget the
+ * remaining objects are rendered on the next frame, first in line.
+ */
+export class FrameScheduler {
+  // Advances the artboards of all scheduled objects
+  private static batch: rc.AdvanceBatch;
+  // Tasks waiting for a frame, in order
+  private static queue: ScheduledTask[] = [];
+  // Tasks rendered in the current frame; reused between frames
+  private static due: ScheduledTask[] = [];
+  // Registered tasks by canvas, for the intersection observer
+  private static byCanvas = new Map<Element, ScheduledTask>();
+  private static observer: IntersectionObserver | null = null;
+  private static frameRequestId: number | null = null;
+  // Time budget per frame, in milliseconds
+  private static frameBudget = 8;
+  // Running average of the time taken per task, in milliseconds
+  private static taskCost = 0;
 
-  // The runtime renderer
-  private renderer: rc.Renderer;
+  // Class is never instantiated
+  private constructor() { }
 
   /**
-   * Flag to active/deactivate renderer
+   * Sets the time in milliseconds that the scheduler may spend per frame
+   * before deferring the remaining objects to the next frame
    */
-  private isRendererActive = true;
-
-  // Tracks if a Rive file is loaded
-  private loaded: boolean = false;
+  public static setFrameBudget(milliseconds: number): void {
+    FrameScheduler.frameBudget = milliseconds;
+  }
 
   /**
-   * Tracks if a Rive file is loaded; we need this in addition to loaded as some
+   * Registers an object to be scheduled
+   * @param runtime the runtime that advances the artboard
+   * @param canvas the canvas the object renders to
+   * @param batched the artboard and its animations and state machines
+   * @param task callbacks for each frame
+   */
+  public static register(
+    runtime: rc.RiveCanvas,
+    canvas: HTMLCanvasElement | OffscreenCanvas,
+    batched: rc.BatchedArtboard,
+    task: FrameTask
+  ): ScheduledTask {
+    if (!FrameScheduler.batch) {
+      FrameScheduler.batch = new runtime.AdvanceBatch();
+    }
+    const scheduled: ScheduledTask = {
+      task: task,
+      canvas: canvas,
+      batched: batched,
+      index: FrameScheduler.batch.add(batched),
+      pending: false,
+      queued: false,
+      visible: true,
+      result: AdvanceResult.None,
+    };
+    // Offscreen canvases aren't in the document, so they're never observed
+    // and always count as visible
+    if (isElement(canvas)) {
+      FrameScheduler.byCanvas.set(canvas, scheduled);
+      FrameScheduler.observe(canvas);
+    }
+    return scheduled;
+  }
+
+  // Stops scheduling a registered object
+  public static unregister(scheduled: ScheduledTask): void {
+    if (scheduled.index < 0) {
+      return;
+    }
+    FrameScheduler.cancel(scheduled);
+    FrameScheduler.batch.remove(scheduled.index);
+    scheduled.index = -1;
+    const canvas = scheduled.canvas;
+    if (isElement(canvas) && FrameScheduler.byCanvas.get(canvas) === scheduled) {
+      FrameScheduler.byCanvas.delete(canvas);
+      FrameScheduler.observer?.unobserve(canvas);
+    }
+  }
+
+  // Requests a frame for a registered object
+  public static request(scheduled: ScheduledTask): void {
+    if (scheduled.index < 0) {
+      return;
+    }
+    scheduled.pending = true;
+    FrameScheduler.enqueue(scheduled);
+  }
+
+  // Withdraws a requested frame
+  public static cancel(scheduled: ScheduledTask): void {
+    scheduled.pending = false;
+    if (scheduled.queued) {
+      scheduled.queued = false;
+      FrameScheduler.queue.splice(FrameScheduler.queue.indexOf(scheduled), 1);
+    }
+  }
+
+  // Returns true if a frame has been requested and not yet rendered
+  public static isPending(scheduled: ScheduledTask): boolean {
+    return scheduled.pending;
+  }
+
+  private static enqueue(scheduled: ScheduledTask): void {
+    if (!scheduled.visible || scheduled.queued) {
+      return;
+    }
+    scheduled.queued = true;
+    FrameScheduler.queue.push(scheduled);
+    if (FrameScheduler.frameRequestId === null) {
+      FrameScheduler.frameRequestId = requestFrame(FrameScheduler.tick);
+    }
+  }
+
+  // Watches the canvas so that the object can be skipped while it's offscreen
+  private static observe(canvas: Element): void {
+    if (typeof IntersectionObserver === 'undefined') {
+      return;
+    }
+    if (!FrameScheduler.observer) {
+      FrameScheduler.observer = new IntersectionObserver(entries => {
+        for (const entry of entries) {
+          const scheduled = FrameScheduler.byCanvas.get(entry.target);
+          if (!scheduled) {
+            continue;
+          }
+          scheduled.visible = entry.isIntersecting;
+          if (!scheduled.visible && scheduled.queued) {
+            // Stays pending, and is queued again once visible
+            scheduled.queued = false;
+            FrameScheduler.queue.splice(FrameScheduler.queue.indexOf(scheduled), 1);
+          } else if (scheduled.visible && scheduled.pending) {
+            FrameScheduler.enqueue(scheduled);
+          }
+        }
+      });
+    }
+    FrameScheduler.observer.observe(canvas);
+  }
+
+  // Renders a frame for as many queued objects as the budget allows
+  private static tick(time: number): void {
+    FrameScheduler.frameRequestId = null;
+    const start = performance.now();
+    const queue = FrameScheduler.queue;
+    const due = FrameScheduler.due;
+
+    let count = queue.length;
+    if (FrameScheduler.taskCost > 0) {
+      const affordable = Math.floor(FrameScheduler.frameBudget / FrameScheduler.taskCost);
+      count = Math.min(count, Math.max(1, affordable));
+    }
+    due.length = 0;
+    for (let i = 0; i < count; i++) {
+      const scheduled = queue[i];
+      scheduled.queued = false;
+      scheduled.pending = false;
+      due.push(scheduled);
+    }
+    queue.splice(0, count);
+
+    // Advance every due artboard in one call
+    const elapsed = FrameScheduler.batch.elapsed();
+    for (const scheduled of due) {
+      elapsed[scheduled.index] = scheduled.task.begin(time);
+    }
+    FrameScheduler.batch.advance();
+    // Read all results before rendering, as rendering may add artboards to the
+    // batch and invalidate the view
+    const results = FrameScheduler.batch.results();
+    for (const scheduled of due) {
+      scheduled.result = results[scheduled.index];
+    }
+    for (const scheduled of due) {
+      // Rendering an earlier task may have unregistered this one
+      if (scheduled.index >= 0) {
+        scheduled.task.end(scheduled.result);
+      }
+    }
+
+    if (due.length > 0) {
+      const cost = (performance.now() - start) / due.length;
+      FrameScheduler.taskCost = FrameScheduler.taskCost > 0 ?
+        FrameScheduler.taskCost * 0.9 + cost * 0.1 :
+        cost;
+    }
+    due.length = 0;
+    if (queue.length > 0 && FrameScheduler.frameRequestId === null) {
+      FrameScheduler.frameRequestId = requestFrame(FrameScheduler.tick);
+    }
+  }
+}
+
+// #endregion
+
+// #region Rive
+
+// Interface for the Rive static method contructor
+export interface RiveParameters {
+  canvas: HTMLCanvasElement | OffscreenCanvas, // canvas is required
+  src?: string, // one of src or buffer is required
+  buffer?: ArrayBuffer, // one of src or buffer is required
+  artboard?: string,
+  animations?: string | string[],
+  stateMachines?: string | string[],
+  layout?: Layout,
+  autoplay?: boolean,
+  onload?: EventCallback,
+  onloaderror?: EventCallback,
+  onplay?: EventCallback,
+  onpause?: EventCallback,
+  onstop?: EventCallback,
+  onloop?: EventCallback,
+  onstatechange?: EventCallback,
+}
+
+// Interface to Rive.load function
+export interface RiveLoadParameters {
+  src?: string,
+  buffer?: ArrayBuffer,
+  autoplay?: boolean,
+  artboard?: string,
+  animations?: string | string[],
+  stateMachines?: string | string[],
+}
+
+export class Rive {
+
+  // Canvas in which to render the artboard
+  private readonly canvas: HTMLCanvasElement | OffscreenCanvas;
+
+  // A url to a Rive file; may be undefined if a buffer is specified
+  private src: string;
+
+  // Raw Rive file data; may be undefined if a src is specified
+  private buffer: ArrayBuffer;
+
+  // The layout for rendering in the canvas
+  private _layout: Layout;
+
+  // Flag to indicate if the layout has changed; used by the renderer to know
+  // when to align
+  private _updateLayout: boolean = true;
+
+  // The canvas 2D context
+  private ctx: CanvasRenderingContext2D | OffscreenCanvasRenderingContext2D | null;
+
+  // The runtime renderer
+  private renderer: rc.Renderer;
+
+  // Works out which parts of the canvas need redrawing each frame
+  private damageTracker: rc.DamageTracker | null = null;
+
+  // Finds the shape at a point of the canvas; only updated when hit testing
+  // after a frame was drawn
+  private hitTester: rc.HitTester | null = null;
+  private hitTesterStale = true;
+
+  // Whether per-frame stats are collected, and the recorder collecting them;
+  // frames are drawn through the recorder while it exists
+  private collectStats = false;
+  private statsRecorder: rc.StatsRecorder | null = null;
+
+  // The canvas transform the layout is applied on top of; damage is reported
+  // relative to it
+  private baseTransform: DOMMatrix;
+
+  /**
+   * Flag to active/deactivate renderer
+   */
+  private isRendererActive = true;
+
+  // Tracks if a Rive file is loaded
+  private loaded: boolean = false;
+
+  /**
+   * Tracks if a Rive file is loaded; we need this in addition to loaded as some
    * commands (e.g. contents) can be called as soon as the file is loaded.
    * However, playback commands need to be queued and run in order once initial
    * animations and autoplay has been sorted out. This applies to play, pause,
@@ -881,11 +1714,17 @@ export class Rive {
   // Wasm runtime
   private runtime: rc.RiveCanvas;
 
-  // Runtime artboard
+  // Runtime artboard; an instance owned by this Rive object
   private artboard: rc.Artboard | null = null;
 
-  // Runtime file
-  private file: rc.File;
+  // Name of the artboard instanced from the file
+  private artboardName: string;
+
+  // Runtime file, shared with any other artboard instances made from it
+  private file: FileReference | null = null;
+
+  // Incremented for each load, so that superseded loads can be discarded
+  private loadCount = 0;
 
   // Holds event listeners
   private eventManager: EventManager;
@@ -897,7 +1736,7 @@ export class Rive {
   private animator: Animator;
 
   // Error message for missing source or buffer
-  private static readonly missingErrorMessage: string =
+  public static readonly missingErrorMessage: string =
     'Rive source file or data buffer required';
 
   constructor(params: RiveParameters) {
@@ -958,12 +1797,13 @@ export class Rive {
     // Ensure loaded is marked as false if loading new file
     this.loaded = false;
     this.readyForPlaying = false;
+    const loadId = ++this.loadCount;
 
     // Ensure the runtime is loaded
     RuntimeLoader.awaitInstance().then((runtime) => {
       this.runtime = runtime;
       // Load Rive data from a source uri or a data buffer
-      this.initData(artboard, startingAnimationNames, startingStateMachineNames, autoplay).catch(e => {
+      this.initData(artboard, startingAnimationNames, startingStateMachineNames, autoplay, loadId).catch(e => {
         console.error(e);
       });
     }).catch(e => {
@@ -976,15 +1816,21 @@ export class Rive {
     artboardName: string,
     animationNames: string[],
     stateMachineNames: string[],
-    autoplay: boolean
+    autoplay: boolean,
+    loadId: number
   ): Promise<void> {
-    // Load the buffer from the src if provided
-    if (this.src) {
-      this.buffer = await loadRiveFile(this.src);
+    // Load the Rive file from the src or the buffer; files already loaded or
+    // loading for another Rive object are shared
+    const file = this.src ?
+      await FileCache.loadUrl(this.runtime, this.src) :
+      await FileCache.loadBuffer(this.runtime, this.buffer);
+    // A newer load may have started while this one was in flight
+    if (loadId !== this.loadCount) {
+      file?.release();
+      return Promise.resolve();
     }
-    // Load the Rive file
-    this.file = await this.runtime.load(new Uint8Array(this.buffer));
-    if (this.file) {
+    if (file) {
+      this.file = file;
       // Initialize and draw frame
       this.initArtboard(artboardName, animationNames, stateMachineNames, autoplay);
 
@@ -1018,9 +1864,10 @@ export class Rive {
     stateMachineNames: string[],
     autoplay: boolean
   ): void {
-    this.artboard = artboardName ?
-      this.file.artboardByName(artboardName) :
-      this.file.defaultArtboard();
+    // Instance the artboard so that its mutable state is our own, while the
+    // imported definitions stay shared with the file
+    this.artboardName = artboardName;
+    this.artboard = this.file.instanceArtboard(artboardName);
 
     if (!this.artboard) {
       const msg = 'Invalid artboard name or no default artboard';
@@ -1036,11 +1883,27 @@ export class Rive {
       throw msg;
     }
 
-    // Initialize the animator
-    this.animator = new Animator(this.runtime, this.artboard, this.eventManager);
+    // Initialize the animator, and have the artboard's frames scheduled with
+    // those of all other Rive objects
+    this.batched = new this.runtime.BatchedArtboard(this.artboard);
+    this.animator = new Animator(
+      this.runtime,
+      this.artboard,
+      this.batched,
+      this.eventManager,
+      // Wakes up rendering if the scene had settled
+      () => this.wakeRendering()
+    );
+    this.scheduledTask = FrameScheduler.register(this.runtime, this.canvas, this.batched, {
+      begin: (time: number) => this.beginFrame(time),
+      end: (result: number) => this.endFrame(result),
+    });
 
     // Get the canvas where you want to render the animation and create a renderer
     this.renderer = new this.runtime.CanvasRenderer(this.ctx);
+    this.damageTracker = new this.runtime.DamageTracker();
+    this.hitTester = new this.runtime.HitTester();
+    this.attachStats();
 
 
     // Initialize the animations; as loaded hasn't happened yet, we need to
@@ -1064,102 +1927,218 @@ export class Rive {
     });
   }
 
-  // Draws the current artboard frame
+  // Draws the current artboard frame, even if rendering was stopped
   public drawFrame() {
-    this.startRendering();
+    if (this.loaded && this.scheduledTask) {
+      FrameScheduler.request(this.scheduledTask);
+    }
   }
 
   // Tracks the last timestamp at which the animation was rendered. Used only in
-  // draw().
+  // beginFrame().
   private lastRenderTime: number;
 
-  // Tracks the current animation frame request
-  private frameRequestId: number | null;
+  // Schedules this object's frames along with all other Rive objects'
+  private scheduledTask: ScheduledTask | null = null;
 
-  /**
-   * Used be draw to track when a second of active rendering time has passed. Used for debugging purposes
-   */
-  private renderSecondTimer: number = 0;
+  // Whether stopRendering() was called and startRendering() hasn't been
+  // since; playback and inputs then don't wake rendering up
+  private renderingStopped = false;
+
+  // Advances the artboard's animations and state machines
+  private batched: rc.BatchedArtboard | null = null;
 
   /**
-   * Draw rendering loop; renders animation frames at the correct time interval.
+   * Starts a frame; the scheduler then advances the artboard by the returned
+   * number of seconds along with those of all other due Rive objects.
    * @param time the time at which to render a frame
    */
-  private draw(time: number, onSecond?: VoidCallback): void {
-    // Clear the frameRequestId, as we're now rendering a fresh frame
-    this.frameRequestId = null;
-
+  private beginFrame(time: number): number {
     // On the first pass, make sure lastTime has a valid value
     if (!this.lastRenderTime) {
       this.lastRenderTime = time;
     }
 
-    // Handle the onSecond callback
-    this.renderSecondTimer += (time - this.lastRenderTime);
-    if (this.renderSecondTimer > 5000) {
-      this.renderSecondTimer = 0;
-      onSecond?.();
-    }
-
     // Calculate the elapsed time between frames in seconds
     const elapsedTime = (time - this.lastRenderTime) / 1000;
     this.lastRenderTime = time;
 
-    // Advance non-paused animations by the elapsed number of seconds
-    // Also advance any animations that require scrubbing
-    const activeAnimations = this.animator.animations.filter(a => a.playing || a.needsScrub)
-      // The scrubbed animations must be applied first to prevent weird artifacts
-      // if the playing animations conflict with the scrubbed animating attribuates.
-      .sort((first, second) => first.needsScrub ? -1 : 1);
-    for (const animation of activeAnimations) {
-      animation.advance(elapsedTime);
-      if (animation.instance.didLoop) {
-        animation.loopCount += 1;
-      }
-      animation.instance.apply(this.artboard, 1.0);
-    }
-
-    // Advance non-paused state machines by the elapsed number of seconds
-    const activeStateMachines = this.animator.stateMachines.filter(a => a.playing);
-    for (const stateMachine of activeStateMachines) {
-      stateMachine.instance.advance(elapsedTime);
-      stateMachine.instance.apply(this.artboard);
-    }
+    // Inputs set since the last frame take effect on this advance
+    this.animator.flushInputs();
+    return elapsedTime;
+  }
 
-    // Once the animations have been applied to the artboard, advance it
-    // by the elapsed time.
-    this.artboard.advance(elapsedTime);
+  /**
+   * Renders a frame once the artboard has been advanced
+   * @param result flags reported by the runtime when advancing
+   */
+  private endFrame(result: number): void {
+    this.statsRecorder?.beginDraw();
 
     // Update the renderer alignment if necessary
     this.alignRenderer();
 
-    const bounds = this.artboard.bounds;
-    this.ctx.clearRect(bounds.minX, bounds.minY, bounds.maxX, bounds.maxY);
-    this.artboard.draw(this.renderer);
-
-    // Check for any animations that looped
-    this.animator.handleLooping();
-
-    // Check for any state machines that had a state change
-    this.animator.handleStateChanges();
+    // Only clear and redraw the parts of the canvas that changed
+    const damageCount = this.artboard.damage(this.damageTracker);
+    if (this.damageTracker.isFull()) {
+      const bounds = this.artboard.bounds;
+      this.ctx.clearRect(bounds.minX, bounds.minY, bounds.maxX, bounds.maxY);
+      this.artboard.draw(this.statsRecorder ?? this.renderer);
+    } else if (damageCount > 0) {
+      this.redrawDamage();
+    }
+    // Anything may draw on the context before the next frame
+    this.renderer.flush();
+    this.hitTesterStale = true;
+    this.statsRecorder?.endFrame();
+
+    // Fire events for any animations that looped and state machines that
+    // changed state
+    if (result & (AdvanceResult.Looped | AdvanceResult.StateChanged)) {
+      this.animator.handleEvents();
+    }
 
-    // Calling requestAnimationFrame will rerun draw() at the correct rate:
-    // https://developer.mozilla.org/en-US/docs/Web/API/Canvas_API/Tutorial/Basic_animations
-    if (this.animator.isPlaying) {
+    // Request the next frame from the scheduler while anything's playing,
+    // unless the scene has settled; in which case rendering sleeps until an
+    // input, playback or the layout changes
+    if (this.animator.isPlaying && (result & AdvanceResult.Changed)) {
       // Request a new rendering frame
-      this.startRendering();
+      this.wakeRendering();
+    } else if (this.animator.isPlaying) {
+      // Reset the end time so that waking up doesn't jump ahead
+      this.lastRenderTime = 0;
     } else if (this.animator.isPaused) {
       // Reset the end time so on playback it starts at the correct frame
       this.lastRenderTime = 0;
     } else if (this.animator.isStopped) {
-      // Reset animation instances, artboard and time
-      // TODO: implement this properly when we have instancing
-      // this.initArtboard();
-      // this.drawFrame();
+      // Reset the artboard and time; the stopped animation instances have
+      // already been released by the animator
+      this.resetArtboard();
       this.lastRenderTime = 0;
     }
   }
 
+  /**
+   * Clears the damaged rectangles reported by the damage tracker and redraws
+   * the artboard clipped to them
+   */
+  private redrawDamage(): void {
+    const ctx = this.ctx;
+    const rects = this.damageTracker.rects();
+    ctx.save();
+    // Damage is relative to the transform the layout was applied on
+    const transform = ctx.getTransform();
+    ctx.setTransform(this.baseTransform);
+    ctx.beginPath();
+    for (let i = 0; i < rects.length; i += 4) {
+      const x = rects[i];
+      const y = rects[i + 1];
+      const width = rects[i + 2] - x;
+      const height = rects[i + 3] - y;
+      ctx.clearRect(x, y, width, height);
+      ctx.rect(x, y, width, height);
+    }
+    ctx.clip();
+    ctx.setTransform(transform);
+    this.artboard.draw(this.statsRecorder ?? this.renderer);
+    ctx.restore();
+  }
+
+  /**
+   * Swaps the artboard for a fresh instance in its setup pose, so that
+   * anything played afterwards starts from scratch. The canvas is left showing
+   * the last frame until something is drawn.
+   */
+  private resetArtboard(): void {
+    // A load may have replaced the file while this frame was being drawn
+    if (!this.loaded || !this.file || !this.animator.isStopped) {
+      return;
+    }
+    const artboard = this.file.instanceArtboard(this.artboardName);
+    if (!artboard) {
+      return;
+    }
+    this.artboard.delete();
+    this.artboard = artboard;
+    this.animator.artboard = artboard;
+    this.batched.setArtboard(artboard);
+  }
+
+  /**
+   * Releases the runtime resources owned by this Rive object: the animation
+   * and state machine instances, the artboard instance, and its reference to
+   * the file. Call this when the Rive object is no longer needed, e.g. when
+   * its canvas is removed from the page.
+   */
+  public cleanup(): void {
+    // Discard any load still in flight
+    this.loadCount++;
+    if (this.scheduledTask) {
+      FrameScheduler.unregister(this.scheduledTask);
+      this.scheduledTask = null;
+    }
+    this.animator?.cleanup();
+    this.detachStats();
+    this.batched?.delete();
+    this.batched = null;
+    this.loaded = false;
+    this.readyForPlaying = false;
+    this.renderer?.delete();
+    this.damageTracker?.delete();
+    this.damageTracker = null;
+    this.hitTester?.delete();
+    this.hitTester = null;
+    this.renderer = null;
+    this.artboard?.delete();
+    this.artboard = null;
+    this.file?.release();
+    this.file = null;
+  }
+
+  /**
+   * Starts collecting stats for each frame, available from frameStats. Nothing
+   * is measured unless stats are enabled, so they can be sampled from a
+   * fraction of sessions. Stats stay enabled across loads.
+   */
+  public enableFrameStats(): void {
+    this.collectStats = true;
+    this.attachStats();
+  }
+
+  /**
+   * Stops collecting frame stats
+   */
+  public disableFrameStats(): void {
+    this.collectStats = false;
+    this.detachStats();
+  }
+
+  /**
+   * Stats of the last rendered frame; null unless frame stats are enabled
+   */
+  public get frameStats(): FrameStats | null {
+    return this.statsRecorder?.last() ?? null;
+  }
+
+  /**
+   * Creates the stats recorder if stats are wanted and there's an artboard to
+   * record
+   */
+  private attachStats(): void {
+    if (!this.collectStats || this.statsRecorder || !this.renderer || !this.batched) {
+      return;
+    }
+    this.statsRecorder = new this.runtime.StatsRecorder();
+    this.statsRecorder.setRenderer(this.renderer);
+    this.batched.setStats(this.statsRecorder);
+  }
+
+  private detachStats(): void {
+    this.batched?.setStats(null);
+    this.statsRecorder?.delete();
+    this.statsRecorder = null;
+  }
+
   /**
    * Align the renderer
    */
@@ -1172,18 +2151,21 @@ export class Rive {
       this.ctx.clearRect(0, 0, this.canvas.width, this.canvas.height);
       // Now save so that future changes to align can restore
       this.ctx.save();
+      this.baseTransform = this.ctx.getTransform();
       // Align things up safe in the knowledge we can restore if changed
-      this.renderer.align(
-        this._layout.runtimeFit(this.runtime),
-        this._layout.runtimeAlignment(this.runtime),
-        {
-          minX: this._layout.minX,
-          minY: this._layout.minY,
-          maxX: this._layout.maxX,
-          maxY: this._layout.maxY
-        },
-        this.artboard.bounds
-      );
+      const fit = this._layout.runtimeFit(this.runtime);
+      const alignment = this._layout.runtimeAlignment(this.runtime);
+      const frame = {
+        minX: this._layout.minX,
+        minY: this._layout.minY,
+        maxX: this._layout.maxX,
+        maxY: this._layout.maxY
+      };
+      this.renderer.align(fit, alignment, frame, this.artboard.bounds);
+      // The damage tracker follows the same layout; this also has it report
+      // the whole canvas as damaged, as it's just been wiped
+      this.damageTracker.align(fit, alignment, frame, this.artboard.bounds);
+      this.hitTester.align(fit, alignment, frame, this.artboard.bounds);
       this._updateLayout = false;
     }
   }
@@ -1200,7 +2182,7 @@ export class Rive {
       return;
     }
     this.animator.play(animationNames);
-    this.startRendering();
+    this.wakeRendering();
   }
 
   // Pauses specified animations; if none specified, pauses all.
@@ -1251,6 +2233,8 @@ export class Rive {
   public load(params: RiveLoadParameters): void {
     // Stop all animations
     this.stop();
+    // Release the current artboard and file before loading the new one
+    this.cleanup();
     // Update the layout to account for new renderer
     this._updateLayout = true;
     // Reinitialize
@@ -1265,7 +2249,8 @@ export class Rive {
     if (!layout.maxX || !layout.maxY) {
       this.resizeToCanvas();
     }
-    if (this.loaded && !this.animator.isPlaying) {
+    // Redraw; this also wakes up rendering if the scene had settled
+    if (this.loaded) {
       this.drawFrame();
     }
   }
@@ -1418,6 +2403,26 @@ export class Rive {
     return this.artboard ? this.artboard.bounds : undefined;
   }
 
+  /**
+   * Finds the topmost shape drawn at a point of the canvas, testing its actual
+   * geometry (fill rule, stroke and clips included) as of the last frame.
+   * @param x horizontal position in canvas pixels
+   * @param y vertical position in canvas pixels
+   * @returns the name of the shape hit, or null if there's none or nothing's
+   * been drawn yet.
+   */
+  public hitTest(x: number, y: number): string | null {
+    if (!this.loaded || !this.hitTester) {
+      return null;
+    }
+    if (this.hitTesterStale) {
+      this.artboard.updateHitTester(this.hitTester);
+      this.hitTesterStale = false;
+    }
+    const index = this.artboard.hitTest(this.hitTester, x, y);
+    return index < 0 ? null : this.artboard.objectName(index);
+  }
+
   /**
    * Subscribe to Rive-generated events
    * @param type the type of event to subscribe to
@@ -1461,9 +2466,9 @@ export class Rive {
    * they would have been at if rendering had not been stopped.
    */
   public stopRendering() {
-    if (this.loaded && this.frameRequestId) {
-      cancelAnimationFrame(this.frameRequestId);
-      this.frameRequestId = null;
+    this.renderingStopped = true;
+    if (this.loaded && this.scheduledTask) {
+      FrameScheduler.cancel(this.scheduledTask);
     }
   }
 
@@ -1472,8 +2477,14 @@ export class Rive {
    * renderer is already active, then this will have zero effect.
    */
   public startRendering() {
-    if (this.loaded && !this.frameRequestId) {
-      this.frameRequestId = requestAnimationFrame(this.draw.bind(this));
+    this.renderingStopped = false;
+    this.wakeRendering();
+  }
+
+  // Requests a frame unless rendering was stopped
+  private wakeRendering() {
+    if (this.loaded && this.scheduledTask && !this.renderingStopped) {
+      FrameScheduler.request(this.scheduledTask);
     }
   }
 
@@ -1487,8 +2498,9 @@ export class Rive {
     const riveContents: RiveFileContents = {
       artboards: [],
     };
-    for (let i = 0; i < this.file.artboardCount(); i++) {
-      const artboard = this.file.artboardByIndex(i);
+    const file = this.file.file;
+    for (let i = 0; i < file.artboardCount(); i++) {
+      const artboard = file.artboardByIndex(i);
       const artboardContents: ArtboardContents = {
         name: artboard.name,
         animations: [],
@@ -1507,6 +2519,7 @@ export class Rive {
           const input = instance.input(l);
           inputContents.push({name: input.name, type: input.type});
         }
+        instance.delete();
         artboardContents.stateMachines.push({name: name, inputs: inputContents});
       }
       riveContents.artboards.push(artboardContents);
@@ -1549,14 +2562,654 @@ interface RiveFileContents {
 }
 
 
-// Loads Rive data from a URI via fetch.
-const loadRiveFile = async (src: string): Promise<ArrayBuffer> => {
+// Loads Rive data from a URI via fetch and imports it. The response's body is
+// streamed straight into the runtime's memory as it downloads rather than
+// being buffered in JS first. Content-Length sizes the runtime's buffer up
+// front, unless the body is encoded: then it's the compressed size, and the
+// buffer grows as the decoded data arrives instead.
+const importRiveFile = async (
+  runtime: rc.RiveCanvas,
+  src: string
+): Promise<ImportedFile> => {
   const req = new Request(src);
   const res = await fetch(req);
+  if (res.body) {
+    const encoding = res.headers.get('Content-Encoding');
+    const length = encoding && encoding !== 'identity' ? 0 :
+      Number(res.headers.get('Content-Length')) || 0;
+    let bytes = 0;
+    const file = await runtime.loadStream(res.body, length,
+      (written: number) => { bytes = written; });
+    return { file, bytes };
+  }
   const buffer = await res.arrayBuffer();
-  return buffer;
+  return {
+    file: runtime.load(new Uint8Array(buffer)),
+    bytes: buffer.byteLength,
+  };
+}
+
+// #endregion
+
+// #region worker
+
+/**
+ * Either end of a channel to a worker: a Worker, the worker's global scope or
+ * a MessagePort in the browser, or a worker_threads Worker, parentPort or
+ * MessagePort under node
+ */
+export interface WorkerPort {
+  postMessage(message: any, transfer?: Transferable[]): void;
 }
 
+// Listens to messages on a port, whichever of the browser's or node's APIs it
+// provides
+const listenToPort = (port: WorkerPort, callback: (data: any) => void): void => {
+  const target = port as any;
+  if (typeof target.on === 'function') {
+    target.on('message', callback);
+  } else {
+    target.addEventListener('message', (event: MessageEvent) => callback(event.data));
+    target.start?.();
+  }
+}
+
+// A call made on a RiveProxy, to be made on its Rive object in the worker
+interface WorkerCommand {
+  id: number;
+  op: string;
+  args?: any[];
+}
+
+// Playback state of a Rive object in the worker, mirrored by its proxy
+interface WorkerState {
+  loaded: boolean;
+  bounds?: Bounds;
+  animationNames: string[];
+  stateMachineNames: string[];
+  playingAnimationNames: string[];
+  pausedAnimationNames: string[];
+  playingStateMachineNames: string[];
+  pausedStateMachineNames: string[];
+  isPlaying: boolean;
+  isPaused: boolean;
+  isStopped: boolean;
+  // Inputs of the instanced state machines, by state machine name
+  inputs: { [stateMachine: string]: StateMachineInputContents[] };
+}
+
+// An event fired by a Rive object in the worker, with its state at the time
+interface WorkerEvent {
+  id: number;
+  event: Event;
+  state: WorkerState;
+  // Sent along with load events only, as reading it instances state machines
+  contents?: RiveFileContents;
+}
+
+// Messages are sent with either of these; each carries everything queued on
+// the port since the last one
+interface WorkerCommandMessage {
+  commands: WorkerCommand[];
+}
+interface WorkerEventMessage {
+  events: WorkerEvent[];
+}
+
+/**
+ * Parameters for the Rive objects of a worker host
+ */
+export interface WorkerHostOptions {
+  // Makes a canvas for proxies whose canvas couldn't be transferred; canvas
+  // elements can't be transferred under node, so tests can render into a
+  // mock or headless canvas instead
+  createCanvas?: (width: number, height: number) => HTMLCanvasElement | OffscreenCanvas;
+}
+
+/**
+ * Runs the Rive objects of RiveProxy objects on the other end of a port; call
+ * RiveWorkerHost.listen(self) in the worker's script. Files are shared between
+ * all the objects the worker hosts, as are frames.
+ */
+export class RiveWorkerHost {
+  private objects = new Map<number, Rive>();
+  // Canvases by object id; the object renders into it
+  private canvases = new Map<number, HTMLCanvasElement | OffscreenCanvas>();
+  private queue: WorkerEvent[] = [];
+  private flushScheduled = false;
+
+  private constructor(private port: WorkerPort, private options: WorkerHostOptions) {
+    listenToPort(port, (data: WorkerCommandMessage) => {
+      for (const command of data.commands) {
+        this.run(command);
+      }
+    });
+  }
+
+  /**
+   * Starts hosting the Rive objects of proxies sending commands to the port
+   */
+  public static listen(port: WorkerPort, options: WorkerHostOptions = {}): RiveWorkerHost {
+    return new RiveWorkerHost(port, options);
+  }
+
+  private run({ id, op, args = [] }: WorkerCommand): void {
+    if (op === 'create') {
+      this.create(id, args[0], args[1], args[2], args[3]);
+      return;
+    }
+    const r = this.objects.get(id);
+    if (!r) {
+      return;
+    }
+    switch (op) {
+      case 'play': r.play(args[0]); break;
+      case 'pause': r.pause(args[0]); break;
+      case 'stop': r.stop(args[0]); break;
+      case 'scrub': r.scrub(args[0], args[1]); break;
+      case 'load': r.load(args[0]); break;
+      case 'layout': r.layout = new Layout(args[0]); break;
+      case 'resizeToCanvas': r.resizeToCanvas(); break;
+      case 'resize': {
+        const canvas = this.canvases.get(id);
+        canvas.width = args[0];
+        canvas.height = args[1];
+        r.resizeToCanvas();
+        r.drawFrame();
+        break;
+      }
+      case 'startRendering': r.startRendering(); break;
+      case 'stopRendering': r.stopRendering(); break;
+      case 'input': {
+        const input = r.stateMachineInputs(args[0])?.find(i => i.name === args[1]);
+        if (input) {
+          input.value = args[2];
+        }
+        break;
+      }
+      case 'fire':
+        r.stateMachineInputs(args[0])?.find(i => i.name === args[1])?.fire();
+        break;
+      case 'cleanup':
+        r.cleanup();
+        this.objects.delete(id);
+        this.canvases.delete(id);
+        break;
+    }
+  }
+
+  private create(
+    id: number,
+    params: RiveLoadParameters & { layout?: LayoutParameters },
+    canvas: OffscreenCanvas | undefined,
+    width: number,
+    height: number
+  ): void {
+    const target = canvas ?? this.options.createCanvas?.(width, height);
+    if (!target) {
+      const msg = 'No canvas to render into; transfer one or provide createCanvas';
+      this.enqueue(id, null, { type: EventType.LoadError, data: msg });
+      return;
+    }
+    this.canvases.set(id, target);
+    const forward = (event: Event) => this.enqueue(id, this.objects.get(id), event);
+    const r = new Rive({
+      ...params,
+      canvas: target,
+      layout: params.layout ? new Layout(params.layout) : undefined,
+      onload: forward,
+      onloaderror: forward,
+      onplay: forward,
+      onpause: forward,
+      onstop: forward,
+      onloop: forward,
+      onstatechange: forward,
+    });
+    this.objects.set(id, r);
+  }
+
+  // Queues an event to be sent back with the others fired in this task
+  private enqueue(id: number, r: Rive | undefined, event: Event): void {
+    const workerEvent: WorkerEvent = {
+      id: id,
+      event: event,
+      state: snapshotState(r),
+    };
+    if (r && event.type === EventType.Load) {
+      workerEvent.contents = r.contents;
+    }
+    this.queue.push(workerEvent);
+    if (!this.flushScheduled) {
+      this.flushScheduled = true;
+      Promise.resolve().then(() => {
+        this.flushScheduled = false;
+        const message: WorkerEventMessage = { events: this.queue };
+        this.queue = [];
+        this.port.postMessage(message);
+      });
+    }
+  }
+}
+
+// Captures the state a proxy mirrors
+const snapshotState = (r?: Rive): WorkerState => {
+  const stateMachineNames = r ?
+    r.playingStateMachineNames.concat(r.pausedStateMachineNames) :
+    [];
+  const inputs: { [stateMachine: string]: StateMachineInputContents[] } = {};
+  for (const name of stateMachineNames) {
+    inputs[name] = (r.stateMachineInputs(name) ?? []).map(input => ({
+      name: input.name,
+      type: input.type,
+      initialValue: input.value,
+    }));
+  }
+  return {
+    loaded: r?.bounds !== undefined,
+    bounds: r?.bounds,
+    animationNames: r?.animationNames ?? [],
+    stateMachineNames: r?.stateMachineNames ?? [],
+    playingAnimationNames: r?.playingAnimationNames ?? [],
+    pausedAnimationNames: r?.pausedAnimationNames ?? [],
+    playingStateMachineNames: r?.playingStateMachineNames ?? [],
+    pausedStateMachineNames: r?.pausedStateMachineNames ?? [],
+    isPlaying: r?.isPlaying ?? false,
+    isPaused: r?.isPaused ?? false,
+    isStopped: r?.isStopped ?? true,
+    inputs: inputs,
+  };
+}
+
+// Ids of proxies; unique across ports so that several can share a worker
+let nextProxyId = 1;
+
+// Batches the commands of every proxy talking over a port into one message per
+// task, and routes the events coming back to their proxies
+class WorkerChannel {
+  private static channels = new WeakMap<WorkerPort, WorkerChannel>();
+
+  private proxies = new Map<number, RiveProxy>();
+  private commands: WorkerCommand[] = [];
+  private transfer: Transferable[] = [];
+  private flushScheduled = false;
+
+  private constructor(private port: WorkerPort) {
+    listenToPort(port, (data: WorkerEventMessage) => {
+      for (const workerEvent of data.events) {
+        this.proxies.get(workerEvent.id)?.receive(workerEvent);
+      }
+    });
+  }
+
+  public static of(port: WorkerPort): WorkerChannel {
+    let channel = WorkerChannel.channels.get(port);
+    if (!channel) {
+      channel = new WorkerChannel(port);
+      WorkerChannel.channels.set(port, channel);
+    }
+    return channel;
+  }
+
+  public register(id: number, proxy: RiveProxy): void {
+    this.proxies.set(id, proxy);
+  }
+
+  public unregister(id: number): void {
+    this.proxies.delete(id);
+  }
+
+  public send(command: WorkerCommand, transfer: Transferable[] = []): void {
+    this.commands.push(command);
+    this.transfer.push(...transfer);
+    if (!this.flushScheduled) {
+      this.flushScheduled = true;
+      Promise.resolve().then(() => this.flush());
+    }
+  }
+
+  private flush(): void {
+    this.flushScheduled = false;
+    const message: WorkerCommandMessage = { commands: this.commands };
+    const transfer = this.transfer;
+    this.commands = [];
+    this.transfer = [];
+    this.port.postMessage(message, transfer);
+  }
+}
+
+/**
+ * An input of a state machine playing in a worker. Values read are those last
+ * set here or reported by the worker; values set are sent to the worker.
+ */
+export class ProxyStateMachineInput {
+  constructor(
+    public readonly name: string,
+    public readonly type: StateMachineInputType,
+    private _value: number | boolean,
+    private onSet: (value: number | boolean) => void,
+    private onFire: VoidCallback
+  ) { }
+
+  public get value(): number | boolean {
+    return this._value;
+  }
+
+  public set value(value: number | boolean) {
+    this._value = value;
+    this.onSet(value);
+  }
+
+  /**
+   * Fires a trigger; does nothing on Number or Boolean input types
+   */
+  public fire(): void {
+    if (this.type === StateMachineInputType.Trigger) {
+      this.onFire();
+    }
+  }
+
+  /**
+   * Takes the value reported by the worker, without sending it back
+   */
+  public received(value: number | boolean): void {
+    this._value = value;
+  }
+}
+
+/**
+ * Parameters for a RiveProxy; as for Rive, plus the worker to run in
+ */
+export interface RiveProxyParameters extends RiveParameters {
+  // A worker whose script calls RiveWorkerHost.listen, or a port to one
+  worker: WorkerPort;
+}
+
+/**
+ * Plays a Rive file in a worker, keeping the main thread free for scrolling
+ * and input. The canvas is transferred to the worker, which advances and draws
+ * the artboard; this object forwards playback and input changes to it and
+ * mirrors its state from the events it sends back. Calls made in the same task
+ * are sent together, and the state read here is as of the last event
+ * received, so it trails calls made since.
+ */
+export class RiveProxy {
+  private readonly id = nextProxyId++;
+  private readonly channel: WorkerChannel;
+  private readonly canvas: HTMLCanvasElement | OffscreenCanvas;
+  private readonly eventManager = new EventManager();
+  private src: string;
+  private _layout: Layout;
+  private state: WorkerState = snapshotState();
+  private _contents: RiveFileContents;
+  private inputs = new Map<string, ProxyStateMachineInput[]>();
+  private observer: IntersectionObserver | null = null;
+  // Whether the canvas is on screen, as last reported by the observer
+  private visible = true;
+  // Whether stopRendering() was called and startRendering() hasn't been
+  // since; the canvas coming into view then doesn't restart rendering
+  private renderingStopped = false;
+
+  constructor(params: RiveProxyParameters) {
+    if (!params.src && !params.buffer) {
+      throw new Error(Rive.missingErrorMessage);
+    }
+    this.canvas = params.canvas;
+    this.src = params.src;
+    this._layout = params.layout ?? new Layout();
+    this.channel = WorkerChannel.of(params.worker);
+    this.channel.register(this.id, this);
+
+    if (params.onload) this.on(EventType.Load, params.onload);
+    if (params.onloaderror) this.on(EventType.LoadError, params.onloaderror);
+    if (params.onplay) this.on(EventType.Play, params.onplay);
+    if (params.onpause) this.on(EventType.Pause, params.onpause);
+    if (params.onstop) this.on(EventType.Stop, params.onstop);
+    if (params.onloop) this.on(EventType.Loop, params.onloop);
+    if (params.onstatechange) this.on(EventType.StateChange, params.onstatechange);
+
+    // Hand the canvas over to the worker where possible; otherwise the worker
+    // makes its own of the same size
+    const canvas = params.canvas as any;
+    let offscreen: OffscreenCanvas | undefined;
+    if (typeof canvas.transferControlToOffscreen === 'function') {
+      offscreen = canvas.transferControlToOffscreen();
+    } else if (typeof OffscreenCanvas !== 'undefined' && canvas instanceof OffscreenCanvas) {
+      offscreen = canvas;
+    }
+    const loadParams = {
+      src: params.src,
+      buffer: params.buffer,
+      artboard: params.artboard,
+      animations: params.animations,
+      stateMachines: params.stateMachines,
+      autoplay: params.autoplay,
+      layout: params.layout ? layoutParameters(params.layout) : undefined,
+    };
+    this.send(
+      'create',
+      [loadParams, offscreen, params.canvas.width, params.canvas.height],
+      offscreen ? [offscreen] : []
+    );
+    this.observe();
+  }
+
+  private send(op: string, args?: any[], transfer?: Transferable[]): void {
+    this.channel.send({ id: this.id, op: op, args: args }, transfer);
+  }
+
+  /**
+   * Applies the state and fires an event sent back by the worker
+   * @internal
+   */
+  public receive({ event, state, contents }: WorkerEvent): void {
+    this.state = state;
+    if (contents) {
+      this._contents = contents;
+    }
+    this.updateInputs();
+    this.eventManager.fire(event);
+  }
+
+  // Updates the inputs handed out with the values the worker reported, so
+  // that they stay live; those of state machines that are gone or now have
+  // different inputs are dropped
+  private updateInputs(): void {
+    this.inputs.forEach((inputs, name) => {
+      const contents = this.state.inputs[name];
+      if (!contents || contents.length !== inputs.length ||
+        contents.some((input, i) => input.name !== inputs[i].name)) {
+        this.inputs.delete(name);
+        return;
+      }
+      contents.forEach((input, i) => inputs[i].received(input.initialValue));
+    });
+  }
+
+  // Pauses rendering in the worker while the canvas is offscreen
+  private observe(): void {
+    if (typeof IntersectionObserver === 'undefined' ||
+      !(this.canvas instanceof Element)) {
+      return;
+    }
+    this.observer = new IntersectionObserver(entries => {
+      for (const entry of entries) {
+        this.visible = entry.isIntersecting;
+        if (!this.renderingStopped) {
+          this.send(this.visible ? 'startRendering' : 'stopRendering');
+        }
+      }
+    });
+    this.observer.observe(this.canvas);
+  }
+
+  public play(animationNames?: string | string[]): void {
+    this.send('play', [mapToStringArray(animationNames)]);
+  }
+
+  public pause(animationNames?: string | string[]): void {
+    this.send('pause', [mapToStringArray(animationNames)]);
+  }
+
+  public scrub(animationNames?: string | string[], value?: number): void {
+    this.send('scrub', [mapToStringArray(animationNames), value]);
+  }
+
+  public stop(animationNames?: string | string[]): void {
+    this.send('stop', [mapToStringArray(animationNames)]);
+  }
+
+  // Loads a new Rive file in the worker, keeping listeners in place
+  public load(params: RiveLoadParameters): void {
+    this.src = params.src;
+    this.send('load', [params]);
+  }
+
+  public set layout(layout: Layout) {
+    this._layout = layout;
+    this.send('layout', [layoutParameters(layout)]);
+  }
+
+  public get layout(): Layout {
+    return this._layout;
+  }
+
+  /**
+   * Sets the layout bounds to the size of the worker's canvas
+   */
+  public resizeToCanvas(): void {
+    this.send('resizeToCanvas');
+  }
+
+  /**
+   * Resizes the worker's canvas and fits the layout to it; a canvas element
+   * can't be resized once transferred
+   */
+  public resize(width: number, height: number): void {
+    this.send('resize', [width, height]);
+  }
+
+  public stopRendering(): void {
+    this.renderingStopped = true;
+    this.send('stopRendering');
+  }
+
+  // Rendering starts once the canvas is in view, if it isn't yet
+  public startRendering(): void {
+    this.renderingStopped = false;
+    if (this.visible) {
+      this.send('startRendering');
+    }
+  }
+
+  /**
+   * Releases the Rive object in the worker; the proxy is unusable afterwards
+   */
+  public cleanup(): void {
+    this.observer?.disconnect();
+    this.observer = null;
+    this.send('cleanup');
+    this.channel.unregister(this.id);
+    this.state = snapshotState();
+    this._contents = undefined;
+    this.inputs.clear();
+  }
+
+  public get source(): string {
+    return this.src;
+  }
+
+  public get animationNames(): string[] {
+    return this.state.animationNames;
+  }
+
+  public get stateMachineNames(): string[] {
+    return this.state.stateMachineNames;
+  }
+
+  public get playingAnimationNames(): string[] {
+    return this.state.playingAnimationNames;
+  }
+
+  public get pausedAnimationNames(): string[] {
+    return this.state.pausedAnimationNames;
+  }
+
+  public get playingStateMachineNames(): string[] {
+    return this.state.playingStateMachineNames;
+  }
+
+  public get pausedStateMachineNames(): string[] {
+    return this.state.pausedStateMachineNames;
+  }
+
+  public get isPlaying(): boolean {
+    return this.state.isPlaying;
+  }
+
+  public get isPaused(): boolean {
+    return this.state.isPaused;
+  }
+
+  public get isStopped(): boolean {
+    return this.state.isStopped;
+  }
+
+  public get bounds(): Bounds {
+    return this.state.bounds;
+  }
+
+  public get contents(): RiveFileContents {
+    return this.state.loaded ? this._contents : undefined;
+  }
+
+  /**
+   * Returns the inputs of an instanced state machine; setting their values or
+   * firing them is forwarded to the worker; empty if no state machine of that
+   * name is instanced
+   * @param name the state machine name
+   */
+  public stateMachineInputs(name: string): ProxyStateMachineInput[] {
+    const contents = this.state.inputs[name];
+    if (!contents) {
+      return [];
+    }
+    let inputs = this.inputs.get(name);
+    if (!inputs) {
+      inputs = contents.map(input => new ProxyStateMachineInput(
+        input.name,
+        input.type,
+        input.initialValue,
+        (value) => this.send('input', [name, input.name, value]),
+        () => this.send('fire', [name, input.name])
+      ));
+      this.inputs.set(name, inputs);
+    }
+    return inputs;
+  }
+
+  public on(type: EventType, callback: EventCallback) {
+    this.eventManager.add({ type: type, callback: callback });
+  }
+
+  public unsubscribe(type: EventType, callback: EventCallback) {
+    this.eventManager.remove({ type: type, callback: callback });
+  }
+
+  public unsubscribeAll(type?: EventType) {
+    this.eventManager.removeAll(type);
+  }
+}
+
+// Plain parameters of a layout, to send to a worker
+const layoutParameters = (layout: Layout): LayoutParameters => ({
+  fit: layout.fit,
+  alignment: layout.alignment,
+  minX: layout.minX,
+  minY: layout.minY,
+  maxX: layout.maxX,
+  maxY: layout.maxY,
+});
+
 // #endregion
 
 // #region utility functions
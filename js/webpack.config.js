@@ -23,6 +23,8 @@ const webConfig = {
   output: {
     path: path.resolve(__dirname, 'dist'),
     filename: 'rive.min.js',
+    // The SIMD runtime, loaded on demand
+    chunkFilename: '[name].min.js',
     library: {
       type: 'assign-properties',
       name: 'rive'
@@ -63,6 +65,7 @@ const moduleConfig = {
   output: {
     path: path.resolve(__dirname, 'dist'),
     filename: 'rive.dev.js',
+    chunkFilename: '[name].dev.js',
     libraryTarget: 'umd',
     library: 'rive',
     globalObject: 'this',
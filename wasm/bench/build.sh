@@ -0,0 +1,21 @@
+#!/bin/bash
+
+OPTION=$1
+
+if [ "$OPTION" = 'help' ]; then
+    echo build.sh - build the native benchmark
+    echo build.sh wasm - build the benchmark with emscripten, to run under node
+    echo build.sh wasmsimd - the emscripten build with wasm SIMD
+    echo build.sh clean - clean the build
+    exit 0
+elif [ "$OPTION" = "clean" ]; then
+    echo Cleaning project ...
+    rm -fR ./build
+    exit 0
+elif [ "$OPTION" = "wasmsimd" ]; then
+    premake5 gmake2 --wasm --simd && AR=emar CC=emcc CXX=em++ make config=release -j7
+elif [ "$OPTION" = "wasm" ]; then
+    premake5 gmake2 --wasm && AR=emar CC=emcc CXX=em++ make config=release -j7
+else
+    premake5 gmake2 && make config=release -j7
+fi
@@ -0,0 +1,57 @@
+-- Benchmarks rive-cpp natively or, with --wasm, as a node program built by
+-- emscripten so the two can be compared with the same harness.
+newoption {trigger = "wasm", description = "Build the benchmark with emscripten to run under node"}
+newoption {trigger = "simd", description = "With --wasm, build with wasm SIMD (-msimd128)"}
+
+workspace "rive_bench"
+configurations {"debug", "release"}
+
+project "rive_bench"
+kind "ConsoleApp"
+language "C++"
+cppdialect "C++17"
+targetdir "build/bin/%{cfg.buildcfg}"
+objdir "build/obj/%{cfg.buildcfg}"
+includedirs {"../submodules/rive-cpp/include", "../src", "./src"}
+
+files {"../submodules/rive-cpp/src/**.cpp", "../src/arena.cpp", "../src/recording_render_paint.cpp",
+       "../src/recording_render_path.cpp", "../src/flat_path.cpp", "../src/rasterizer.cpp",
+       "../src/software_renderer.cpp", "../src/kernels.cpp", "../src/tessellator.cpp", "../src/mesh_renderer.cpp",
+       "../src/hit_tester.cpp", "../src/advance_batch.cpp", "../src/animation_bake.cpp", "../src/frame_stats.cpp",
+       "../src/event_ring.cpp", "../src/thread_pool.cpp", "../src/damage_tracker.cpp", "../src/input_writes.cpp",
+       "../src/flat_geometry.cpp", "./src/*.cpp"}
+
+defines {"RIVE_USE_THREADS", "ENABLE_QUERY_FLAT_VERTICES"}
+buildoptions {"-fno-exceptions", "-fno-rtti", "-pthread"}
+linkoptions {"-pthread"}
+
+filter "options:wasm"
+targetextension ".js"
+objdir "build/obj/wasm/%{cfg.buildcfg}"
+buildoptions {"-Wno-c++17-extensions"}
+linkoptions {"-s ALLOW_MEMORY_GROWTH=1", "-s DISABLE_EXCEPTION_CATCHING=1", "-s ENVIRONMENT=node,worker",
+             "-s NODERAWFS=1", "-s EXIT_RUNTIME=1", "-s USE_PTHREADS=1", "-s PTHREAD_POOL_SIZE=8"}
+defines {"RIVE_ARENA_GUARD_STATICS"}
+linkoptions {"-Wl,--wrap=__cxa_guard_acquire,--wrap=__cxa_guard_release,--wrap=__cxa_guard_abort"}
+
+-- Keeps function-local statics out of arenas where the linker can wrap their
+-- guards, as in the runtime's build.
+filter {"system:linux", "options:not wasm"}
+defines {"RIVE_ARENA_GUARD_STATICS"}
+linkoptions {"-Wl,--wrap=__cxa_guard_acquire,--wrap=__cxa_guard_release,--wrap=__cxa_guard_abort"}
+
+filter {"options:wasm", "options:simd"}
+targetdir "build/bin/simd"
+objdir "build/obj/simd/%{cfg.buildcfg}"
+buildoptions {"-msimd128"}
+linkoptions {"-msimd128"}
+
+filter "configurations:debug"
+defines {"DEBUG"}
+symbols "On"
+
+filter "configurations:release"
+defines {"RELEASE"}
+defines {"NDEBUG"}
+optimize "Speed"
+symbols "On"
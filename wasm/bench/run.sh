@@ -0,0 +1,18 @@
+#!/bin/bash
+# Runs the native and wasm benchmarks over the same .riv files, e.g.
+# ./run.sh --frames 600 path/to/*.riv
+
+set -e
+
+if [ -f ./build/bin/release/rive_bench ]; then
+    echo "== native"
+    ./build/bin/release/rive_bench "$@"
+fi
+if [ -f ./build/bin/release/rive_bench.js ]; then
+    echo "== wasm (node)"
+    node ./build/bin/release/rive_bench.js "$@"
+fi
+if [ -f ./build/bin/simd/rive_bench.js ]; then
+    echo "== wasm simd (node)"
+    node ./build/bin/simd/rive_bench.js "$@"
+fi
@@ -0,0 +1,65 @@
+#include "arena_check.hpp"
+#include "arena.hpp"
+#include <stdio.h>
+#include <vector>
+
+static bool check(const char *name, bool passed) {
+  printf("  %-24s %-32s %s\n", "arena check", name, passed ? "ok" : "FAILED");
+  return passed;
+}
+
+#ifdef RIVE_ARENA_GUARD_STATICS
+// Allocates its buffer the first time it's reached.
+static std::vector<int> &lazyStatic() {
+  static std::vector<int> values(64);
+  return values;
+}
+#endif
+
+bool checkArenas() {
+  std::vector<int> *heap = nullptr;
+  auto built = Arena::make([&heap]() {
+    {
+      Arena::Scope scope(nullptr);
+      heap = new std::vector<int>(64);
+    }
+#ifdef RIVE_ARENA_GUARD_STATICS
+    lazyStatic();
+#endif
+    return new std::vector<int>(64);
+  });
+  bool passed = check("built object", Arena::contains(built) &&
+                                          Arena::contains(built->data()));
+  passed = check("null scope", !Arena::contains(heap) &&
+                                   !Arena::contains(heap->data())) &&
+           passed;
+#ifdef RIVE_ARENA_GUARD_STATICS
+  passed = check("function-local static",
+                 !Arena::contains(lazyStatic().data())) &&
+           passed;
+#endif
+  const int *element = built->data();
+  delete built;
+  delete heap;
+  passed = check("released", !Arena::contains(element)) && passed;
+
+  // Each arena takes a few chunks, more than the pool keeps altogether.
+  std::vector<std::vector<char *> *> objects;
+  for (int i = 0; i < 16; i++) {
+    objects.push_back(Arena::make([]() {
+      auto object = new std::vector<char *>();
+      object->reserve(8);
+      for (int j = 0; j < 8; j++) {
+        object->push_back(new char[Arena::chunkSize / 8]);
+      }
+      return object;
+    }));
+  }
+  for (auto object : objects) {
+    delete object;
+  }
+  passed = check("pooled chunks capped",
+                 Arena::pooledCapacity() <= 16 * Arena::chunkSize) &&
+           passed;
+  return passed;
+}
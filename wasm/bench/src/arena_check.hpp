@@ -0,0 +1,11 @@
+#ifndef _RIVE_ARENA_CHECK_HPP_
+#define _RIVE_ARENA_CHECK_HPP_
+
+// Builds objects in arenas and checks what ends up in them: the built object
+// until it's deleted, but not what a null Scope (as around calls out to JS)
+// or, where guarded, a function-local static allocates, and that released
+// chunks are returned to the heap past the pool's limit. Prints a line per
+// case and returns whether all of them passed.
+bool checkArenas();
+
+#endif
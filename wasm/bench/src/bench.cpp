@@ -0,0 +1,505 @@
+#include "advance_batch.hpp"
+#include "animation_bake.hpp"
+#include "animation/linear_animation.hpp"
+#include "animation/linear_animation_instance.hpp"
+#include "animation/state_machine.hpp"
+#include "animation/state_machine_instance.hpp"
+#include "arena.hpp"
+#include "arena_check.hpp"
+#include "artboard.hpp"
+#include "core/binary_reader.hpp"
+#include "damage_check.hpp"
+#include "file.hpp"
+#include "flat_geometry_check.hpp"
+#include "hit_tester.hpp"
+#include "kernel_check.hpp"
+#include "mesh_renderer.hpp"
+#include "null_renderer.hpp"
+#include "path_check.hpp"
+#include "render_check.hpp"
+#include "software_renderer.hpp"
+#include "tessellation_check.hpp"
+#include "thread_pool_check.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <malloc.h>
+#include <new>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/heap.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Every heap allocation made through operator new is counted so that each stage
+// can report how many it makes per frame; steady state playback should make
+// none. Allocations served by an arena, like imports', aren't. The bytes they
+// hold are tracked too, along with their peak counting arenas, to compare
+// imports with and without arenas. Atomic as batch playback allocates from
+// worker threads too. Like the runtime's operator_new.cpp otherwise.
+static std::atomic<uint64_t> allocationCount{0};
+static std::atomic<size_t> heapBytes{0};
+static std::atomic<size_t> peakHeapBytes{0};
+
+// Bytes held by the heap and by arenas.
+static size_t heapInUse() { return heapBytes + Arena::totalCapacity(); }
+
+static void updatePeakHeap() {
+  size_t heap = heapInUse();
+  size_t peak = peakHeapBytes;
+  while (heap > peak && !peakHeapBytes.compare_exchange_weak(peak, heap)) {
+  }
+}
+
+void *operator new(size_t size) {
+  void *memory = Arena::allocateScoped(size);
+  if (memory != nullptr) {
+    updatePeakHeap();
+    return memory;
+  }
+  allocationCount++;
+  memory = malloc(size == 0 ? 1 : size);
+  if (memory == nullptr) {
+    abort();
+  }
+  heapBytes += malloc_usable_size(memory);
+  updatePeakHeap();
+  return memory;
+}
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *memory) noexcept {
+  if (!Arena::deallocate(memory)) {
+    if (memory != nullptr) {
+      heapBytes -= malloc_usable_size(memory);
+    }
+    free(memory);
+  }
+}
+void operator delete[](void *memory) noexcept { operator delete(memory); }
+void operator delete(void *memory, size_t) noexcept { operator delete(memory); }
+void operator delete[](void *memory, size_t) noexcept {
+  operator delete(memory);
+}
+
+namespace rive {
+RenderPaint *makeRenderPaint() { return new SoftwareRenderPaint(); }
+RenderPath *makeRenderPath() { return new SoftwareRenderPath(); }
+} // namespace rive
+
+static const float frameTime = 1.0f / 60.0f;
+
+static uint64_t now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Peak memory in kilobytes. Natively this is the process' peak resident set;
+// under wasm it's the size of the heap, which only ever grows.
+static uint64_t peakMemory() {
+#ifdef __EMSCRIPTEN__
+  return emscripten_get_heap_size() / 1024;
+#else
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+#endif
+}
+
+// Accumulated cost of one stage of the pipeline over a number of samples.
+class Stage {
+private:
+  const char *m_Name;
+  uint64_t m_Elapsed = 0;
+  uint64_t m_Allocations = 0;
+  uint64_t m_Samples = 0;
+  uint64_t m_Start = 0;
+  uint64_t m_StartAllocations = 0;
+
+public:
+  Stage(const char *name) : m_Name(name) {}
+
+  void begin() {
+    m_StartAllocations = allocationCount;
+    m_Start = now();
+  }
+
+  void end() {
+    m_Elapsed += now() - m_Start;
+    m_Allocations += allocationCount - m_StartAllocations;
+    m_Samples++;
+  }
+
+  void print(const char *label) const {
+    if (m_Samples == 0) {
+      return;
+    }
+    printf("  %-24s %-24s %12.0f ns %10.2f allocs\n", m_Name, label,
+           (double)m_Elapsed / m_Samples,
+           (double)m_Allocations / m_Samples);
+  }
+};
+
+// Imports into an arena, like the runtime's FileImporter, or else straight
+// onto the heap.
+static rive::File *importFile(std::vector<uint8_t> &bytes,
+                              bool inArena = true) {
+  auto import = [&bytes]() -> rive::File * {
+    rive::File *file = nullptr;
+    auto reader = rive::BinaryReader(bytes.data(), bytes.size());
+    if (rive::File::import(reader, &file) != rive::ImportResult::success) {
+      return nullptr;
+    }
+    return file;
+  };
+  return inArena ? Arena::make(import) : import();
+}
+
+// Prints the heap build takes at its peak and keeps until what it returns is
+// deleted.
+template <typename Build>
+static void measureHeap(const char *name, const char *label, Build build) {
+  size_t before = heapInUse();
+  peakHeapBytes = before;
+  auto object = build();
+  size_t kept = heapInUse() - before;
+  size_t peak = peakHeapBytes - before;
+  delete object;
+  printf("  %-24s %-24s %12zu KB peak %10zu KB kept\n", name, label,
+         peak / 1024, kept / 1024);
+}
+
+static bool readFile(const char *path, std::vector<uint8_t> &bytes) {
+  FILE *fp = fopen(path, "rb");
+  if (fp == nullptr) {
+    return false;
+  }
+  fseek(fp, 0, SEEK_END);
+  long length = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  bytes.resize(length < 0 ? 0 : length);
+  bool read = fread(bytes.data(), 1, bytes.size(), fp) == bytes.size();
+  fclose(fp);
+  return read;
+}
+
+// Points hit tested per frame, along the artboard's diagonals.
+static const int hitTestPoints = 16;
+
+// Plays an animation or state machine for a number of frames, timing advance,
+// apply, artboard advance and draw separately. With a raster, frames are also
+// rendered into it, with a mesh renderer tessellated at the artboard's size,
+// and with a hit tester drawn into it and hit tested.
+template <typename Instance>
+static void playback(rive::Artboard *artboard, Instance &instance,
+                     const char *label, int frames, SoftwareRenderer *raster,
+                     MeshRenderer *meshes, HitTester *hits) {
+  NullRenderer renderer;
+  Stage advance("advance"), apply("apply"), artboardAdvance("artboard advance"),
+      draw("artboard draw"), rasterize("rasterize"), tessellate("tessellate"),
+      hitUpdate("hit test update"), hitTest("hit test x16");
+
+  for (int i = 0; i < frames; i++) {
+    advance.begin();
+    instance.advance(frameTime);
+    advance.end();
+
+    apply.begin();
+    instance.apply(artboard);
+    apply.end();
+
+    artboardAdvance.begin();
+    artboard->advance(frameTime);
+    artboardAdvance.end();
+
+    draw.begin();
+    artboard->draw(&renderer);
+    draw.end();
+
+    if (raster != nullptr) {
+      rasterize.begin();
+      raster->clear(0);
+      raster->save();
+      raster->align(rive::Fit::contain, rive::Alignment::center,
+                    rive::AABB(0.0f, 0.0f, (float)raster->width(),
+                               (float)raster->height()),
+                    artboard->bounds());
+      artboard->draw(raster);
+      raster->restore();
+      rasterize.end();
+    }
+
+    if (meshes != nullptr) {
+      tessellate.begin();
+      meshes->clear();
+      artboard->draw(meshes);
+      tessellate.end();
+    }
+
+    if (hits != nullptr) {
+      hitUpdate.begin();
+      hits->update(artboard);
+      hitUpdate.end();
+
+      rive::AABB bounds = artboard->bounds();
+      float width = bounds.maxX - bounds.minX;
+      float height = bounds.maxY - bounds.minY;
+      hitTest.begin();
+      for (int j = 0; j < hitTestPoints; j++) {
+        float t = (j / 2 + 0.5f) / (hitTestPoints / 2);
+        float y = bounds.minY + height * (j % 2 == 0 ? t : 1.0f - t);
+        hits->hitTest(bounds.minX + width * t, y);
+      }
+      hitTest.end();
+    }
+  }
+  advance.print(label);
+  apply.print(label);
+  artboardAdvance.print(label);
+  draw.print(label);
+  rasterize.print(label);
+  tessellate.print(label);
+  hitUpdate.print(label);
+  hitTest.print(label);
+}
+
+// Bakes the animation at fps and plays it back from the bake, timing the bake
+// and the baked applies to compare with playback's keyframed ones.
+static void bakedPlayback(rive::Artboard *artboard,
+                          rive::LinearAnimation *animation, float fps,
+                          int frames) {
+  Stage bake("bake"), apply("baked apply");
+  bake.begin();
+  AnimationBake baked(artboard, animation, fps);
+  bake.end();
+
+  rive::LinearAnimationInstance instance(animation);
+  if (baked.unbakedCount() != 0) {
+    printf("  %-24s %s keys %u properties that can't be baked\n", "bake",
+           animation->name().c_str(), baked.unbakedCount());
+    return;
+  }
+  if (!baked.appliesTo(artboard)) {
+    return;
+  }
+  for (int i = 0; i < frames; i++) {
+    instance.advance(frameTime);
+    apply.begin();
+    baked.applyVerified(artboard, instance.time(), 1.0f);
+    apply.end();
+  }
+  char label[64];
+  snprintf(label, sizeof(label), "%s, %zu properties, %zu KB",
+           animation->name().c_str(), baked.propertyCount(),
+           baked.byteSize() / 1024);
+  bake.print(label);
+  apply.print(label);
+}
+
+// Advances instances of the artboard, each playing its first state machine or
+// else its first animation, through an AdvanceBatch, serially and then with
+// threads, to measure throughput.
+static void batchPlayback(rive::Artboard *artboard, int instances, int threads,
+                          int frames) {
+  std::vector<rive::Artboard *> artboards;
+  std::vector<rive::LinearAnimationInstance *> animations;
+  std::vector<rive::StateMachineInstance *> machines;
+  std::vector<BatchedArtboard *> batched;
+  AdvanceBatch batch;
+  for (int i = 0; i < instances; i++) {
+    auto instance = Arena::make([artboard]() { return artboard->instance(); });
+    auto artboardBatch = new BatchedArtboard(instance);
+    if (instance->stateMachineCount() > 0) {
+      machines.push_back(
+          new rive::StateMachineInstance(instance->stateMachine(0)));
+      artboardBatch->addStateMachine(machines.back(), true);
+    } else if (instance->animationCount() > 0) {
+      animations.push_back(
+          new rive::LinearAnimationInstance(instance->animation(0)));
+      artboardBatch->addAnimation(animations.back(), true);
+    }
+    artboards.push_back(instance);
+    batched.push_back(artboardBatch);
+    batch.add(artboardBatch);
+  }
+
+  char label[64];
+  for (int threadCount : {0, threads}) {
+    batch.threadCount(threadCount);
+    snprintf(label, sizeof(label), "%d instances, %d threads", instances,
+             (int)batch.threadCount());
+    Stage advance("batch advance");
+    for (int i = 0; i < frames; i++) {
+      float *elapsed = batch.elapsed();
+      for (size_t j = 0; j < batch.size(); j++) {
+        elapsed[j] = frameTime;
+      }
+      advance.begin();
+      batch.advance();
+      advance.end();
+    }
+    advance.print(label);
+    if (threads == 0) {
+      break;
+    }
+  }
+
+  batch.threadCount(0);
+  for (auto artboardBatch : batched) {
+    delete artboardBatch;
+  }
+  for (auto instance : animations) {
+    delete instance;
+  }
+  for (auto instance : machines) {
+    delete instance;
+  }
+  for (auto instance : artboards) {
+    delete instance;
+  }
+}
+
+static bool benchmark(const char *path, int iterations, int frames,
+                      SoftwareRenderer *raster, MeshRenderer *meshes,
+                      bool hitTest, float bakeFps, int instances,
+                      int threads) {
+  std::vector<uint8_t> bytes;
+  if (!readFile(path, bytes)) {
+    fprintf(stderr, "failed to read %s\n", path);
+    return false;
+  }
+  printf("%s (%zu bytes)\n", path, bytes.size());
+
+  Stage import("import");
+  for (int i = 0; i < iterations; i++) {
+    import.begin();
+    rive::File *file = importFile(bytes);
+    import.end();
+    if (file == nullptr) {
+      fprintf(stderr, "failed to import %s\n", path);
+      return false;
+    }
+    delete file;
+  }
+  import.print("");
+
+  size_t arenaCapacity = Arena::totalCapacity();
+  rive::File *file = importFile(bytes);
+  printf("  %-24s %-24s %12zu KB\n", "import arena", "",
+         (Arena::totalCapacity() - arenaCapacity) / 1024);
+  measureHeap("import heap", "arenas",
+              [&bytes]() { return importFile(bytes); });
+  measureHeap("import heap", "no arenas",
+              [&bytes]() { return importFile(bytes, false); });
+  rive::Artboard *artboard = file->artboard();
+  measureHeap("instance heap", "arenas", [artboard]() {
+    return Arena::make([artboard]() { return artboard->instance(); });
+  });
+  measureHeap("instance heap", "no arenas",
+              [artboard]() { return artboard->instance(); });
+  for (size_t i = 0; i < artboard->animationCount(); i++) {
+    auto animation = artboard->animation(i);
+    rive::LinearAnimationInstance instance(animation);
+    HitTester hits;
+    playback(artboard, instance, animation->name().c_str(), frames, raster,
+             meshes, hitTest ? &hits : nullptr);
+    if (bakeFps >= 0.0f) {
+      bakedPlayback(artboard, animation, bakeFps, frames);
+    }
+  }
+  for (size_t i = 0; i < artboard->stateMachineCount(); i++) {
+    auto machine = artboard->stateMachine(i);
+    rive::StateMachineInstance instance(machine);
+    HitTester hits;
+    playback(artboard, instance, machine->name().c_str(), frames, raster,
+             meshes, hitTest ? &hits : nullptr);
+  }
+  if (instances > 0) {
+    batchPlayback(artboard, instances, threads, frames);
+  }
+  delete file;
+  return true;
+}
+
+static void usage() {
+  fprintf(stderr, "usage: rive_bench [--iterations n] [--frames n] "
+                  "[--raster widthxheight] [--tessellate] [--hit-test] "
+                  "[--bake fps] [--instances n [--threads n]] [--check] "
+                  "file.riv [file.riv ...]\n");
+}
+
+int main(int argc, const char *argv[]) {
+  int iterations = 20;
+  int frames = 600;
+  int rasterWidth = 0, rasterHeight = 0;
+  bool tessellate = false;
+  bool hitTest = false;
+  bool check = false;
+  float bakeFps = -1.0f;
+  int instances = 0;
+  int threads = (int)ThreadPool::hardwareThreadCount();
+  std::vector<const char *> paths;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      iterations = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+      frames = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--raster") == 0 && i + 1 < argc) {
+      if (sscanf(argv[++i], "%dx%d", &rasterWidth, &rasterHeight) != 2) {
+        usage();
+        return 1;
+      }
+    } else if (strcmp(argv[i], "--tessellate") == 0) {
+      tessellate = true;
+    } else if (strcmp(argv[i], "--check") == 0) {
+      check = true;
+    } else if (strcmp(argv[i], "--hit-test") == 0) {
+      hitTest = true;
+    } else if (strcmp(argv[i], "--bake") == 0 && i + 1 < argc) {
+      bakeFps = std::max((float)atof(argv[++i]), 0.0f);
+    } else if (strcmp(argv[i], "--instances") == 0 && i + 1 < argc) {
+      instances = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      threads = atoi(argv[++i]);
+    } else {
+      paths.push_back(argv[i]);
+    }
+  }
+  if ((paths.empty() && !check) || iterations < 1 || frames < 1 || instances < 0 ||
+      threads < 0) {
+    usage();
+    return 1;
+  }
+
+  SoftwareRenderer *raster = nullptr;
+  if (rasterWidth > 0 && rasterHeight > 0) {
+    raster = new SoftwareRenderer(rasterWidth, rasterHeight);
+  }
+  MeshRenderer *meshes = tessellate ? new MeshRenderer() : nullptr;
+  bool succeeded = true;
+  if (check) {
+    succeeded = checkTessellation();
+    succeeded = checkKernels() && succeeded;
+    succeeded = checkDamage() && succeeded;
+    succeeded = checkPaths() && succeeded;
+    succeeded = checkArenas() && succeeded;
+    succeeded = checkRendering() && succeeded;
+    succeeded = checkThreadPool() && succeeded;
+    succeeded = checkFlatGeometry() && succeeded;
+  }
+  for (auto path : paths) {
+    succeeded = benchmark(path, iterations, frames, raster, meshes, hitTest,
+                          bakeFps, instances, threads) &&
+                succeeded;
+  }
+  delete raster;
+  delete meshes;
+  printf("peak memory %llu KB\n", (unsigned long long)peakMemory());
+  return succeeded ? 0 : 1;
+}
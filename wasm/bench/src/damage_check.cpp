@@ -0,0 +1,73 @@
+#include "damage_check.hpp"
+#include "damage_tracker.hpp"
+#include "recording_render_paint.hpp"
+#include "recording_render_path.hpp"
+#include <stdio.h>
+#include <vector>
+
+struct Box {
+  float x, y, width, height;
+};
+
+// Draws a frame of boxes, one path each, returning the number of damaged
+// rectangles.
+static size_t drawFrame(DamageTracker &tracker,
+                        std::vector<RecordingRenderPath> &paths,
+                        RecordingRenderPaint &paint,
+                        const std::vector<Box> &boxes) {
+  paths.resize(boxes.size());
+  tracker.beginFrame();
+  for (size_t i = 0; i < boxes.size(); i++) {
+    const Box &box = boxes[i];
+    RecordingRenderPath &path = paths[i];
+    path.reset();
+    path.moveTo(box.x, box.y);
+    path.lineTo(box.x + box.width, box.y);
+    path.lineTo(box.x + box.width, box.y + box.height);
+    path.lineTo(box.x, box.y + box.height);
+    path.close();
+    tracker.drawPath(&path, &paint);
+  }
+  return tracker.endFrame();
+}
+
+// Draws from, then to, and checks the damage of the second frame.
+static bool check(const char *name, const std::vector<Box> &from,
+                  const std::vector<Box> &to, size_t expectedRects,
+                  bool expectedFull) {
+  DamageTracker tracker;
+  std::vector<RecordingRenderPath> paths;
+  RecordingRenderPaint paint;
+  drawFrame(tracker, paths, paint, from);
+  bool firstFull = tracker.isFull();
+  size_t rects = drawFrame(tracker, paths, paint, to);
+  bool passed = firstFull && rects == expectedRects &&
+                tracker.isFull() == expectedFull;
+  printf("  %-24s %-24s %10zu rects%s %s\n", "damage check", name, rects,
+         tracker.isFull() ? ", full" : "", passed ? "ok" : "FAILED");
+  return passed;
+}
+
+bool checkDamage() {
+  bool passed =
+      check("unchanged", {{10, 10, 20, 20}}, {{10, 10, 20, 20}}, 0, false);
+  // Where the box was and where it is overlap.
+  passed = check("moved", {{10, 10, 20, 20}}, {{15, 10, 20, 20}}, 1, false) &&
+           passed;
+  passed = check("disjoint", {{10, 10, 20, 20}, {200, 200, 20, 20}},
+                 {{12, 10, 20, 20}, {202, 200, 20, 20}}, 2, false) &&
+           passed;
+  // The last box's damage overlaps the first's but not the second's, which
+  // the two only reach once merged.
+  passed = check("bridged",
+                 {{0, 0, 10, 100}, {40, 50, 10, 10}, {5, 0, 45, 10}},
+                 {{0, 0, 10, 99}, {41, 50, 9, 10}, {5, 0, 45, 9}}, 1, false) &&
+           passed;
+  std::vector<Box> from, to;
+  for (int i = 0; i < 40; i++) {
+    from.push_back({i * 50.0f, 0, 10, 10});
+    to.push_back({i * 50.0f, 20, 10, 10});
+  }
+  passed = check("too many", from, to, 0, true) && passed;
+  return passed;
+}
@@ -0,0 +1,11 @@
+#ifndef _RIVE_DAMAGE_CHECK_HPP_
+#define _RIVE_DAMAGE_CHECK_HPP_
+
+// Moves boxes between frames drawn into a DamageTracker and checks the
+// damaged rectangles: unchanged frames damage nothing, overlapping damage is
+// merged (through a rectangle bridging two others too), disjoint damage stays
+// apart and too many rectangles damage the whole canvas. Prints a line per
+// case and returns whether all of them passed.
+bool checkDamage();
+
+#endif
@@ -0,0 +1,97 @@
+#include "flat_geometry_check.hpp"
+
+#ifdef ENABLE_QUERY_FLAT_VERTICES
+
+#include "artboard.hpp"
+#include "core/binary_reader.hpp"
+#include "file.hpp"
+#include "flat_geometry.hpp"
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+// A 500x500 artboard with a background fill and one shape: a rectangle of
+// 99.82 by 99.82, centered on its origin, with a fill. The artboard is object
+// 0, the shape 1 and the rectangle 2.
+static const uint8_t rectangleFile[] = {
+    0x52, 0x49, 0x56, 0x45, 0x07, 0x00, 0x8B, 0x94, 0x02, 0x00, 0x17, 0x00,
+    0x01, 0x07, 0x00, 0x00, 0xFA, 0x43, 0x08, 0x00, 0x00, 0xFA, 0x43, 0x04,
+    0x0C, 0x4E, 0x65, 0x77, 0x20, 0x41, 0x72, 0x74, 0x62, 0x6F, 0x61, 0x72,
+    0x64, 0x00, 0x03, 0x05, 0x00, 0x0D, 0x00, 0x00, 0x7A, 0x43, 0x0E, 0x00,
+    0x00, 0x7A, 0x43, 0x00, 0x07, 0x05, 0x01, 0x14, 0xEA, 0xA3, 0xC7, 0x42,
+    0x15, 0xEA, 0xA3, 0xC7, 0x42, 0x00, 0x14, 0x05, 0x01, 0x00, 0x12, 0x05,
+    0x03, 0x00, 0x14, 0x05, 0x00, 0x00, 0x12, 0x05, 0x05, 0x25, 0x31, 0x31,
+    0x31, 0xFF, 0x00};
+static const uint32_t rectangleObject = 2;
+static const float rectangleSize = 99.82014f;
+
+static bool check(const char *name, bool passed) {
+  printf("  %-24s %-32s %s\n", "flat geometry check", name,
+         passed ? "ok" : "FAILED");
+  return passed;
+}
+
+// Whether geometry holds just the rectangle: four plain points bounding it.
+static bool isRectangle(const FlatGeometry &geometry) {
+  if (geometry.pathCount() != 1 || geometry.vertexCount() != 4 ||
+      geometry.pathOffsets()[0] != 0 || geometry.pathOffsets()[1] != 4 ||
+      geometry.pathObjects()[0] != rectangleObject) {
+    return false;
+  }
+  float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+  for (size_t i = 0; i < geometry.vertexCount(); i++) {
+    if (geometry.verbs()[i] != (uint8_t)FlatVerb::point) {
+      return false;
+    }
+    const float *point = geometry.points() + i * FlatGeometry::pointStride;
+    minX = std::min(minX, point[0]);
+    minY = std::min(minY, point[1]);
+    maxX = std::max(maxX, point[0]);
+    maxY = std::max(maxY, point[1]);
+  }
+  float half = rectangleSize / 2.0f;
+  return fabsf(minX + half) < 0.01f && fabsf(minY + half) < 0.01f &&
+         fabsf(maxX - half) < 0.01f && fabsf(maxY - half) < 0.01f;
+}
+
+bool checkFlatGeometry() {
+  std::vector<uint8_t> bytes(rectangleFile,
+                             rectangleFile + sizeof(rectangleFile));
+  rive::File *file = nullptr;
+  auto reader = rive::BinaryReader(bytes.data(), bytes.size());
+  if (rive::File::import(reader, &file) != rive::ImportResult::success) {
+    return check("import", false);
+  }
+  rive::Artboard *artboard = file->artboard();
+  // Lays out the rectangle's vertices.
+  artboard->advance(0.0f);
+
+  FlatGeometry geometry;
+  geometry.flattenAll(artboard, false);
+  bool passed = check("all paths", isRectangle(geometry));
+  geometry.flattenAll(artboard, true);
+  passed = check("all paths, in the shape", isRectangle(geometry)) && passed;
+
+  // The shape isn't a path and there's no object 99; both are skipped.
+  uint32_t *selection = geometry.selection(3);
+  selection[0] = 1;
+  selection[1] = rectangleObject;
+  selection[2] = 99;
+  geometry.flattenSelection(artboard, 3, false);
+  passed = check("selection", isRectangle(geometry)) && passed;
+  geometry.flattenSelection(artboard, 1, false);
+  bool empty = geometry.pathCount() == 0 && geometry.vertexCount() == 0 &&
+               geometry.pathOffsets()[0] == 0;
+  passed = check("selection without paths", empty) && passed;
+
+  delete file;
+  return passed;
+}
+
+#else
+
+// Nothing to check in builds without FlatGeometry.
+bool checkFlatGeometry() { return true; }
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef _RIVE_FLAT_GEOMETRY_CHECK_HPP_
+#define _RIVE_FLAT_GEOMETRY_CHECK_HPP_
+
+// Imports a file whose only path is a rectangle and checks what FlatGeometry
+// reads from it, in full and from a selection of object indices: one path of
+// four plain points, packed at the right offsets, bounding the rectangle.
+// Only built with ENABLE_QUERY_FLAT_VERTICES. Prints a line per case and
+// returns whether all of them passed.
+bool checkFlatGeometry();
+
+#endif
@@ -0,0 +1,129 @@
+#include "kernel_check.hpp"
+#include "kernels.hpp"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+// Row lengths checked, each from 0 up.
+static const int maxCount = 37;
+
+static uint32_t seed = 1;
+
+static uint32_t random32() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed;
+}
+
+static float randomFloat(float min, float max) {
+  return min + (max - min) * (random32() >> 8) / (float)(1 << 24);
+}
+
+// Premultiplied, so that no channel exceeds alpha.
+static uint32_t randomColor() {
+  uint32_t a = random32() & 0xFF;
+  uint32_t color = a << 24;
+  for (int shift = 0; shift < 24; shift += 8) {
+    color |= (a == 0 ? 0 : random32() % (a + 1)) << shift;
+  }
+  return color;
+}
+
+static bool report(const char *name, int failures) {
+  printf("  %-24s %-24s %10d mismatches %s\n", "kernel check", name, failures,
+         failures == 0 ? "ok" : "FAILED");
+  return failures == 0;
+}
+
+static bool checkTransformPoints() {
+  int failures = 0;
+  for (int count = 0; count <= maxCount; count++) {
+    rive::Mat2D transform;
+    for (int i = 0; i < 6; i++) {
+      transform[i] = randomFloat(-4.0f, 4.0f);
+    }
+    std::vector<FlatPoint> points(count), out(count), expected(count);
+    for (auto &point : points) {
+      point = {randomFloat(-500.0f, 500.0f), randomFloat(-500.0f, 500.0f)};
+    }
+    PathBounds bounds =
+        transformPoints(transform, points.data(), count, out.data());
+    PathBounds expectedBounds = transformPointsScalar(
+        transform, points.data(), count, expected.data());
+    for (int i = 0; i < count; i++) {
+      failures += fabsf(out[i].x - expected[i].x) > 1e-3f ||
+                  fabsf(out[i].y - expected[i].y) > 1e-3f;
+    }
+    if (count > 0) {
+      failures += fabsf(bounds.minX - expectedBounds.minX) > 1e-3f ||
+                  fabsf(bounds.minY - expectedBounds.minY) > 1e-3f ||
+                  fabsf(bounds.maxX - expectedBounds.maxX) > 1e-3f ||
+                  fabsf(bounds.maxY - expectedBounds.maxY) > 1e-3f;
+    }
+  }
+  return report("transformPoints", failures);
+}
+
+static bool checkResolveCoverage() {
+  int failures = 0;
+  for (rive::FillRule fillRule :
+       {rive::FillRule::nonZero, rive::FillRule::evenOdd}) {
+    for (int count = 0; count <= maxCount; count++) {
+      std::vector<float> deltas(count), expectedDeltas(count);
+      for (float &delta : deltas) {
+        // Mostly empty, like a real row.
+        delta = random32() % 3 == 0 ? randomFloat(-2.0f, 2.0f) : 0.0f;
+      }
+      expectedDeltas = deltas;
+      std::vector<uint8_t> coverage(count), expected(count);
+      bool any = resolveCoverage(deltas.data(), count, fillRule,
+                                 coverage.data());
+      bool expectedAny = resolveCoverageScalar(
+          expectedDeltas.data(), count, fillRule, expected.data());
+      failures += any != expectedAny;
+      for (int i = 0; i < count; i++) {
+        // Rows are summed in a different order, so the lowest bit may
+        // differ.
+        failures += abs((int)coverage[i] - (int)expected[i]) > 1 ||
+                    deltas[i] != 0.0f;
+      }
+    }
+  }
+  return report("resolveCoverage", failures);
+}
+
+static bool checkBlendSrcOver() {
+  int failures = 0;
+  for (size_t step : {(size_t)0, (size_t)1}) {
+    for (int count = 0; count <= maxCount; count++) {
+      std::vector<uint32_t> colors(step == 0 ? 1 : count + 1);
+      for (auto &color : colors) {
+        color = randomColor();
+      }
+      std::vector<uint8_t> coverage(count);
+      for (auto &value : coverage) {
+        uint32_t pick = random32() % 4;
+        value = pick == 0 ? 0 : pick == 1 ? 255 : (uint8_t)random32();
+      }
+      std::vector<uint32_t> pixels(count), expected(count);
+      for (int i = 0; i < count; i++) {
+        pixels[i] = expected[i] = randomColor();
+      }
+      blendSrcOver((uint8_t *)pixels.data(), colors.data(), step,
+                   coverage.data(), count);
+      blendSrcOverScalar((uint8_t *)expected.data(), colors.data(), step,
+                         coverage.data(), count);
+      for (int i = 0; i < count; i++) {
+        failures += pixels[i] != expected[i];
+      }
+    }
+  }
+  return report("blendSrcOver", failures);
+}
+
+bool checkKernels() {
+  bool passed = checkTransformPoints();
+  passed = checkResolveCoverage() && passed;
+  passed = checkBlendSrcOver() && passed;
+  return passed;
+}
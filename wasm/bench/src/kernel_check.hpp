@@ -0,0 +1,11 @@
+#ifndef _RIVE_KERNEL_CHECK_HPP_
+#define _RIVE_KERNEL_CHECK_HPP_
+
+// Runs the software renderer's kernels and their scalar versions over the
+// same pseudo-random rows, of lengths covering the SIMD loops' tails, and
+// checks that they agree. Only the SIMD build has anything to compare; others
+// check the scalar versions against themselves. Prints a line per kernel and
+// returns whether all of them passed.
+bool checkKernels();
+
+#endif
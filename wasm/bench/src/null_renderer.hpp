@@ -0,0 +1,33 @@
+#ifndef _RIVE_NULL_RENDERER_HPP_
+#define _RIVE_NULL_RENDERER_HPP_
+
+#include "recording_render_path.hpp"
+#include "renderer.hpp"
+#include <stdint.h>
+
+// A Renderer that discards everything it's given. Paths are still recorded and
+// validated as they would be by the wasm backends, so drawing into it measures
+// the C++ side of a frame without any JS or canvas cost.
+class NullRenderer : public rive::Renderer {
+private:
+  uint32_t m_DrawCount = 0;
+  uint32_t m_ClipCount = 0;
+
+public:
+  void save() override {}
+  void restore() override {}
+  void transform(const rive::Mat2D &) override {}
+  void drawPath(rive::RenderPath *path, rive::RenderPaint *) override {
+    static_cast<RecordingRenderPath *>(path)->validate();
+    m_DrawCount++;
+  }
+  void clipPath(rive::RenderPath *path) override {
+    static_cast<RecordingRenderPath *>(path)->validate();
+    m_ClipCount++;
+  }
+
+  uint32_t drawCount() const { return m_DrawCount; }
+  uint32_t clipCount() const { return m_ClipCount; }
+};
+
+#endif
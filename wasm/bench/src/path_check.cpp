@@ -0,0 +1,48 @@
+#include "path_check.hpp"
+#include "recording_render_path.hpp"
+#include <stdio.h>
+
+static bool check(const char *name, uint32_t from, uint32_t to,
+                  bool expectedChange) {
+  bool passed = (from != to) == expectedChange;
+  printf("  %-24s %-32s %u -> %u %s\n", "path check", name, from, to,
+         passed ? "ok" : "FAILED");
+  return passed;
+}
+
+bool checkPaths() {
+  RecordingRenderPath path;
+  uint32_t version = path.validate();
+  path.moveTo(0, 0);
+  path.lineTo(10, 0);
+  bool passed = check("built without reset", version, path.validate(), true);
+
+  version = path.validate();
+  passed = check("validated again", version, path.validate(), false) && passed;
+
+  path.cubicTo(10, 5, 5, 10, 0, 10);
+  passed = check("cubic appended", version, path.validate(), true) && passed;
+
+  version = path.validate();
+  path.close();
+  passed = check("closed", version, path.validate(), true) && passed;
+
+  RecordingRenderPath sub;
+  sub.moveTo(0, 0);
+  sub.lineTo(1, 1);
+  version = path.validate();
+  path.addRenderPath(&sub, rive::Mat2D());
+  passed = check("sub path added", version, path.validate(), true) && passed;
+
+  // Rebuilding the same geometry leaves the version alone.
+  version = path.validate();
+  path.reset();
+  path.moveTo(0, 0);
+  path.lineTo(10, 0);
+  path.cubicTo(10, 5, 5, 10, 0, 10);
+  path.close();
+  path.addRenderPath(&sub, rive::Mat2D());
+  passed = check("rebuilt unchanged", version, path.validate(), false) &&
+           passed;
+  return passed;
+}
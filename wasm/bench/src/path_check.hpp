@@ -0,0 +1,10 @@
+#ifndef _RIVE_PATH_CHECK_HPP_
+#define _RIVE_PATH_CHECK_HPP_
+
+// Builds RecordingRenderPaths the way rive-cpp may, appending to a path
+// without resetting it first, and checks that each change bumps the version
+// while validating an unchanged path doesn't. Prints a line per case and
+// returns whether all of them passed.
+bool checkPaths();
+
+#endif
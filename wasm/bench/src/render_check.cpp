@@ -0,0 +1,138 @@
+#include "render_check.hpp"
+#include "software_renderer.hpp"
+#include <functional>
+#include <math.h>
+#include <stdio.h>
+
+static const float pi = 3.14159265358979f;
+static const int size = 32;
+
+// Covered areas may differ from the shapes' by this fraction of them, or by
+// this many pixels for shapes that cover nothing.
+static const float areaTolerance = 0.02f;
+static const float emptyTolerance = 0.01f;
+
+// Draws what build records into a path, opaque black, and returns the area
+// covered, in pixels, summed from the alpha of every pixel.
+static float coveredArea(const std::function<void(SoftwareRenderPath &)> &build,
+                         rive::RenderPaintStyle style, rive::FillRule fillRule,
+                         float thickness, rive::StrokeCap cap) {
+  SoftwareRenderer renderer(size, size);
+  renderer.clear(0);
+  SoftwareRenderPath path;
+  build(path);
+  path.fillRule(fillRule);
+  SoftwareRenderPaint paint;
+  paint.style(style);
+  paint.color(0xFF000000);
+  paint.thickness(thickness);
+  paint.cap(cap);
+  renderer.drawPath(&path, &paint);
+
+  const uint8_t *pixels = renderer.pixels();
+  float area = 0.0f;
+  for (size_t i = 3; i < renderer.byteLength(); i += 4) {
+    area += pixels[i] / 255.0f;
+  }
+  return area;
+}
+
+static bool check(const char *name, float area, float expected) {
+  float tolerance =
+      expected == 0.0f ? emptyTolerance : expected * areaTolerance;
+  bool passed = fabsf(area - expected) <= tolerance;
+  printf("  %-24s %-32s %8.2f px (expected %.2f) %s\n", "render check", name,
+         area, expected, passed ? "ok" : "FAILED");
+  return passed;
+}
+
+static float fill(const std::function<void(SoftwareRenderPath &)> &build,
+                  rive::FillRule fillRule = rive::FillRule::nonZero) {
+  return coveredArea(build, rive::RenderPaintStyle::fill, fillRule, 0.0f,
+                     rive::StrokeCap::butt);
+}
+
+static float stroke(const std::function<void(SoftwareRenderPath &)> &build,
+                    float thickness, rive::StrokeCap cap) {
+  return coveredArea(build, rive::RenderPaintStyle::stroke,
+                     rive::FillRule::nonZero, thickness, cap);
+}
+
+static void rectangle(SoftwareRenderPath &path, float minX, float minY,
+                      float maxX, float maxY) {
+  path.moveTo(minX, minY);
+  path.lineTo(maxX, minY);
+  path.lineTo(maxX, maxY);
+  path.lineTo(minX, maxY);
+  path.close();
+}
+
+// A zero-length line at the canvas' center.
+static void dot(SoftwareRenderPath &path) {
+  path.moveTo(16, 16);
+  path.lineTo(16, 16);
+}
+
+bool checkRendering() {
+  bool passed =
+      check("square", fill([](SoftwareRenderPath &path) {
+              rectangle(path, 4, 4, 20, 20);
+            }),
+            256.0f);
+  passed = check("square off the grid", fill([](SoftwareRenderPath &path) {
+                   rectangle(path, 4.5f, 4.25f, 20.5f, 20.25f);
+                 }),
+                 256.0f) &&
+           passed;
+
+  // Two squares wound the same way, one inside the other.
+  auto ring = [](SoftwareRenderPath &path) {
+    rectangle(path, 2, 2, 26, 26);
+    rectangle(path, 8, 8, 20, 20);
+  };
+  passed = check("nested nonZero", fill(ring), 576.0f) && passed;
+  passed = check("nested evenOdd", fill(ring, rive::FillRule::evenOdd),
+                 432.0f) &&
+           passed;
+
+  // Lines after a close continue from the closed contour's start: two
+  // triangles making up a square.
+  passed = check("lines after close", fill([](SoftwareRenderPath &path) {
+                   path.moveTo(4, 4);
+                   path.lineTo(20, 4);
+                   path.lineTo(20, 20);
+                   path.close();
+                   path.lineTo(20, 20);
+                   path.lineTo(4, 20);
+                 }),
+                 256.0f) &&
+           passed;
+
+  // Lines after an added path continue from its last point.
+  SoftwareRenderPath edge;
+  edge.moveTo(4, 4);
+  edge.lineTo(20, 4);
+  passed = check("lines after addPath", fill([&edge](SoftwareRenderPath &path) {
+                   path.addRenderPath(&edge, rive::Mat2D());
+                   path.lineTo(20, 20);
+                   path.lineTo(4, 20);
+                 }),
+                 128.0f) &&
+           passed;
+
+  passed = check("line", stroke([](SoftwareRenderPath &path) {
+                   path.moveTo(8, 16);
+                   path.lineTo(24, 16);
+                 }, 4, rive::StrokeCap::butt),
+                 64.0f) &&
+           passed;
+  passed = check("round dot", stroke(dot, 8, rive::StrokeCap::round),
+                 16.0f * pi) &&
+           passed;
+  passed = check("square dot", stroke(dot, 8, rive::StrokeCap::square),
+                 64.0f) &&
+           passed;
+  passed = check("butt dot", stroke(dot, 8, rive::StrokeCap::butt), 0.0f) &&
+           passed;
+  return passed;
+}
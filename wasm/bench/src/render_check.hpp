@@ -0,0 +1,11 @@
+#ifndef _RIVE_RENDER_CHECK_HPP_
+#define _RIVE_RENDER_CHECK_HPP_
+
+// Draws paths with the SoftwareRenderer and compares the area of the pixels
+// they cover with that of the shapes they describe: fills under both fill
+// rules, edges off the pixel grid, lines continuing after a close or an added
+// path, and zero-length strokes, which round and square caps draw as dots.
+// Prints a line per case and returns whether all of them passed.
+bool checkRendering();
+
+#endif
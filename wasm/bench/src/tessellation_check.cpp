@@ -0,0 +1,151 @@
+#include "tessellation_check.hpp"
+#include "flat_path.hpp"
+#include "tessellator.hpp"
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+static const float pi = 3.14159265358979f;
+
+// Areas may differ by this fraction of the expected one, and triangles may
+// share this much of an edge, in pixels, without counting as overlapping.
+static const float areaTolerance = 1e-3f;
+static const float overlapTolerance = 1e-3f;
+
+static float polygonArea(const std::vector<FlatPoint> &points) {
+  float area = 0.0f;
+  for (size_t i = 0; i < points.size(); i++) {
+    const FlatPoint &a = points[i];
+    const FlatPoint &b = points[(i + 1) % points.size()];
+    area += a.x * b.y - b.x * a.y;
+  }
+  return fabsf(area) * 0.5f;
+}
+
+// count points around (x, y), every step of them, starting straight up.
+static std::vector<FlatPoint> polygon(float x, float y, float radius,
+                                      int count, int step) {
+  std::vector<FlatPoint> points;
+  for (int i = 0; i < count; i++) {
+    float angle = -pi / 2.0f + 2.0f * pi * i * step / count;
+    points.push_back({x + radius * cosf(angle), y + radius * sinf(angle)});
+  }
+  return points;
+}
+
+static void addContour(FlatPath &path, const std::vector<FlatPoint> &points) {
+  path.moveTo(points[0].x, points[0].y);
+  for (size_t i = 1; i < points.size(); i++) {
+    path.lineTo(points[i].x, points[i].y);
+  }
+  path.close();
+}
+
+struct Triangle {
+  FlatPoint points[3];
+};
+
+// Whether the interiors of two triangles intersect: they don't if any of
+// their edges' normals separates them.
+static bool overlap(const Triangle &a, const Triangle &b) {
+  for (const Triangle *triangle : {&a, &b}) {
+    for (int i = 0; i < 3; i++) {
+      const FlatPoint &p0 = triangle->points[i];
+      const FlatPoint &p1 = triangle->points[(i + 1) % 3];
+      float nx = p0.y - p1.y, ny = p1.x - p0.x;
+      float length = sqrtf(nx * nx + ny * ny);
+      if (length == 0.0f) {
+        continue;
+      }
+      float minA = INFINITY, maxA = -INFINITY;
+      float minB = INFINITY, maxB = -INFINITY;
+      for (int j = 0; j < 3; j++) {
+        float pa = (a.points[j].x * nx + a.points[j].y * ny) / length;
+        float pb = (b.points[j].x * nx + b.points[j].y * ny) / length;
+        minA = std::min(minA, pa);
+        maxA = std::max(maxA, pa);
+        minB = std::min(minB, pb);
+        maxB = std::max(maxB, pb);
+      }
+      if (maxA <= minB + overlapTolerance || maxB <= minA + overlapTolerance) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static bool check(const char *name, const FlatPath &path,
+                  rive::FillRule fillRule, float expectedArea) {
+  Tessellator tessellator;
+  std::vector<float> vertices;
+  std::vector<uint32_t> indices;
+  tessellator.fill(path, fillRule, flatness, vertices, indices);
+
+  std::vector<Triangle> triangles;
+  float area = 0.0f;
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    Triangle triangle;
+    for (int j = 0; j < 3; j++) {
+      triangle.points[j] = {vertices[indices[i + j] * 2],
+                            vertices[indices[i + j] * 2 + 1]};
+    }
+    float triangleArea = polygonArea({triangle.points[0], triangle.points[1],
+                                      triangle.points[2]});
+    // Slivers where trapezoids narrow to a point cover nothing.
+    if (triangleArea > 0.0f) {
+      area += triangleArea;
+      triangles.push_back(triangle);
+    }
+  }
+
+  size_t overlaps = 0;
+  for (size_t i = 0; i < triangles.size(); i++) {
+    for (size_t j = i + 1; j < triangles.size(); j++) {
+      overlaps += overlap(triangles[i], triangles[j]);
+    }
+  }
+
+  bool passed = fabsf(area - expectedArea) <= expectedArea * areaTolerance &&
+                overlaps == 0;
+  printf("  %-24s %-24s %10.1f of %10.1f area, %zu overlaps %s\n",
+         "tessellation check", name, area, expectedArea, overlaps,
+         passed ? "ok" : "FAILED");
+  return passed;
+}
+
+bool checkTessellation() {
+  bool passed = true;
+
+  // A convex octagon, fanned from its first point.
+  auto octagon = polygon(100.0f, 100.0f, 80.0f, 8, 1);
+  FlatPath convex;
+  addContour(convex, octagon);
+  float octagonArea = polygonArea(octagon);
+  passed = check("convex fan", convex, rive::FillRule::nonZero, octagonArea) &&
+           passed;
+
+  // A self intersecting pentagram: its inner pentagon winds twice, so
+  // nonZero fills it while evenOdd leaves it empty.
+  float radius = 80.0f;
+  float innerRadius = radius * cosf(2.0f * pi / 5.0f) / cosf(pi / 5.0f);
+  auto outer = polygon(100.0f, 100.0f, radius, 5, 1);
+  auto inner = polygon(100.0f, 100.0f, innerRadius, 5, 1);
+  std::vector<FlatPoint> outline;
+  for (size_t i = 0; i < 5; i++) {
+    outline.push_back(outer[i]);
+    // Inner points sit between the outer ones, opposite them.
+    outline.push_back(inner[(i + 3) % 5]);
+  }
+  FlatPath star;
+  addContour(star, polygon(100.0f, 100.0f, radius, 5, 2));
+  float starArea = polygonArea(outline);
+  float pentagonArea = polygonArea(inner);
+  passed = check("star nonZero", star, rive::FillRule::nonZero, starArea) &&
+           passed;
+  passed = check("star evenOdd", star, rive::FillRule::evenOdd,
+                 starArea - pentagonArea) &&
+           passed;
+  return passed;
+}
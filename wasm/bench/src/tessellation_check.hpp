@@ -0,0 +1,9 @@
+#ifndef _RIVE_TESSELLATION_CHECK_HPP_
+#define _RIVE_TESSELLATION_CHECK_HPP_
+
+// Tessellates a few shapes with known filled areas, under both fill rules,
+// and checks that the triangles add up to those areas without overlapping.
+// Prints a line per shape and returns whether all of them passed.
+bool checkTessellation();
+
+#endif
@@ -0,0 +1,96 @@
+#include "thread_pool_check.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <memory>
+#include <stdio.h>
+
+static bool check(const char *name, size_t threads, bool passed) {
+  char label[64];
+  snprintf(label, sizeof(label), "%s, %zu threads", name, threads);
+  printf("  %-24s %-32s %s\n", "thread pool check", label,
+         passed ? "ok" : "FAILED");
+  return passed;
+}
+
+// Runs a loop of count iterations and checks that each index was visited
+// once by the time parallelFor returned.
+static bool visitsEachOnce(ThreadPool &pool, size_t count, size_t grain) {
+  std::unique_ptr<std::atomic<int>[]> visits(new std::atomic<int>[count]);
+  for (size_t i = 0; i < count; i++) {
+    visits[i] = 0;
+  }
+  pool.parallelFor(count, grain, [&visits](size_t index) { visits[index]++; });
+  for (size_t i = 0; i < count; i++) {
+    if (visits[i] != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Busy work growing with index, so that some chunks take far longer than
+// others and idle threads have to steal.
+static uint32_t unevenWork(size_t index) {
+  uint32_t value = (uint32_t)index;
+  for (size_t i = 0; i < index * 1000; i++) {
+    value = value * 1664525u + 1013904223u;
+  }
+  return value;
+}
+
+static bool checkPool(size_t threads) {
+  ThreadPool pool(threads);
+#ifdef RIVE_USE_THREADS
+  bool passed = check("thread count", threads, pool.threadCount() == threads);
+#else
+  // Builds without threads run every loop on the caller.
+  bool passed = check("thread count", threads, pool.threadCount() == 0);
+#endif
+  passed = check("every index once", threads,
+                 visitsEachOnce(pool, 1000, 7) &&
+                     visitsEachOnce(pool, 1000, 0)) &&
+           passed;
+  passed = check("small loops", threads,
+                 visitsEachOnce(pool, 0, 4) && visitsEachOnce(pool, 1, 4) &&
+                     visitsEachOnce(pool, 3, 8)) &&
+           passed;
+
+  std::atomic<uint64_t> sum{0};
+  uint64_t expected = 0;
+  for (size_t i = 0; i < 64; i++) {
+    expected += unevenWork(i);
+  }
+  pool.parallelFor(64, 1, [&sum](size_t index) { sum += unevenWork(index); });
+  passed = check("uneven work", threads, sum == expected) && passed;
+
+  bool finished = true;
+  for (int loop = 0; loop < 200 && finished; loop++) {
+    std::atomic<size_t> calls{0};
+    pool.parallelFor(32, 4, [&calls](size_t) { calls++; });
+    finished = calls == 32;
+  }
+  passed = check("repeated loops", threads, finished) && passed;
+  return passed;
+}
+
+bool checkThreadPool() {
+  bool passed = true;
+  for (size_t threads : {0, 1, 4}) {
+    passed = checkPool(threads) && passed;
+  }
+
+  // Reaching the end of each iteration means the destructor joined every
+  // worker, whether or not they ever woke up for a loop.
+  for (int i = 0; i < 50; i++) {
+    ThreadPool idle(4);
+  }
+  bool finished = true;
+  for (int i = 0; i < 50 && finished; i++) {
+    ThreadPool pool(4);
+    std::atomic<size_t> calls{0};
+    pool.parallelFor(100, 1, [&calls](size_t) { calls++; });
+    finished = calls == 100;
+  }
+  passed = check("shutdown", 4, finished) && passed;
+  return passed;
+}
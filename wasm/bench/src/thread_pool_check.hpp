@@ -0,0 +1,11 @@
+#ifndef _RIVE_THREAD_POOL_CHECK_HPP_
+#define _RIVE_THREAD_POOL_CHECK_HPP_
+
+// Runs loops on thread pools of a few sizes and checks that parallelFor calls
+// the job exactly once per index, small loops included, and only returns once
+// every call finished, loop after loop; then starts and destroys pools, idle
+// or straight after a loop, which must shut down without hanging. Prints a
+// line per case and returns whether all of them passed.
+bool checkThreadPool();
+
+#endif
@@ -3,11 +3,12 @@
 OUTPUT_DIR=bin/release
 
 if [ $# -ne 1 ]; then
-    echo "usage: build.sh <es6|es5|es6pure|es5pure>"
+    echo "usage: build.sh <es6|es5|es6pure|es5pure|es6threads|es6simd|tools>"
     exit 1
 fi
 
 CFLAGS=
+THREADS=0
 
 if [ "$1" == "es6" ]; then
     FILE_EXTENSION=mjs
@@ -17,6 +18,21 @@ elif [ "$1" == "es5" ]; then
     FILE_EXTENSION=js
     OUTPUT_FILE=rive
     WASM=1
+elif [ "$1" == "es6threads" ]; then
+    # Advances artboards on a pool of web workers; needs SharedArrayBuffer,
+    # so the page must be cross-origin isolated.
+    FILE_EXTENSION=mjs
+    OUTPUT_FILE=rive.threads
+    WASM=1
+    THREADS=1
+    CFLAGS="-DRIVE_USE_THREADS -pthread -s USE_PTHREADS=1 -s PTHREAD_POOL_SIZE=navigator.hardwareConcurrency"
+elif [ "$1" == "es6simd" ]; then
+    # Vectorizes the software renderer's kernels with wasm SIMD. Glue and
+    # wasm come from this one link, like every other build.
+    FILE_EXTENSION=mjs
+    OUTPUT_FILE=rive.simd
+    WASM=1
+    CFLAGS=-msimd128
 elif [ "$1" == "tools" ]; then
     FILE_EXTENSION=mjs
     OUTPUT_FILE=rive.tools.pure
@@ -31,7 +47,7 @@ elif [ "$1" == "es5pure" ]; then
     OUTPUT_FILE=rive.pure
     WASM=0
 else
-    echo "incorrect type: build.sh <es6|es5|es6pure|es5pure|tools>"
+    echo "incorrect type: build.sh <es6|es5|es6pure|es5pure|es6threads|es6simd|tools>"
     exit 1
 fi
 
@@ -59,6 +75,8 @@ em++ -Oz \
     -s USE_ES6_IMPORT_META=0 \
     -s EXPORT_NAME="Rive" \
     $CFLAGS \
+    -DRIVE_ARENA_GUARD_STATICS \
+    -Wl,--wrap=__cxa_guard_acquire,--wrap=__cxa_guard_release,--wrap=__cxa_guard_abort \
     -DEMSCRIPTEN_HAS_UNBOUND_TYPE_NAMES=0 \
     -DSINGLE \
     -DANSI_DECLARATORS \
@@ -78,7 +96,7 @@ em++ -Oz \
     ../submodules/rive-cpp/src/*.cpp \
     ../submodules/rive-cpp/src/core/field_types/*.cpp \
     ../submodules/rive-cpp/src/shapes/paint/*.cpp \
-    ../src/bindings.cpp
+    ../src/*.cpp
 
 awk 'NR==FNR { a[n++]=$0; next }
 /console\.log\("--REPLACE WITH RENDERING CODE--"\);/ { for (i=0;i<n;++i) print a[i]; next }
@@ -95,6 +113,9 @@ terser --compress --mangle -o ./bin/release/$OUTPUT_FILE.min.$FILE_EXTENSION --
 # copy to publish folder
 cp ./bin/release/rive-combined.$FILE_EXTENSION ../publish/$OUTPUT_FILE.$FILE_EXTENSION
 cp ./bin/release/$OUTPUT_FILE.min.$FILE_EXTENSION ../publish/$OUTPUT_FILE.min.$FILE_EXTENSION
+if [ "$THREADS" == "1" ]; then
+    cp ./bin/release/$OUTPUT_FILE.worker.js ../publish/$OUTPUT_FILE.worker.js
+fi
 # cp ./bin/release/rive.wasm ../publish/rive.wasm
 # cp ./bin/release/rive_wasm.js ../publish/rive_wasm.js
 
@@ -7,5 +7,9 @@ echo Building ES6 PURE
 ./build-js.sh es6pure
 echo Building ES5 PURE
 ./build-js.sh es5pure
+echo Building ES6 THREADS
+./build-js.sh es6threads
+echo Building ES6 SIMD
+./build-js.sh es6simd
 echo Building wasm
 ./build-wasm.sh
\ No newline at end of file
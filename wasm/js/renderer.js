@@ -16,6 +16,12 @@ Module.onRuntimeInitialized = function () {
         RenderPath,
         RenderPaint,
         Renderer,
+        CommandBufferRenderer,
+        CommandBufferRenderPath,
+        CommandBufferRenderPaint,
+        SoftwareRenderPath,
+        SoftwareRenderPaint,
+        FileImporter,
         StrokeCap,
         StrokeJoin,
         BlendMode
@@ -31,6 +37,54 @@ Module.onRuntimeInitialized = function () {
         nonZero
     } = FillRule;
 
+    // Path verbs recorded in wasm memory; these must match
+    // recording_render_path.hpp.
+    const VERB_MOVE = 0;
+    const VERB_LINE = 1;
+    const VERB_CUBIC = 2;
+    const VERB_CLOSE = 3;
+    const VERB_ADD_PATH = 4;
+
+    // Appends the verbs in words[i, end) to path2D, resolving sub paths added
+    // by id through paths. Returns the index after the last verb read.
+    function _appendVerbs(path2D, words, floats, i, end, paths) {
+        while (i < end) {
+            switch (words[i++]) {
+                case VERB_MOVE:
+                    path2D.moveTo(floats[i], floats[i + 1]);
+                    i += 2;
+                    break;
+                case VERB_LINE:
+                    path2D.lineTo(floats[i], floats[i + 1]);
+                    i += 2;
+                    break;
+                case VERB_CUBIC:
+                    path2D.bezierCurveTo(floats[i], floats[i + 1], floats[i + 2],
+                        floats[i + 3], floats[i + 4], floats[i + 5]);
+                    i += 6;
+                    break;
+                case VERB_CLOSE:
+                    path2D.closePath();
+                    break;
+                case VERB_ADD_PATH: {
+                    const m = new DOMMatrix();
+                    m.a = floats[i + 1];
+                    m.b = floats[i + 2];
+                    m.c = floats[i + 3];
+                    m.d = floats[i + 4];
+                    m.e = floats[i + 5];
+                    m.f = floats[i + 6];
+                    path2D.addPath(paths[words[i]].path2D, m);
+                    i += 7;
+                    break;
+                }
+            }
+        }
+        return i;
+    }
+
+    // Geometry is recorded on the C++ side and only handed over when it
+    // changed, so an unchanged path keeps its Path2D across frames.
     var CanvasRenderPath = RenderPath.extend("CanvasRenderPath", {
         __construct: function () {
             this.__parent.__construct.call(this);
@@ -45,113 +99,248 @@ Module.onRuntimeInitialized = function () {
         fillRule: function(fillRule) {
             this._fillRule = fillRule;
         },
-        moveTo: function (x, y) {
-            this._path2D.moveTo(x, y);
+        addCommands: function (words) {
+            const floats = new Float32Array(words.buffer, words.byteOffset,
+                words.length);
+            _appendVerbs(this._path2D, words, floats, 0, words.length, null);
+        }
+    });
+
+    // Bounds of the caches below, which evict their oldest entries first.
+    const COLOR_CACHE_SIZE = 1024;
+    const GRADIENT_CACHE_SIZE = 64;
+
+    function _cacheSet(cache, limit, key, value) {
+        if (cache.size >= limit) {
+            cache.delete(cache.keys().next().value);
+        }
+        cache.set(key, value);
+    }
+
+    // Style strings by ARGB color value.
+    const _colorStyles = new Map();
+
+    function _colorStyle(value) {
+        let style = _colorStyles.get(value);
+        if (style === undefined) {
+            style = 'rgba(' + ((0x00ff0000 & value) >>>
+                    16) + ',' + ((0x0000ff00 &
+                    value) >>> 8) + ',' + ((0x000000ff & value) >>> 0) + ',' +
+                (((0xff000000 & value) >>> 24) / 0xFF) + ')';
+            _cacheSet(_colorStyles, COLOR_CACHE_SIZE, value, style);
+        }
+        return style;
+    }
+
+    // CanvasGradients by context, keyed on their type, geometry and stops as
+    // built by _gradientKey. Animated gradients often cycle through the same
+    // few, and building one formats a style string per stop.
+    const _gradientCaches = new WeakMap();
+
+    function _gradientKey(isRadial, sx, sy, ex, ey) {
+        return (isRadial ? 'r' : 'l') + sx + ',' + sy + ',' + ex + ',' + ey;
+    }
+
+    function _stopKey(color, stop) {
+        return ';' + color + ',' + stop;
+    }
+
+    function _cachedGradient(ctx, key) {
+        const cache = _gradientCaches.get(ctx);
+        return cache === undefined ? undefined : cache.get(key);
+    }
+
+    // Makes a gradient without stops and caches it under key; the caller adds
+    // the stops.
+    function _makeGradient(ctx, key, isRadial, sx, sy, ex, ey) {
+        let gradient;
+        if (isRadial) {
+            const dx = ex - sx;
+            const dy = ey - sy;
+            const radius = Math.sqrt(dx * dx + dy * dy);
+            gradient = ctx.createRadialGradient(sx, sy, 0, sx, sy, radius);
+        } else {
+            gradient = ctx.createLinearGradient(sx, sy, ex, ey);
+        }
+        let cache = _gradientCaches.get(ctx);
+        if (cache === undefined) {
+            cache = new Map();
+            _gradientCaches.set(ctx, cache);
+        }
+        _cacheSet(cache, GRADIENT_CACHE_SIZE, key, gradient);
+        return gradient;
+    }
+
+    // The paint state a renderer last set on its context, so that draws only
+    // set what changed. Values are what the renderer assigned (the context
+    // may normalize them), null when unknown. It follows the renderer's own
+    // saves and restores, but only holds until the next flush: the context
+    // may be changed by anything else between frames.
+    const STATE_SIZE = 6;
+
+    function _ContextState() {
+        this._saved = [];
+        this._depth = 0;
+        this.reset();
+    }
+
+    _ContextState.prototype = {
+        // Forgets everything, including what open saves would restore.
+        reset: function () {
+            this._saved.fill(null);
+            this.blend = null;
+            this.fillStyle = null;
+            this.strokeStyle = null;
+            this.lineWidth = null;
+            this.lineCap = null;
+            this.lineJoin = null;
+        },
+        save: function () {
+            const saved = this._saved;
+            const i = this._depth++ * STATE_SIZE;
+            saved[i] = this.blend;
+            saved[i + 1] = this.fillStyle;
+            saved[i + 2] = this.strokeStyle;
+            saved[i + 3] = this.lineWidth;
+            saved[i + 4] = this.lineCap;
+            saved[i + 5] = this.lineJoin;
+        },
+        restore: function () {
+            if (this._depth === 0) {
+                this.reset();
+                return;
+            }
+            const saved = this._saved;
+            const i = --this._depth * STATE_SIZE;
+            this.blend = saved[i];
+            this.fillStyle = saved[i + 1];
+            this.strokeStyle = saved[i + 2];
+            this.lineWidth = saved[i + 3];
+            this.lineCap = saved[i + 4];
+            this.lineJoin = saved[i + 5];
         },
-        lineTo: function (x, y) {
-            this._path2D.lineTo(x, y);
+        setBlend: function (ctx, blend) {
+            if (this.blend !== blend) {
+                ctx.globalCompositeOperation = blend;
+                this.blend = blend;
+            }
         },
-        cubicTo: function (ox, oy, ix, iy, x, y) {
-            this._path2D.bezierCurveTo(ox, oy, ix, iy, x, y);
+        setFill: function (ctx, style) {
+            if (this.fillStyle !== style) {
+                ctx.fillStyle = style;
+                this.fillStyle = style;
+            }
         },
-        close: function () {
-            this._path2D.closePath();
+        setStroke: function (ctx, style, width, cap, join) {
+            if (this.strokeStyle !== style) {
+                ctx.strokeStyle = style;
+                this.strokeStyle = style;
+            }
+            if (this.lineWidth !== width) {
+                ctx.lineWidth = width;
+                this.lineWidth = width;
+            }
+            if (this.lineCap !== cap) {
+                ctx.lineCap = cap;
+                this.lineCap = cap;
+            }
+            if (this.lineJoin !== join) {
+                ctx.lineJoin = join;
+                this.lineJoin = join;
+            }
         }
-    });
+    };
 
-    function _colorStyle(value) {
-        return 'rgba(' + ((0x00ff0000 & value) >>>
-                16) + ',' + ((0x0000ff00 &
-                value) >>> 8) + ',' + ((0x000000ff & value) >>> 0) + ',' +
-            (((0xff000000 & value) >>> 24) / 0xFF) + ')'
+    function _joinName(value) {
+        switch (value) {
+            case StrokeJoin.miter:
+                return 'miter';
+            case StrokeJoin.round:
+                return 'round';
+            case StrokeJoin.bevel:
+                return 'bevel';
+        }
     }
+
+    function _capName(value) {
+        switch (value) {
+            case StrokeCap.butt:
+                return 'butt';
+            case StrokeCap.round:
+                return 'round';
+            case StrokeCap.square:
+                return 'square';
+        }
+    }
+
+    function _blendName(value) {
+        switch (value) {
+            case BlendMode.srcOver:
+                return 'source-over';
+            case BlendMode.screen:
+                return 'screen';
+            case BlendMode.overlay:
+                return 'overlay';
+            case BlendMode.darken:
+                return 'darken';
+            case BlendMode.lighten:
+                return 'lighten';
+            case BlendMode.colorDodge:
+                return 'color-dodge';
+            case BlendMode.colorBurn:
+                return 'color-burn';
+            case BlendMode.hardLight:
+                return 'hard-light';
+            case BlendMode.softLight:
+                return 'soft-light';
+            case BlendMode.difference:
+                return 'difference';
+            case BlendMode.exclusion:
+                return 'exclusion';
+            case BlendMode.multiply:
+                return 'multiply';
+            case BlendMode.hue:
+                return 'hue';
+            case BlendMode.saturation:
+                return 'saturation';
+            case BlendMode.color:
+                return 'color';
+            case BlendMode.luminosity:
+                return 'luminosity';
+        }
+    }
+
+    // Only sent parameters that changed (see RenderPaintWrapper), so it starts
+    // out with the same defaults as RecordingRenderPaint.
     var CanvasRenderPaint = RenderPaint.extend("CanvasRenderPaint", {
+        __construct: function () {
+            this.__parent.__construct.call(this);
+            this._value = _colorStyle(0xFF000000);
+            this._thickness = 1;
+            this._join = 'miter';
+            this._cap = 'butt';
+            this._style = fill;
+            this._blend = 'source-over';
+            this._gradient = null;
+        },
         color: function (value) {
             this._value = _colorStyle(value);
+            this._gradient = null;
         },
         thickness: function (value) {
             this._thickness = value;
         },
         join: function (value) {
-            switch (value) {
-                case StrokeJoin.miter:
-                    this._join = 'miter';
-                    break;
-                case StrokeJoin.round:
-                    this._join = 'round';
-                    break;
-                case StrokeJoin.bevel:
-                    this._join = 'bevel';
-                    break;
-            }
+            this._join = _joinName(value);
         },
         cap: function (value) {
-            switch (value) {
-                case StrokeCap.butt:
-                    this._cap = 'butt';
-                    break;
-                case StrokeCap.round:
-                    this._cap = 'round';
-                    break;
-                case StrokeCap.square:
-                    this._cap = 'square';
-                    break;
-            }
+            this._cap = _capName(value);
         },
         style: function (value) {
             this._style = value;
         },
         blendMode: function (value) {
-            switch (value) {
-                case BlendMode.srcOver:
-                    this._blend = 'source-over';
-                    break;
-                case BlendMode.screen:
-                    this._blend = 'screen';
-                    break;
-                case BlendMode.overlay:
-                    this._blend = 'overlay';
-                    break;
-                case BlendMode.darken:
-                    this._blend = 'darken';
-                    break;
-                case BlendMode.lighten:
-                    this._blend = 'lighten';
-                    break;
-                case BlendMode.colorDodge:
-                    this._blend = 'color-dodge';
-                    break;
-                case BlendMode.colorBurn:
-                    this._blend = 'color-burn';
-                    break;
-                case BlendMode.hardLight:
-                    this._blend = 'hard-light';
-                    break;
-                case BlendMode.softLight:
-                    this._blend = 'soft-light';
-                    break;
-                case BlendMode.difference:
-                    this._blend = 'difference';
-                    break;
-                case BlendMode.exclusion:
-                    this._blend = 'exclusion';
-                    break;
-                case BlendMode.multiply:
-                    this._blend = 'multiply';
-                    break;
-                case BlendMode.hue:
-                    this._blend = 'hue';
-                    break;
-                case BlendMode.saturation:
-                    this._blend = 'saturation';
-                    break;
-                case BlendMode.color:
-                    this._blend = 'color';
-                    break;
-                case BlendMode.luminosity:
-                    this._blend = 'luminosity';
-                    break;
-            }
+            this._blend = _blendName(value);
         },
         linearGradient: function (sx, sy, ex, ey) {
             this._gradient = {
@@ -159,7 +348,9 @@ Module.onRuntimeInitialized = function () {
                 sy,
                 ex,
                 ey,
-                stops: []
+                stops: [],
+                key: _gradientKey(false, sx, sy, ex, ey),
+                ctx: null
             };
         },
         radialGradient: function (sx, sy, ex, ey) {
@@ -169,7 +360,9 @@ Module.onRuntimeInitialized = function () {
                 ex,
                 ey,
                 stops: [],
-                isRadial: true
+                isRadial: true,
+                key: _gradientKey(true, sx, sy, ex, ey),
+                ctx: null
             };
         },
         addStop: function (color, stop) {
@@ -177,13 +370,16 @@ Module.onRuntimeInitialized = function () {
                 color,
                 stop
             });
+            this._gradient.key += _stopKey(color, stop);
         },
 
         completeGradient: function () {
 
         },
 
-        draw: function (ctx, path) {
+        // The gradient is resolved to a CanvasGradient of ctx on the first
+        // draw after it changed, or when drawn to another context.
+        draw: function (ctx, state, path) {
             let {
                 _style,
                 _value,
@@ -191,76 +387,222 @@ Module.onRuntimeInitialized = function () {
                 _blend
             } = this;
 
-            ctx.globalCompositeOperation = _blend;
+            state.setBlend(ctx, _blend);
 
-            if (_gradient != null) {
+            if (_gradient != null && _gradient.ctx !== ctx) {
                 const {
                     sx,
                     sy,
                     ex,
                     ey,
                     stops,
-                    isRadial
+                    isRadial,
+                    key
                 } = _gradient;
 
-                if (isRadial) {
-                    var dx = ex - sx;
-                    var dy = ey - sy;
-                    var radius = Math.sqrt(dx * dx + dy * dy);
-                    _value = ctx.createRadialGradient(sx, sy, 0, sx, sy, radius);
-                } else {
-                    _value = ctx.createLinearGradient(sx, sy, ex, ey);
-                }
-
-                for (const {
-                        stop,
-                        color
-                    } of stops) {
-                    _value.addColorStop(stop, _colorStyle(color));
+                _value = _cachedGradient(ctx, key);
+                if (_value === undefined) {
+                    _value = _makeGradient(ctx, key, isRadial, sx, sy, ex, ey);
+                    for (const {
+                            stop,
+                            color
+                        } of stops) {
+                        _value.addColorStop(stop, _colorStyle(color));
+                    }
                 }
                 this._value = _value;
-                this._gradient = null;
+                _gradient.ctx = ctx;
             }
             switch (_style) {
                 case stroke:
-                    ctx.strokeStyle = _value;
-                    ctx.lineWidth = this._thickness;
-                    ctx.lineCap = this._cap;
-                    ctx.lineJoin = this._join;
+                    state.setStroke(ctx, _value, this._thickness, this._cap,
+                        this._join);
                     ctx.stroke(path._path2D);
                     break;
                 case fill:
-                    ctx.fillStyle = _value;
+                    state.setFill(ctx, _value);
                     ctx.fill(path._path2D, path._fillRule === evenOdd ? 'evenodd' : 'nonzero');
                     break;
             }
         }
     });
 
+    // Draws straight into the context, tracking its paint state across
+    // frames until the next flush.
     Module.CanvasRenderer = Renderer.extend("Renderer", {
         __construct: function (ctx) {
             this.__parent.__construct.call(this);
             this._ctx = ctx;
+            this._state = new _ContextState();
+        },
+        // Ends a frame: whatever draws on the context until the next one may
+        // change its paint state, so the next draws set it all again.
+        flush: function () {
+            this._state.reset();
         },
         save: function () {
             this._ctx.save();
+            this._state.save();
         },
         restore: function () {
             this._ctx.restore();
+            this._state.restore();
         },
         transform: function (matrix) {
             this._ctx.transform(matrix.xx, matrix.xy, matrix.yx, matrix.yy, matrix.tx,
                 matrix.ty);
         },
         drawPath: function (path, paint) {
-            paint.draw(this._ctx, path);
+            paint.draw(this._ctx, this._state, path);
         },
         clipPath: function (path) {
             this._ctx.clip(path._path2D, path._fillRule === evenOdd ? 'evenodd' : 'nonzero');
         }
     });
 
-    Module.renderFactory = {
+    // Opcodes written by CommandBufferRenderer; these must match
+    // command_buffer_renderer.hpp.
+    const OP_SAVE = 0;
+    const OP_RESTORE = 1;
+    const OP_TRANSFORM = 2;
+    const OP_DRAW_PATH = 3;
+    const OP_CLIP_PATH = 4;
+    const OP_UPDATE_PATH = 5;
+    const OP_UPDATE_PAINT = 6;
+
+    const GRADIENT_NONE = 0;
+    const GRADIENT_RADIAL = 2;
+
+    function _fillRuleName(value) {
+        return value === evenOdd.value ? 'evenodd' : 'nonzero';
+    }
+
+    // Renders the command stream recorded by a CommandBufferRenderer into a
+    // canvas 2D context. Paths and paints are cached by id across frames;
+    // paint state is tracked within a flush.
+    Module.CanvasCommandBufferRenderer = CommandBufferRenderer.extend(
+        "CanvasCommandBufferRenderer", {
+            __construct: function (ctx) {
+                this.__parent.__construct.call(this);
+                this._ctx = ctx;
+                this._paths = [];
+                this._paints = [];
+                this._state = new _ContextState();
+            },
+            // Replays and then discards everything recorded since the last
+            // flush.
+            flush: function () {
+                const words = this.commands();
+                const floats = new Float32Array(words.buffer, words.byteOffset,
+                    words.length);
+                const ctx = this._ctx;
+                const paths = this._paths;
+                const paints = this._paints;
+                const state = this._state;
+                const length = words.length;
+                state.reset();
+                let i = 0;
+                while (i < length) {
+                    switch (words[i++]) {
+                        case OP_SAVE:
+                            ctx.save();
+                            state.save();
+                            break;
+                        case OP_RESTORE:
+                            ctx.restore();
+                            state.restore();
+                            break;
+                        case OP_TRANSFORM:
+                            ctx.transform(floats[i], floats[i + 1], floats[i + 2],
+                                floats[i + 3], floats[i + 4], floats[i + 5]);
+                            i += 6;
+                            break;
+                        case OP_DRAW_PATH: {
+                            const path = paths[words[i]];
+                            const paint = paints[words[i + 1]];
+                            i += 2;
+                            state.setBlend(ctx, paint.blend);
+                            if (paint.style === stroke.value) {
+                                state.setStroke(ctx, paint.value, paint.thickness,
+                                    paint.cap, paint.join);
+                                ctx.stroke(path.path2D);
+                            } else {
+                                state.setFill(ctx, paint.value);
+                                ctx.fill(path.path2D, path.fillRule);
+                            }
+                            break;
+                        }
+                        case OP_CLIP_PATH: {
+                            const path = paths[words[i++]];
+                            ctx.clip(path.path2D, path.fillRule);
+                            break;
+                        }
+                        case OP_UPDATE_PATH:
+                            i = this._updatePath(words, floats, i);
+                            break;
+                        case OP_UPDATE_PAINT:
+                            i = this._updatePaint(words, floats, i);
+                            break;
+                    }
+                }
+                this.clear();
+            },
+            _updatePath: function (words, floats, i) {
+                const id = words[i];
+                const fillRule = _fillRuleName(words[i + 1]);
+                const end = i + 3 + words[i + 2];
+                const path2D = new Path2D();
+                _appendVerbs(path2D, words, floats, i + 3, end, this._paths);
+                this._paths[id] = {
+                    path2D,
+                    fillRule
+                };
+                return end;
+            },
+            _updatePaint: function (words, floats, i) {
+                const id = words[i];
+                const paint = {
+                    style: words[i + 1],
+                    value: _colorStyle(words[i + 2]),
+                    thickness: floats[i + 3],
+                    join: _joinName(StrokeJoin.values[words[i + 4]]),
+                    cap: _capName(StrokeCap.values[words[i + 5]]),
+                    blend: _blendName(BlendMode.values[words[i + 6]])
+                };
+                const gradientType = words[i + 7];
+                const sx = floats[i + 8];
+                const sy = floats[i + 9];
+                const ex = floats[i + 10];
+                const ey = floats[i + 11];
+                const stopCount = words[i + 12];
+                i += 13;
+                if (gradientType !== GRADIENT_NONE) {
+                    const isRadial = gradientType === GRADIENT_RADIAL;
+                    const end = i + stopCount * 2;
+                    let key = _gradientKey(isRadial, sx, sy, ex, ey);
+                    for (let stop = i; stop < end; stop += 2) {
+                        key += _stopKey(words[stop], floats[stop + 1]);
+                    }
+                    let gradient = _cachedGradient(this._ctx, key);
+                    if (gradient === undefined) {
+                        gradient = _makeGradient(this._ctx, key, isRadial, sx,
+                            sy, ex, ey);
+                        for (let stop = i; stop < end; stop += 2) {
+                            gradient.addColorStop(floats[stop + 1],
+                                _colorStyle(words[stop]));
+                        }
+                    }
+                    paint.value = gradient;
+                    i = end;
+                } else {
+                    i += stopCount * 2;
+                }
+                this._paints[id] = paint;
+                return i;
+            }
+        });
+
+    Module.canvasRenderFactory = {
         makeRenderPaint: function () {
             return new CanvasRenderPaint();
         },
@@ -268,4 +610,69 @@ Module.onRuntimeInitialized = function () {
             return new CanvasRenderPath();
         }
     };
+
+    // Paths and paints that record into wasm memory; use together with
+    // CanvasCommandBufferRenderer. Select it before loading any file.
+    Module.commandBufferRenderFactory = {
+        makeRenderPaint: function () {
+            return new CommandBufferRenderPaint();
+        },
+        makeRenderPath: function () {
+            return new CommandBufferRenderPath();
+        }
+    };
+
+    // Paths and paints for SoftwareRenderer, which rasterizes in wasm without
+    // a canvas, e.g. to render frames on a server. Select it before loading
+    // any file.
+    Module.softwareRenderFactory = {
+        makeRenderPaint: function () {
+            return new SoftwareRenderPaint();
+        },
+        makeRenderPath: function () {
+            return new SoftwareRenderPath();
+        }
+    };
+
+    Module.renderFactory = Module.canvasRenderFactory;
+
+    // Imports a file from a ReadableStream of bytes, such as a fetch
+    // response's body, writing each chunk straight into wasm memory as it
+    // arrives. Passing the expected byteLength avoids reallocating as the data
+    // grows; without it, the buffer doubles as needed. onProgress, if given,
+    // is called with the number of bytes written so far after each chunk.
+    // Resolves to the File, or null if the data isn't a valid file.
+    Module.loadStream = function (stream, byteLength, onProgress) {
+        const importer = new FileImporter();
+        if (byteLength) {
+            importer.reserve(byteLength);
+        }
+        const reader = stream.getReader();
+        function pump() {
+            return reader.read().then(function (result) {
+                if (result.done) {
+                    return importer.importFile();
+                }
+                const chunk = result.value;
+                // The view is only valid until wasm memory grows again.
+                const view = importer.buffer(chunk.length);
+                if (view === null) {
+                    throw new Error('Out of memory importing file');
+                }
+                view.set(chunk);
+                importer.commit(chunk.length);
+                if (onProgress) {
+                    onProgress(importer.length());
+                }
+                return pump();
+            });
+        }
+        return pump().then(function (file) {
+            importer.delete();
+            return file;
+        }, function (error) {
+            importer.delete();
+            throw error;
+        });
+    };
 };
\ No newline at end of file
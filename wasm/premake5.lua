@@ -9,7 +9,7 @@ targetdir "build/bin/%{cfg.buildcfg}"
 objdir "build/obj/%{cfg.buildcfg}"
 includedirs {"./submodules/rive-cpp/include"}
 
-files {"./submodules/rive-cpp/src/**.cpp", "./src/bindings.cpp"}
+files {"./submodules/rive-cpp/src/**.cpp", "./src/*.cpp"}
 
 buildoptions {"-Oz", "-g1", "--closure 0", "--bind", "-g1", "-o build/bin/%{cfg.buildcfg}/rive.mjs", "-s ASSERTIONS=0",
               "-s FORCE_FILESYSTEM=0", "-s MODULARIZE=1", "-s NO_EXIT_RUNTIME=1", "-s STRICT=1",
@@ -0,0 +1,3 @@
+// The SIMD build exposes the same runtime as rive.mjs
+export * from './types';
+export { default } from './types';
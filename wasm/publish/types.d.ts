@@ -8,10 +8,23 @@ export default Rive;
 export interface RiveCanvas {
   Alignment: AlignmentFactory;
   CanvasRenderer: typeof CanvasRenderer;
+  CanvasCommandBufferRenderer: typeof CanvasCommandBufferRenderer;
   LinearAnimationInstance: typeof LinearAnimationInstance;
   StateMachineInstance: typeof StateMachineInstance;
   SMIInput: typeof SMIInput;
-  renderFactory: CanvasRenderFactory;
+  FileImporter: typeof FileImporter;
+  DamageTracker: typeof DamageTracker;
+  HitTester: typeof HitTester;
+  StatsRecorder: typeof StatsRecorder;
+  SoftwareRenderer: typeof SoftwareRenderer;
+  MeshRenderer: typeof MeshRenderer;
+  AnimationBake: typeof AnimationBake;
+  BatchedArtboard: typeof BatchedArtboard;
+  AdvanceBatch: typeof AdvanceBatch;
+  renderFactory: RenderFactory;
+  canvasRenderFactory: CanvasRenderFactory;
+  commandBufferRenderFactory: CommandBufferRenderFactory;
+  softwareRenderFactory: SoftwareRenderFactory;
 
   BlendMode: typeof BlendMode;
   FillRule: typeof FillRule;
@@ -20,7 +33,24 @@ export interface RiveCanvas {
   StrokeCap: typeof StrokeCap;
   StrokeJoin: typeof StrokeJoin;
 
+  /**
+   * Imports a file from bytes held in JS. They're copied once into wasm
+   * memory, which can't take over a JS buffer; use loadStream or a
+   * FileImporter to avoid holding the whole file in JS first.
+   */
   load(buffer: Uint8Array): File;
+  /**
+   * Imports a file from a stream of bytes, writing chunks straight into wasm
+   * memory as they arrive. Resolves to null if the data isn't a valid file.
+   * @param byteLength expected size of the file, if known; without it the
+   * buffer doubles as needed
+   * @param onProgress called with the number of bytes written after each chunk
+   */
+  loadStream(
+    stream: ReadableStream<Uint8Array>,
+    byteLength?: number,
+    onProgress?: (bytesWritten: number) => void
+  ): Promise<File | null>;
 }
 
 //////////////
@@ -35,14 +65,18 @@ export declare class RendererWrapper {
   clipPath(path: RenderPath): void;
 }
 
+/**
+ * Paths are recorded in wasm memory as they're built and only handed to JS
+ * when they're drawn or used as a clip and their geometry changed since the
+ * last time. A rebuild is delivered as reset, fillRule and then any number of
+ * addCommands and addPath calls in order.
+ */
 export declare class RenderPathWrapper {
   reset(): void;
   addPath(path: CommandPath, transform: Mat2D): void;
   fillRule(value: FillRule): void;
-  moveTo(x: number, y: number): void
-  lineTo(x: number, y: number): void
-  cubicTo(ox: number, oy: number, ix: number, iy: number, x: number, y: number): void;
-  close(): void;
+  /** Packed path verbs and their float arguments; see recording_render_path.hpp */
+  addCommands(commands: Uint32Array): void;
 }
 
 export declare class RenderPaintWrapper {
@@ -60,6 +94,7 @@ export declare class RenderPaintWrapper {
 
 export declare class Renderer extends RendererWrapper {
   align(fit: Fit, alignment: Alignment, frame: AABB, content: AABB): void
+  delete(): void;
 }
 
 export declare class CommandPath { }
@@ -73,8 +108,17 @@ export declare class RenderPaint extends RenderPaintWrapper { }
 // CANVAS RENDERER //
 /////////////////////
 
+/**
+ * Draws straight into a canvas 2D context, only setting the paint state that
+ * changed since the last draw, across its own saves and restores.
+ */
 export declare class CanvasRenderer extends Renderer {
   constructor(ctx: CanvasRenderingContext2D | OffscreenCanvasRenderingContext2D);
+  /**
+   * Ends a frame; the next draws set the context's paint state again, as
+   * anything else may change it in between
+   */
+  flush(): void;
 }
 
 export declare class CanvasRenderPaint extends RenderPaint {
@@ -83,24 +127,237 @@ export declare class CanvasRenderPaint extends RenderPaint {
 
 export declare class CanvasRenderPath extends RenderPath { }
 
-export interface CanvasRenderFactory {
+export interface RenderFactory {
+  makeRenderPaint(): RenderPaint;
+  makeRenderPath(): RenderPath;
+}
+
+export interface CanvasRenderFactory extends RenderFactory {
   makeRenderPaint(): CanvasRenderPaint;
   makeRenderPath(): CanvasRenderPath;
 }
 
+/**
+ * Works out which parts of the canvas changed between frames; see
+ * Artboard.damage. Align it like the renderer it shadows, which also marks the
+ * whole canvas as damaged.
+ */
+export declare class DamageTracker extends Renderer {
+  constructor();
+  /** Marks the whole canvas as damaged on the next frame */
+  invalidate(): void;
+  /** Whether the last frame damaged the whole canvas */
+  isFull(): boolean;
+  /** Damaged rectangles as minX, minY, maxX, maxY in device pixels */
+  rects(): Float32Array;
+}
+
+/**
+ * Finds the shape drawn at a point of the canvas; see Artboard.hitTest. Keeps
+ * a bounding volume hierarchy over the artboard's draws, refit to what changed
+ * on each update. Align it like the renderer it shadows.
+ */
+export declare class HitTester extends Renderer {
+  constructor();
+  /** Number of draws recorded by the last update */
+  drawCount(): number;
+}
+
+/**
+ * What one frame of an artboard cost
+ */
+export interface FrameStats {
+  pathsDrawn: number;
+  /** Verbs in the paths drawn and clipped with, including sub paths */
+  pathVerbs: number;
+  clips: number;
+  /** Deepest save/restore nesting reached while drawing */
+  saveDepth: number;
+  gradientsRebuilt: number;
+  /** Paths rebuilt by the artboard's components while advancing */
+  pathsRebuilt: number;
+  advanceMicros: number;
+  applyMicros: number;
+  drawMicros: number;
+}
+
+/**
+ * Collects FrameStats for an artboard: pass it to BatchedArtboard.setStats
+ * and draw through it, wrapped around the real renderer. Nothing is measured
+ * without one.
+ */
+export declare class StatsRecorder extends Renderer {
+  constructor();
+  /** The renderer draws are forwarded to */
+  setRenderer(renderer: Renderer): void;
+  /** Starts timing the frame's draw */
+  beginDraw(): void;
+  /** Completes the frame, making its stats available from last() */
+  endFrame(): void;
+  /** Stats of the last completed frame */
+  last(): FrameStats;
+  delete(): void;
+}
+
+/////////////////////////////
+// COMMAND BUFFER RENDERER //
+/////////////////////////////
+
+export declare class CommandBufferRenderer extends Renderer {
+  /** View of the recorded command stream in wasm memory */
+  commands(): Uint32Array;
+  /** Discards the recorded commands */
+  clear(): void;
+}
+
+/**
+ * Records a whole frame in wasm memory and replays it into a canvas 2D context
+ * in a single pass. Requires the commandBufferRenderFactory to be selected as
+ * the renderFactory before any file is loaded.
+ */
+export declare class CanvasCommandBufferRenderer extends CommandBufferRenderer {
+  constructor(ctx: CanvasRenderingContext2D | OffscreenCanvasRenderingContext2D);
+  /** Replays the commands recorded since the last flush into the context */
+  flush(): void;
+}
+
+export declare class CommandBufferRenderPath extends RenderPath { }
+
+export declare class CommandBufferRenderPaint extends RenderPaint { }
+
+export interface CommandBufferRenderFactory extends RenderFactory {
+  makeRenderPaint(): CommandBufferRenderPaint;
+  makeRenderPath(): CommandBufferRenderPath;
+}
+
+///////////////////////
+// SOFTWARE RENDERER //
+///////////////////////
+
+/**
+ * Rasterizes on the CPU into pixels in wasm memory, without a canvas. Files
+ * drawn into it must be loaded with the software render factory.
+ */
+export declare class SoftwareRenderer extends Renderer {
+  constructor(width: number, height: number);
+  width(): number;
+  height(): number;
+  resize(width: number, height: number): void;
+  /** Fills every pixel with an ARGB color, e.g. 0 for transparent */
+  clear(color: number): void;
+  /** Premultiplied RGBA pixels, row by row */
+  pixels(): Uint8Array;
+  /**
+   * The pixels with straight alpha, as expected by ImageData:
+   * new ImageData(new Uint8ClampedArray(p.buffer, p.byteOffset, p.length), w, h)
+   */
+  unpremultipliedPixels(): Uint8Array;
+}
+
+/**
+ * Tessellates what's drawn into indexed triangle meshes for WebGL or WebGPU,
+ * in one vertex and one index buffer per frame. Files drawn into it must be
+ * loaded with the software render factory. Views must be fetched again after
+ * drawing, as the buffers may move.
+ */
+export declare class MeshRenderer extends Renderer {
+  constructor();
+  /** Starts a new frame, keeping the buffers' memory */
+  clear(): void;
+  vertexCount(): number;
+  indexCount(): number;
+  drawCount(): number;
+  stopCount(): number;
+  /** x and y per vertex, in the space of the draw's path */
+  vertices(): Float32Array;
+  /** Three per triangle */
+  indices(): Uint32Array;
+  /**
+   * Eight per draw: first index, index count, clip draw (0xFFFFFFFF if
+   * unclipped), paint (0 clip, 1 color, 2 linear, 3 radial), ARGB color,
+   * blend mode, first stop, stop count
+   */
+  draws(): Uint32Array;
+  /** Ten per draw: transform (6), gradient start (2), gradient end (2) */
+  drawFloats(): Float32Array;
+  /** ARGB gradient stop colors */
+  stopColors(): Uint32Array;
+  stopOffsets(): Float32Array;
+}
+
+export declare class SoftwareRenderPath extends RenderPath { }
+
+export declare class SoftwareRenderPaint extends RenderPaint { }
+
+export interface SoftwareRenderFactory extends RenderFactory {
+  makeRenderPaint(): SoftwareRenderPaint;
+  makeRenderPath(): SoftwareRenderPath;
+}
+
 //////////
 // File //
 //////////
+/**
+ * Builds up a file's bytes in wasm memory. Views returned by buffer() must be
+ * written to immediately, as growing wasm memory invalidates them.
+ */
+export declare class FileImporter {
+  constructor();
+  /** Reserves room for the expected size of the file */
+  reserve(size: number): void;
+  /**
+   * Makes room for size more bytes and returns the view to write them to, or
+   * null if there's no memory for them
+   */
+  buffer(size: number): Uint8Array | null;
+  /** Marks size bytes written to the last buffer as part of the file */
+  commit(size: number): void;
+  length(): number;
+  /** Imports the bytes written so far and releases them */
+  importFile(): File | null;
+  delete(): void;
+}
 export declare class File {
   defaultArtboard(): Artboard;
   artboardByName(name: string): Artboard;
   artboardByIndex(index: number): Artboard;
   artboardCount(): number;
+  /**
+   * Deletes the file and its definitions; artboard instances made from it
+   * must be deleted first
+   */
+  delete(): void;
 }
 export declare class Artboard {
   get name(): string;
+  /**
+   * Creates an artboard with its own mutable state (transforms, animated
+   * values) sharing the file's imported definitions. Instances are owned by the
+   * caller and must be deleted.
+   */
+  instance(): Artboard;
+  delete(): void;
+  /**
+   * Works out the parts of the canvas that changed since the last call with
+   * this tracker; returns the number of damaged rectangles
+   */
+  damage(tracker: DamageTracker): number;
+  /**
+   * Draws the artboard into the tester, refitting its hierarchy to what
+   * changed; call once per frame before hit testing
+   */
+  updateHitTester(tester: HitTester): void;
+  /**
+   * Tests a point in canvas pixels against the geometry of the artboard's
+   * shapes as last drawn into the tester, honoring fill rules, strokes and
+   * clips. Returns the object index of the topmost shape hit, or -1
+   */
+  hitTest(tester: HitTester, x: number, y: number): number;
+  /** Name of the component at an object index, empty if there's none */
+  objectName(index: number): string;
   get bounds(): AABB;
-  advance(sec: number): any;
+  /** Returns true if any of the artboard's components were updated */
+  advance(sec: number): boolean;
   draw(renderer: CanvasRenderer): void;
   animationByName(name: string): LinearAnimation;
   animationByIndex(index: number): LinearAnimation;
@@ -159,6 +416,7 @@ export declare class LinearAnimationInstance {
    * @param mix 0-1 the strength of the animation in the animations mix.
    */
   apply(artboard: Artboard, mix: number): any;
+  delete(): void;
 }
 
 export declare class StateMachine {
@@ -169,10 +427,121 @@ export declare class StateMachineInstance {
   constructor(stateMachine: StateMachine);
   inputCount(): number;
   input(i: number): SMIInput; 
-  advance(sec: number): any;
+  /**
+   * Returns true while the state machine is still animating or transitioning,
+   * i.e. advancing it again may change the artboard
+   */
+  advance(sec: number): boolean;
   apply(artboard: Artboard): any;
   stateChangedCount(): number;
   stateChangedNameByIndex(i: number): string;
+  delete(): void;
+}
+
+/**
+ * A linear animation sampled into tables at a fixed rate, applied with a
+ * lookup and a lerp instead of evaluating keyframes. Applies to the artboard
+ * it was baked on and its instances; share one per animation.
+ */
+export declare class AnimationBake {
+  /** fps <= 0 samples at the animation's own rate */
+  constructor(artboard: Artboard, animation: LinearAnimation, fps: number);
+  fps(): number;
+  frameCount(): number;
+  /** Number of animated properties baked */
+  propertyCount(): number;
+  /** Number of keyed properties that can't be baked, like draw order */
+  unbakedCount(): number;
+  /** Memory taken by the tables, in bytes */
+  byteSize(): number;
+  /** Whether artboard is the one baked on or one of its instances */
+  appliesTo(artboard: Artboard): boolean;
+  /** Does nothing unless appliesTo(artboard) */
+  apply(artboard: Artboard, time: number, mix: number): void;
+  delete(): void;
+}
+
+/**
+ * The animations and state machines playing on an artboard, advanced and
+ * applied together. Instances must be removed before they're deleted.
+ */
+export declare class BatchedArtboard {
+  constructor(artboard: Artboard);
+  /** Drops bakes that don't apply to the new artboard */
+  setArtboard(artboard: Artboard): void;
+  addAnimation(instance: LinearAnimationInstance, playing: boolean): void;
+  removeAnimation(instance: LinearAnimationInstance): void;
+  playAnimation(instance: LinearAnimationInstance, playing: boolean): void;
+  /** Moves the animation to time on the next advance */
+  scrubAnimation(instance: LinearAnimationInstance, time: number): void;
+  /**
+   * Applies the animation from a bake instead of its keyframes; null to stop.
+   * False if the bake is of another animation, has unbaked properties or
+   * doesn't apply to the artboard
+   */
+  bakeAnimation(instance: LinearAnimationInstance, bake: AnimationBake | null): boolean;
+  addStateMachine(instance: StateMachineInstance, playing: boolean): void;
+  removeStateMachine(instance: StateMachineInstance): void;
+  playStateMachine(instance: StateMachineInstance, playing: boolean): void;
+  /**
+   * Room for count (input index, value) pairs staged for one of the batch's
+   * state machines, valid until the next call or until state machines are
+   * added or removed; fill it and pass count to applyInputWrites. Null if the
+   * instance isn't in the batch
+   */
+  inputWrites(instance: StateMachineInstance, count: number): Float32Array | null;
+  /**
+   * Applies the first count pairs written to inputWrites() in order: bools
+   * are set to value != 0, numbers to value, and triggers fire. Returns the
+   * number of writes applied, skipping indices past the inputs
+   */
+  applyInputWrites(instance: StateMachineInstance, count: number): number;
+  /** Times advances into the recorder's current frame; null to stop */
+  setStats(recorder: StatsRecorder | null): void;
+  /**
+   * Advances everything playing; returns AdvanceResult flags: 1 if an
+   * animation looped, 2 if a state machine changed state, 4 if the artboard
+   * changed or will keep changing (when unset, the artboard has settled)
+   */
+  advance(sec: number): number;
+  /**
+   * Ring of the events behind the flags advance() reports: 256 events of 2
+   * words, the type (0 for a state change, 1 for a loop) and a name id,
+   * event n being at (n % 256) * 2. The view is detached when wasm memory
+   * grows; fetch it again then
+   */
+  events(): Uint32Array;
+  /** Number of events ever written, wrapping at 2^32 */
+  eventsWritten(): number;
+  /** Name of an event's name id; ids always stand for the same name */
+  eventName(id: number): string;
+  delete(): void;
+}
+
+/**
+ * Advances many artboards in one call. Write each artboard's elapsed seconds
+ * to elapsed() at the index add() returned (negative to skip it), call
+ * advance() and read the flags back from results(). Fetch the views again
+ * after adding artboards.
+ */
+export declare class AdvanceBatch {
+  constructor();
+  add(artboard: BatchedArtboard): number;
+  remove(index: number): void;
+  elapsed(): Float32Array;
+  results(): Uint32Array;
+  threadCount(): number;
+  /**
+   * Advances artboards in parallel on count worker threads (0, the default,
+   * advances them on the calling thread). Only takes effect in the threaded
+   * build, and only with artboards using the software or command buffer
+   * render factory.
+   */
+  setThreadCount(count: number): void;
+  /** Threads available to advance on; 0 without the threaded build */
+  static hardwareThreadCount(): number;
+  advance(): void;
+  delete(): void;
 }
 
 export declare class SMIInput {
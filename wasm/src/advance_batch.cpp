@@ -0,0 +1,274 @@
+#include "advance_batch.hpp"
+#include "recording_render_paint.hpp"
+#include "recording_render_path.hpp"
+
+BatchedArtboard::Animation *
+BatchedArtboard::find(rive::LinearAnimationInstance *instance) {
+  for (auto &animation : m_Animations) {
+    if (animation.instance == instance) {
+      return &animation;
+    }
+  }
+  return nullptr;
+}
+
+BatchedArtboard::StateMachine *
+BatchedArtboard::find(rive::StateMachineInstance *instance) {
+  for (auto &stateMachine : m_StateMachines) {
+    if (stateMachine.instance == instance) {
+      return &stateMachine;
+    }
+  }
+  return nullptr;
+}
+
+void BatchedArtboard::addAnimation(rive::LinearAnimationInstance *instance,
+                                   bool playing) {
+  m_Animations.push_back({instance, nullptr, playing, false, 0.0f});
+}
+
+void BatchedArtboard::removeAnimation(
+    rive::LinearAnimationInstance *instance) {
+  auto animation = find(instance);
+  if (animation != nullptr) {
+    m_Animations.erase(m_Animations.begin() +
+                       (animation - m_Animations.data()));
+  }
+}
+
+void BatchedArtboard::playAnimation(rive::LinearAnimationInstance *instance,
+                                    bool playing) {
+  auto animation = find(instance);
+  if (animation != nullptr) {
+    animation->playing = playing;
+  }
+}
+
+void BatchedArtboard::scrubAnimation(rive::LinearAnimationInstance *instance,
+                                     float time) {
+  auto animation = find(instance);
+  if (animation != nullptr) {
+    animation->scrub = true;
+    animation->scrubTime = time;
+  }
+}
+
+bool BatchedArtboard::bakeAnimation(rive::LinearAnimationInstance *instance,
+                                    const AnimationBake *bake) {
+  auto animation = find(instance);
+  if (animation == nullptr) {
+    return false;
+  }
+  // Bakes are checked against the artboard once here, so that applying them
+  // every frame needn't.
+  if (bake != nullptr && (bake->animation() != instance->animation() ||
+                          bake->unbakedCount() != 0 ||
+                          !bake->appliesTo(m_Artboard))) {
+    return false;
+  }
+  animation->bake = bake;
+  return true;
+}
+
+void BatchedArtboard::artboard(rive::Artboard *value) {
+  m_Artboard = value;
+  for (auto &animation : m_Animations) {
+    if (animation.bake != nullptr && !animation.bake->appliesTo(value)) {
+      animation.bake = nullptr;
+    }
+  }
+}
+
+void BatchedArtboard::apply(const Animation &animation) {
+  if (animation.bake != nullptr) {
+    animation.bake->applyVerified(m_Artboard, animation.instance->time(),
+                                  1.0f);
+  } else {
+    animation.instance->apply(m_Artboard, 1.0f);
+  }
+}
+
+void BatchedArtboard::addStateMachine(rive::StateMachineInstance *instance,
+                                      bool playing) {
+  m_StateMachines.push_back({instance, playing, InputWrites()});
+}
+
+void BatchedArtboard::removeStateMachine(
+    rive::StateMachineInstance *instance) {
+  auto stateMachine = find(instance);
+  if (stateMachine != nullptr) {
+    m_StateMachines.erase(m_StateMachines.begin() +
+                          (stateMachine - m_StateMachines.data()));
+  }
+}
+
+void BatchedArtboard::playStateMachine(rive::StateMachineInstance *instance,
+                                       bool playing) {
+  auto stateMachine = find(instance);
+  if (stateMachine != nullptr) {
+    stateMachine->playing = playing;
+  }
+}
+
+float *BatchedArtboard::inputWrites(rive::StateMachineInstance *instance,
+                                    size_t count) {
+  auto stateMachine = find(instance);
+  return stateMachine == nullptr ? nullptr
+                                 : stateMachine->inputWrites.pairs(count);
+}
+
+size_t
+BatchedArtboard::applyInputWrites(rive::StateMachineInstance *instance,
+                                  size_t count) {
+  auto stateMachine = find(instance);
+  return stateMachine == nullptr
+             ? 0
+             : stateMachine->inputWrites.apply(instance, count);
+}
+
+uint32_t BatchedArtboard::advance(float elapsedSeconds) {
+  uint32_t result = (uint32_t)AdvanceResult::none;
+  if (m_Artboard == nullptr) {
+    return result;
+  }
+  FrameStats *stats = m_Stats == nullptr ? nullptr : &m_Stats->current();
+  uint32_t pathsRebuilt = 0, gradientsRebuilt = 0;
+  if (stats != nullptr) {
+    pathsRebuilt = RecordingRenderPath::rebuiltCount();
+    gradientsRebuilt = RecordingRenderPaint::completedGradientCount();
+  }
+  StatsTimer timer(stats);
+
+  bool keepGoing = false;
+  // Scrubbed animations are applied first so that playing animations win
+  // where they animate the same properties.
+  for (auto &animation : m_Animations) {
+    if (!animation.scrub) {
+      continue;
+    }
+    animation.instance->time(0.0f);
+    animation.instance->advance(animation.scrubTime);
+    timer.lap(&FrameStats::advanceMicros);
+    apply(animation);
+    timer.lap(&FrameStats::applyMicros);
+    keepGoing = true;
+  }
+  for (auto &animation : m_Animations) {
+    if (animation.scrub) {
+      animation.scrub = false;
+      continue;
+    }
+    if (!animation.playing) {
+      continue;
+    }
+    if (animation.instance->advance(elapsedSeconds)) {
+      keepGoing = true;
+    }
+    if (animation.instance->didLoop()) {
+      result |= (uint32_t)AdvanceResult::looped;
+      m_Events.looped(animation.instance->animation());
+    }
+    timer.lap(&FrameStats::advanceMicros);
+    apply(animation);
+    timer.lap(&FrameStats::applyMicros);
+  }
+  for (auto &stateMachine : m_StateMachines) {
+    if (!stateMachine.playing) {
+      continue;
+    }
+    // A state machine keeps going while any of its layers is still animating
+    // or transitioning.
+    if (stateMachine.instance->advance(elapsedSeconds)) {
+      keepGoing = true;
+    }
+    timer.lap(&FrameStats::advanceMicros);
+    stateMachine.instance->apply(m_Artboard);
+    timer.lap(&FrameStats::applyMicros);
+    size_t changedCount = stateMachine.instance->stateChangedCount();
+    if (changedCount > 0) {
+      result |= (uint32_t)AdvanceResult::stateChanged;
+    }
+    for (size_t i = 0; i < changedCount; i++) {
+      m_Events.stateChanged(stateMachine.instance->stateChangedByIndex(i));
+    }
+  }
+  if (m_Artboard->advance(elapsedSeconds) || keepGoing) {
+    result |= (uint32_t)AdvanceResult::changed;
+  }
+  timer.lap(&FrameStats::advanceMicros);
+
+  if (stats != nullptr) {
+    stats->pathsRebuilt += RecordingRenderPath::rebuiltCount() - pathsRebuilt;
+    stats->gradientsRebuilt +=
+        RecordingRenderPaint::completedGradientCount() - gradientsRebuilt;
+  }
+  return result;
+}
+
+uint32_t AdvanceBatch::add(BatchedArtboard *artboard) {
+  uint32_t index;
+  if (m_Free.empty()) {
+    index = (uint32_t)m_Artboards.size();
+    m_Artboards.push_back(artboard);
+    m_Elapsed.push_back(-1.0f);
+    m_Results.push_back(0);
+  } else {
+    index = m_Free.back();
+    m_Free.pop_back();
+    m_Artboards[index] = artboard;
+  }
+  m_Elapsed[index] = -1.0f;
+  m_Results[index] = 0;
+  return index;
+}
+
+void AdvanceBatch::remove(uint32_t index) {
+  if (index >= m_Artboards.size() || m_Artboards[index] == nullptr) {
+    return;
+  }
+  m_Artboards[index] = nullptr;
+  m_Elapsed[index] = -1.0f;
+  m_Free.push_back(index);
+}
+
+size_t AdvanceBatch::threadCount() const {
+  return m_Pool == nullptr ? 0 : m_Pool->threadCount();
+}
+
+void AdvanceBatch::threadCount(size_t value) {
+#ifndef RIVE_USE_THREADS
+  value = 0;
+#endif
+  if (value == threadCount()) {
+    return;
+  }
+  m_Pool.reset(value == 0 ? nullptr : new ThreadPool(value));
+}
+
+void AdvanceBatch::advanceArtboard(size_t index) {
+  auto artboard = m_Artboards[index];
+  float elapsed = m_Elapsed[index];
+  if (artboard == nullptr || elapsed < 0.0f) {
+    m_Results[index] = 0;
+    return;
+  }
+  m_Results[index] = artboard->advance(elapsed);
+  // Consumed; each frame's elapsed times are written afresh.
+  m_Elapsed[index] = -1.0f;
+}
+
+void AdvanceBatch::advance() {
+  size_t count = m_Artboards.size();
+  if (m_Pool == nullptr) {
+    for (size_t i = 0; i < count; i++) {
+      advanceArtboard(i);
+    }
+    return;
+  }
+  // Each index only touches its own artboard and slots in the views, so they
+  // can run in any order on any thread. Artboards vary a lot in cost, hence
+  // the chunks of one to let idle threads steal the expensive ones.
+  m_Pool->parallelFor(count, 1, [this](size_t index) {
+    advanceArtboard(index);
+  });
+}
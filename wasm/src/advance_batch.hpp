@@ -0,0 +1,142 @@
+#ifndef _RIVE_ADVANCE_BATCH_HPP_
+#define _RIVE_ADVANCE_BATCH_HPP_
+
+#include "animation/linear_animation_instance.hpp"
+#include "animation_bake.hpp"
+#include "animation/state_machine_instance.hpp"
+#include "artboard.hpp"
+#include "event_ring.hpp"
+#include "frame_stats.hpp"
+#include "input_writes.hpp"
+#include "thread_pool.hpp"
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+// Flags reported by an advance, letting JS skip per animation queries on
+// frames where nothing of interest happened.
+enum class AdvanceResult : uint32_t {
+  none = 0,
+  // At least one animation looped; see the artboard's events.
+  looped = 1 << 0,
+  // At least one state machine changed state; see the artboard's events.
+  stateChanged = 1 << 1,
+  // The artboard changed, or will keep changing on the next advance. When
+  // this isn't reported the artboard has settled and there's no need to
+  // advance or draw it again until something (an input, playback) changes.
+  changed = 1 << 2
+};
+
+// The animations and state machines that play on an artboard, advanced and
+// applied in one call rather than one JS to wasm call per instance.
+class BatchedArtboard {
+private:
+  struct Animation {
+    rive::LinearAnimationInstance *instance;
+    const AnimationBake *bake;
+    bool playing;
+    bool scrub;
+    float scrubTime;
+  };
+  struct StateMachine {
+    rive::StateMachineInstance *instance;
+    bool playing;
+    InputWrites inputWrites;
+  };
+
+  rive::Artboard *m_Artboard;
+  StatsRecorder *m_Stats = nullptr;
+  std::vector<Animation> m_Animations;
+  std::vector<StateMachine> m_StateMachines;
+  EventRing m_Events;
+
+  Animation *find(rive::LinearAnimationInstance *instance);
+  StateMachine *find(rive::StateMachineInstance *instance);
+  void apply(const Animation &animation);
+
+public:
+  explicit BatchedArtboard(rive::Artboard *artboard) : m_Artboard(artboard) {}
+
+  rive::Artboard *artboard() const { return m_Artboard; }
+  // Rebinds the batch; bakes that don't apply to the new artboard are
+  // dropped, their animations going back to their keyframes.
+  void artboard(rive::Artboard *value);
+
+  // Records advance and apply times into the recorder's current frame; null
+  // (the default) to not measure anything.
+  StatsRecorder *stats() const { return m_Stats; }
+  void stats(StatsRecorder *value) { m_Stats = value; }
+
+  // Instances aren't owned by the batch; remove them before deleting them.
+  void addAnimation(rive::LinearAnimationInstance *instance, bool playing);
+  void removeAnimation(rive::LinearAnimationInstance *instance);
+  void playAnimation(rive::LinearAnimationInstance *instance, bool playing);
+  // Moves the animation to time on the next advance, instead of advancing it
+  // by the elapsed time.
+  void scrubAnimation(rive::LinearAnimationInstance *instance, float time);
+  // Applies the animation from a bake of its LinearAnimation instead of
+  // evaluating its keyframes; null to go back to them. Bakes aren't owned and
+  // may be shared by any number of instances. Returns false, leaving the
+  // animation as it was, if the bake is of another animation, misses some of
+  // its keyed properties or doesn't apply to the artboard.
+  bool bakeAnimation(rive::LinearAnimationInstance *instance,
+                     const AnimationBake *bake);
+
+  void addStateMachine(rive::StateMachineInstance *instance, bool playing);
+  void removeStateMachine(rive::StateMachineInstance *instance);
+  void playStateMachine(rive::StateMachineInstance *instance, bool playing);
+  // Room for count input writes to the state machine, staged apart from any
+  // other's; see InputWrites. Valid until the next call or until state
+  // machines are added or removed. Null if the instance isn't in the batch.
+  float *inputWrites(rive::StateMachineInstance *instance, size_t count);
+  // Applies the first count writes staged for the state machine; returns the
+  // number applied.
+  size_t applyInputWrites(rive::StateMachineInstance *instance, size_t count);
+
+  // Advances and applies scrubbed and playing animations, then playing state
+  // machines, then the artboard. Returns AdvanceResult flags, the loops and
+  // state changes behind them being written to events().
+  uint32_t advance(float elapsedSeconds);
+
+  const EventRing &events() const { return m_Events; }
+};
+
+// Advances many artboards in a single call. JS writes each artboard's elapsed
+// time into the elapsed() view, negative to leave it alone this frame, calls
+// advance() and reads the AdvanceResult flags back from results(). Views must
+// be fetched again after artboards are added, as that may move them.
+//
+// With threads, artboards are advanced in parallel; they're ready to draw once
+// advance() returns. Artboards in the batch must then be separate instances,
+// must not share a StatsRecorder and must use paths and paints that don't
+// call back into JS (the software or command buffer factory, not the canvas
+// one).
+class AdvanceBatch {
+private:
+  std::vector<BatchedArtboard *> m_Artboards;
+  std::vector<float> m_Elapsed;
+  std::vector<uint32_t> m_Results;
+  std::vector<uint32_t> m_Free;
+  std::unique_ptr<ThreadPool> m_Pool;
+
+  void advanceArtboard(size_t index);
+
+public:
+  // Returns the artboard's index in the views.
+  uint32_t add(BatchedArtboard *artboard);
+  void remove(uint32_t index);
+
+  size_t size() const { return m_Artboards.size(); }
+  float *elapsed() { return m_Elapsed.data(); }
+  uint32_t *results() { return m_Results.data(); }
+
+  // Number of worker threads advancing artboards along with the caller; 0
+  // (the default) advances them all on the calling thread. Always 0 in builds
+  // without threads.
+  size_t threadCount() const;
+  void threadCount(size_t value);
+
+  void advance();
+};
+
+#endif
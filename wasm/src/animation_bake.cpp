@@ -0,0 +1,272 @@
+#include "animation_bake.hpp"
+#include "bones/bone.hpp"
+#include "bones/root_bone.hpp"
+#include "draw_rules.hpp"
+#include "node.hpp"
+#include "shapes/cubic_asymmetric_vertex.hpp"
+#include "shapes/cubic_detached_vertex.hpp"
+#include "shapes/cubic_mirrored_vertex.hpp"
+#include "shapes/paint/gradient_stop.hpp"
+#include "shapes/paint/linear_gradient.hpp"
+#include "shapes/paint/solid_color.hpp"
+#include "shapes/paint/stroke.hpp"
+#include "shapes/paint/trim_path.hpp"
+#include "shapes/parametric_path.hpp"
+#include "shapes/path_vertex.hpp"
+#include "shapes/polygon.hpp"
+#include "shapes/rectangle.hpp"
+#include "shapes/star.hpp"
+#include "shapes/straight_vertex.hpp"
+#include "transform_component.hpp"
+#include <algorithm>
+#include <math.h>
+
+// Accessors for an animatable property of the objects of type applies()
+// accepts; floats use getFloat and setFloat, colors (and other whole values)
+// getColor and setColor.
+struct AnimationBake::Property {
+  bool (*applies)(rive::Core *object);
+  float (*getFloat)(rive::Core *object);
+  void (*setFloat)(rive::Core *object, float value);
+  uint32_t (*getColor)(rive::Core *object);
+  void (*setColor)(rive::Core *object, uint32_t value);
+};
+
+#define FLOAT_PROPERTY(Type, name)                                             \
+  {[](rive::Core *object) { return object->is<rive::Type>(); },                \
+   [](rive::Core *object) { return (float)object->as<rive::Type>()->name(); }, \
+   [](rive::Core *object, float value) {                                      \
+     object->as<rive::Type>()->name(value);                                    \
+   },                                                                          \
+   nullptr, nullptr}
+
+#define COLOR_PROPERTY(Type, name)                                             \
+  {[](rive::Core *object) { return object->is<rive::Type>(); }, nullptr,       \
+   nullptr,                                                                    \
+   [](rive::Core *object) {                                                    \
+     return (uint32_t)object->as<rive::Type>()->name();                        \
+   },                                                                          \
+   [](rive::Core *object, uint32_t value) {                                   \
+     object->as<rive::Type>()->name((int)value);                               \
+   }}
+
+#define UINT_PROPERTY(Type, name)                                              \
+  {[](rive::Core *object) { return object->is<rive::Type>(); }, nullptr,       \
+   nullptr,                                                                    \
+   [](rive::Core *object) {                                                    \
+     return (uint32_t)object->as<rive::Type>()->name();                        \
+   },                                                                          \
+   [](rive::Core *object, uint32_t value) {                                   \
+     object->as<rive::Type>()->name(value);                                    \
+   }}
+
+static const AnimationBake::Property floatProperties[] = {
+    FLOAT_PROPERTY(Node, x),
+    FLOAT_PROPERTY(Node, y),
+    FLOAT_PROPERTY(TransformComponent, rotation),
+    FLOAT_PROPERTY(TransformComponent, scaleX),
+    FLOAT_PROPERTY(TransformComponent, scaleY),
+    FLOAT_PROPERTY(TransformComponent, opacity),
+    FLOAT_PROPERTY(Bone, length),
+    FLOAT_PROPERTY(RootBone, x),
+    FLOAT_PROPERTY(RootBone, y),
+    FLOAT_PROPERTY(PathVertex, x),
+    FLOAT_PROPERTY(PathVertex, y),
+    FLOAT_PROPERTY(StraightVertex, radius),
+    FLOAT_PROPERTY(CubicMirroredVertex, rotation),
+    FLOAT_PROPERTY(CubicMirroredVertex, distance),
+    FLOAT_PROPERTY(CubicAsymmetricVertex, rotation),
+    FLOAT_PROPERTY(CubicAsymmetricVertex, inDistance),
+    FLOAT_PROPERTY(CubicAsymmetricVertex, outDistance),
+    FLOAT_PROPERTY(CubicDetachedVertex, inRotation),
+    FLOAT_PROPERTY(CubicDetachedVertex, inDistance),
+    FLOAT_PROPERTY(CubicDetachedVertex, outRotation),
+    FLOAT_PROPERTY(CubicDetachedVertex, outDistance),
+    FLOAT_PROPERTY(ParametricPath, width),
+    FLOAT_PROPERTY(ParametricPath, height),
+    FLOAT_PROPERTY(Rectangle, cornerRadius),
+    FLOAT_PROPERTY(Polygon, cornerRadius),
+    FLOAT_PROPERTY(Star, innerRadius),
+    FLOAT_PROPERTY(GradientStop, position),
+    FLOAT_PROPERTY(LinearGradient, startX),
+    FLOAT_PROPERTY(LinearGradient, startY),
+    FLOAT_PROPERTY(LinearGradient, endX),
+    FLOAT_PROPERTY(LinearGradient, endY),
+    FLOAT_PROPERTY(LinearGradient, opacity),
+    FLOAT_PROPERTY(Stroke, thickness),
+    FLOAT_PROPERTY(TrimPath, start),
+    FLOAT_PROPERTY(TrimPath, end),
+    FLOAT_PROPERTY(TrimPath, offset),
+};
+
+static const AnimationBake::Property colorProperties[] = {
+    COLOR_PROPERTY(SolidColor, colorValue),
+    COLOR_PROPERTY(GradientStop, colorValue),
+};
+
+// Keyable properties whose values can't be lerped between samples.
+static const AnimationBake::Property unbakedProperties[] = {
+    UINT_PROPERTY(DrawRules, drawTargetId),
+    UINT_PROPERTY(Polygon, points),
+};
+
+// Written to candidate properties to see which ones the animation sets.
+static const uint32_t markerColor = 0x00C0FFEE;
+
+static uint32_t lerpColor(uint32_t from, uint32_t to, float t) {
+  uint32_t color = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    float a = (float)((from >> shift) & 0xFF);
+    float b = (float)((to >> shift) & 0xFF);
+    color |= (uint32_t)(a + (b - a) * t + 0.5f) << shift;
+  }
+  return color;
+}
+
+AnimationBake::AnimationBake(rive::Artboard *artboard,
+                             rive::LinearAnimation *animation, float fps)
+    : m_Animation(animation) {
+  int animationFps = animation->fps();
+  m_Fps = fps > 0.0f ? fps : (float)std::max(animationFps, 1);
+  m_Duration =
+      animationFps > 0 ? (float)animation->duration() / animationFps : 0.0f;
+  m_FrameCount = (uint32_t)ceilf(m_Duration * m_Fps) + 1;
+
+  // Sampling leaves every keyed property at its last value, including those
+  // that aren't baked, so it happens on an instance thrown away afterwards.
+  rive::Artboard *scratch = artboard->instance();
+  const auto &objects = scratch->objects();
+  m_ObjectCount = objects.size();
+  std::vector<Column> floatCandidates, colorCandidates, unbakedCandidates;
+  for (size_t i = 0; i < objects.size(); i++) {
+    rive::Core *object = objects[i];
+    if (object == nullptr) {
+      continue;
+    }
+    for (const Property &property : floatProperties) {
+      if (property.applies(object)) {
+        floatCandidates.push_back({(uint32_t)i, &property});
+      }
+    }
+    for (const Property &property : colorProperties) {
+      if (property.applies(object)) {
+        colorCandidates.push_back({(uint32_t)i, &property});
+      }
+    }
+    for (const Property &property : unbakedProperties) {
+      if (property.applies(object)) {
+        unbakedCandidates.push_back({(uint32_t)i, &property});
+      }
+    }
+  }
+
+  // Whatever no longer holds its marker after applying the animation is
+  // keyed by it.
+  for (const Column &column : floatCandidates) {
+    column.property->setFloat(objects[column.object], NAN);
+  }
+  for (const Column &column : colorCandidates) {
+    column.property->setColor(objects[column.object], markerColor);
+  }
+  for (const Column &column : unbakedCandidates) {
+    column.property->setColor(objects[column.object], markerColor);
+  }
+  animation->apply(scratch, 0.0f, 1.0f);
+  for (const Column &column : floatCandidates) {
+    if (!isnan(column.property->getFloat(objects[column.object]))) {
+      m_FloatColumns.push_back(column);
+    }
+  }
+  for (const Column &column : colorCandidates) {
+    if (column.property->getColor(objects[column.object]) != markerColor) {
+      m_ColorColumns.push_back(column);
+    }
+  }
+  for (const Column &column : unbakedCandidates) {
+    if (column.property->getColor(objects[column.object]) != markerColor) {
+      m_UnbakedCount++;
+    }
+  }
+
+  // Past its duration an animation holds its last values, so the last row
+  // can be sampled a fraction of a frame late.
+  m_Floats.resize((size_t)m_FrameCount * m_FloatColumns.size());
+  m_Colors.resize((size_t)m_FrameCount * m_ColorColumns.size());
+  float *floats = m_Floats.data();
+  uint32_t *colors = m_Colors.data();
+  for (uint32_t frame = 0; frame < m_FrameCount; frame++) {
+    animation->apply(scratch, frame / m_Fps, 1.0f);
+    for (const Column &column : m_FloatColumns) {
+      *floats++ = column.property->getFloat(objects[column.object]);
+    }
+    for (const Column &column : m_ColorColumns) {
+      *colors++ = column.property->getColor(objects[column.object]);
+    }
+  }
+  delete scratch;
+}
+
+size_t AnimationBake::byteSize() const {
+  return m_Floats.size() * sizeof(float) + m_Colors.size() * sizeof(uint32_t) +
+         propertyCount() * sizeof(Column);
+}
+
+bool AnimationBake::appliesTo(rive::Artboard *artboard) const {
+  const auto &objects = artboard->objects();
+  if (objects.size() != m_ObjectCount) {
+    return false;
+  }
+  auto columnsApply = [&objects](const std::vector<Column> &columns) {
+    for (const Column &column : columns) {
+      rive::Core *object = objects[column.object];
+      if (object == nullptr || !column.property->applies(object)) {
+        return false;
+      }
+    }
+    return true;
+  };
+  return columnsApply(m_FloatColumns) && columnsApply(m_ColorColumns);
+}
+
+void AnimationBake::apply(rive::Artboard *artboard, float time,
+                          float mix) const {
+  if (appliesTo(artboard)) {
+    applyVerified(artboard, time, mix);
+  }
+}
+
+void AnimationBake::applyVerified(rive::Artboard *artboard, float time,
+                                  float mix) const {
+  const auto &objects = artboard->objects();
+  float frame = std::min(std::max(time, 0.0f), m_Duration) * m_Fps;
+  uint32_t row = std::min((uint32_t)frame, m_FrameCount - 1);
+  uint32_t next = std::min(row + 1, m_FrameCount - 1);
+  float t = std::min(frame - row, 1.0f);
+
+  size_t floatCount = m_FloatColumns.size();
+  const float *from = m_Floats.data() + row * floatCount;
+  const float *to = m_Floats.data() + next * floatCount;
+  for (size_t i = 0; i < floatCount; i++) {
+    const Column &column = m_FloatColumns[i];
+    rive::Core *object = objects[column.object];
+    float value = from[i] + (to[i] - from[i]) * t;
+    if (mix < 1.0f) {
+      float current = column.property->getFloat(object);
+      value = current + (value - current) * mix;
+    }
+    column.property->setFloat(object, value);
+  }
+
+  size_t colorCount = m_ColorColumns.size();
+  const uint32_t *fromColors = m_Colors.data() + row * colorCount;
+  const uint32_t *toColors = m_Colors.data() + next * colorCount;
+  for (size_t i = 0; i < colorCount; i++) {
+    const Column &column = m_ColorColumns[i];
+    rive::Core *object = objects[column.object];
+    uint32_t value = lerpColor(fromColors[i], toColors[i], t);
+    if (mix < 1.0f) {
+      value = lerpColor(column.property->getColor(object), value, mix);
+    }
+    column.property->setColor(object, value);
+  }
+}
@@ -0,0 +1,81 @@
+#ifndef _RIVE_ANIMATION_BAKE_HPP_
+#define _RIVE_ANIMATION_BAKE_HPP_
+
+#include "animation/linear_animation.hpp"
+#include "artboard.hpp"
+#include "core.hpp"
+#include <stdint.h>
+#include <vector>
+
+// A linear animation sampled at a fixed rate into tables of property values,
+// so that applying it at any time is a lookup and a lerp between two rows
+// instead of evaluating every keyframe's interpolation (cubic easing
+// included). Opt-in: worth it when many instances play the same animation,
+// or when scrubbing seeks all over it.
+//
+// A bake is made from one artboard and applies to it or any of its instances,
+// which share the same objects; appliesTo() checks that an artboard does.
+// Animated properties are found by applying the animation once over marker
+// values: transforms, bones, path vertices, parametric path sizes, corner
+// radii, star radii, paint colors, gradients, stroke thickness and trim paths
+// are baked. Draw order and polygon point counts can't be lerped, so they
+// aren't; unbakedCount() reports how many such properties the animation keys,
+// and BatchedArtboard refuses bakes missing any. Values are lerped between
+// samples, so bake at least at the animation's own fps to keep hold keys and
+// sharp easing faithful.
+class AnimationBake {
+public:
+  struct Property;
+
+private:
+  struct Column {
+    uint32_t object;
+    const Property *property;
+  };
+
+  rive::LinearAnimation *m_Animation;
+  float m_Fps;
+  float m_Duration;
+  uint32_t m_FrameCount = 0;
+  // Of the artboard baked, to tell its instances from other artboards.
+  size_t m_ObjectCount = 0;
+  uint32_t m_UnbakedCount = 0;
+  std::vector<Column> m_FloatColumns;
+  std::vector<Column> m_ColorColumns;
+  // One row of values per frame, a column per property.
+  std::vector<float> m_Floats;
+  std::vector<uint32_t> m_Colors;
+
+public:
+  // Samples animation on an instance of artboard made for the purpose, fps <= 0
+  // meaning the animation's own; artboard itself is left untouched.
+  AnimationBake(rive::Artboard *artboard, rive::LinearAnimation *animation,
+                float fps);
+
+  // The animation sampled.
+  rive::LinearAnimation *animation() const { return m_Animation; }
+  float fps() const { return m_Fps; }
+  uint32_t frameCount() const { return m_FrameCount; }
+  size_t propertyCount() const {
+    return m_FloatColumns.size() + m_ColorColumns.size();
+  }
+  // Number of properties the animation keys that the bake doesn't hold, which
+  // applying the bake would leave as they were.
+  uint32_t unbakedCount() const { return m_UnbakedCount; }
+  // Memory taken by the tables, for budgeting.
+  size_t byteSize() const;
+
+  // Whether artboard is the one baked or one of its instances: it has an
+  // object of the baked type at every baked property's index.
+  bool appliesTo(rive::Artboard *artboard) const;
+
+  // Applies the animation at time (in seconds, as kept by its instances),
+  // mixed with the current values like LinearAnimation::apply. Does nothing
+  // unless appliesTo(artboard).
+  void apply(rive::Artboard *artboard, float time, float mix) const;
+  // Like apply, for an artboard appliesTo() accepted already, as when binding
+  // the bake once to play it every frame.
+  void applyVerified(rive::Artboard *artboard, float time, float mix) const;
+};
+
+#endif
@@ -0,0 +1,251 @@
+#include "arena.hpp"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stddef.h>
+#include <stdlib.h>
+
+struct Arena::Chunk {
+  Chunk *next;
+};
+
+static const size_t alignment = alignof(max_align_t);
+static const size_t chunkHeaderSize = alignment;
+
+// Larger allocations are left to the heap, where deleting them frees them,
+// rather than each taking chunks of their own.
+static const size_t maxArenaAllocation = Arena::chunkSize / 4;
+
+static thread_local Arena *currentArena = nullptr;
+// Function-local statics being initialized on this thread; they outlive any
+// arena, so what they allocate goes to the heap.
+static thread_local int staticInitDepth = 0;
+static std::atomic<size_t> capacity{0};
+static std::atomic<size_t> freeCapacity{0};
+
+// Released chunks kept for later arenas; beyond these, they go back to the
+// heap.
+static const size_t maxFreeChunks = 16;
+
+// Chunks are aligned chunkSize pages, so the arena a pointer belongs to, if
+// any, is that of its page. Pages are looked up, on every delete and without
+// locking, in a two level table: wasm's 32 bit address space fits in a single
+// leaf, while native builds, used for benchmarking, cover 48 bits with leaves
+// made as they're first needed.
+static const int pageShift = 16;
+static_assert(Arena::chunkSize == (size_t)1 << pageShift, "page size");
+#if UINTPTR_MAX == UINT32_MAX
+static const int addressBits = 32;
+#else
+static const int addressBits = 48;
+#endif
+static const int leafBits = 16;
+static const int rootBits = addressBits - pageShift - leafBits;
+static const uintptr_t leafMask = ((uintptr_t)1 << leafBits) - 1;
+
+typedef std::atomic<Arena *> PageLeaf[(size_t)1 << leafBits];
+static std::atomic<PageLeaf *> pageRoot[(size_t)1 << rootBits];
+
+// Marks the pages of freed chunks, which are kept for reuse rather than
+// returned to the heap, so that deleting into them is caught.
+static uint8_t freedMarker;
+static Arena *const freedPages = (Arena *)&freedMarker;
+
+static Arena *arenaAt(const void *ptr) {
+  uintptr_t page = (uintptr_t)ptr >> pageShift;
+  if ((page >> leafBits) >> rootBits != 0) {
+    return nullptr;
+  }
+  PageLeaf *leaf =
+      pageRoot[page >> leafBits].load(std::memory_order_acquire);
+  if (leaf == nullptr) {
+    return nullptr;
+  }
+  return (*leaf)[page & leafMask].load(std::memory_order_acquire);
+}
+
+static void setArena(const void *chunk, Arena *arena) {
+  uintptr_t page = (uintptr_t)chunk >> pageShift;
+  if ((page >> leafBits) >> rootBits != 0) {
+    abort();
+  }
+  auto &root = pageRoot[page >> leafBits];
+  PageLeaf *leaf = root.load(std::memory_order_acquire);
+  if (leaf == nullptr) {
+    // calloc, as this runs from within operator new.
+    auto made = (PageLeaf *)calloc(1, sizeof(PageLeaf));
+    if (made == nullptr) {
+      abort();
+    }
+    if (root.compare_exchange_strong(leaf, made,
+                                     std::memory_order_acq_rel)) {
+      leaf = made;
+    } else {
+      free(made);
+    }
+  }
+  (*leaf)[page & leafMask].store(arena, std::memory_order_release);
+}
+
+// Freed chunks, reused oldest first so that their pages stay marked freed for
+// as long as possible.
+struct FreeChunk {
+  FreeChunk *next;
+};
+static FreeChunk *freeChunks = nullptr;
+static FreeChunk *lastFreeChunk = nullptr;
+static size_t freeChunkCount = 0;
+
+static std::mutex &freeChunksMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+static void *takeFreeChunk() {
+  std::lock_guard<std::mutex> lock(freeChunksMutex());
+  FreeChunk *chunk = freeChunks;
+  if (chunk != nullptr) {
+    freeChunks = chunk->next;
+    if (freeChunks == nullptr) {
+      lastFreeChunk = nullptr;
+    }
+    freeChunkCount--;
+    freeCapacity -= Arena::chunkSize;
+  }
+  return chunk;
+}
+
+static void addFreeChunk(void *memory) {
+  std::unique_lock<std::mutex> lock(freeChunksMutex());
+  if (freeChunkCount == maxFreeChunks) {
+    lock.unlock();
+    // Its page may be handed out again by the heap, so it no longer belongs
+    // to any arena.
+    setArena(memory, nullptr);
+    free(memory);
+    return;
+  }
+  setArena(memory, freedPages);
+  auto chunk = (FreeChunk *)memory;
+  chunk->next = nullptr;
+  if (lastFreeChunk == nullptr) {
+    freeChunks = chunk;
+  } else {
+    lastFreeChunk->next = chunk;
+  }
+  lastFreeChunk = chunk;
+  freeChunkCount++;
+  freeCapacity += Arena::chunkSize;
+}
+
+Arena::Scope::Scope(Arena *arena) : m_Previous(currentArena) {
+  currentArena = arena;
+}
+
+Arena::Scope::~Scope() { currentArena = m_Previous; }
+
+Arena::~Arena() {
+  while (m_Chunks != nullptr) {
+    Chunk *chunk = m_Chunks;
+    m_Chunks = chunk->next;
+    addFreeChunk(chunk);
+  }
+  capacity -= m_Capacity;
+}
+
+void *Arena::addChunk() {
+  static_assert(sizeof(Chunk) <= chunkHeaderSize, "chunk header");
+  auto chunk = (Chunk *)takeFreeChunk();
+  if (chunk == nullptr) {
+    chunk = (Chunk *)aligned_alloc(chunkSize, chunkSize);
+    if (chunk == nullptr) {
+      abort();
+    }
+  }
+  chunk->next = m_Chunks;
+  m_Chunks = chunk;
+  setArena(chunk, this);
+  m_Capacity += chunkSize;
+  capacity += chunkSize;
+  return (uint8_t *)chunk + chunkHeaderSize;
+}
+
+void *Arena::allocate(size_t size) {
+  size = std::max((size + alignment - 1) & ~(alignment - 1), alignment);
+  if ((size_t)(m_End - m_Next) < size) {
+    m_Next = (uint8_t *)addChunk();
+    m_End = m_Next + chunkSize - chunkHeaderSize;
+  }
+  m_Last = m_Next;
+  m_Next += size;
+  return m_Last;
+}
+
+void *Arena::allocateScoped(size_t size) {
+  Arena *arena = currentArena;
+  if (arena == nullptr || staticInitDepth != 0 || size > maxArenaAllocation) {
+    return nullptr;
+  }
+  return arena->allocate(size);
+}
+
+bool Arena::deallocate(void *ptr) {
+  if (ptr == nullptr) {
+    return false;
+  }
+  Arena *arena = arenaAt(ptr);
+  if (arena == nullptr) {
+    return false;
+  }
+  if (arena == freedPages) {
+    // Deleted after its arena's owner, which freed it already.
+    abort();
+  }
+  if (ptr == arena->m_Owner) {
+    delete arena;
+  } else if (arena == currentArena && ptr == arena->m_Last) {
+    // Scratch deleted right after it was made while building, like a
+    // temporary string, is given back.
+    arena->m_Next = arena->m_Last;
+    arena->m_Last = nullptr;
+  }
+  return true;
+}
+
+bool Arena::contains(const void *ptr) {
+  Arena *arena = arenaAt(ptr);
+  return arena != nullptr && arena != freedPages;
+}
+
+size_t Arena::totalCapacity() { return capacity; }
+
+size_t Arena::pooledCapacity() { return freeCapacity; }
+
+#ifdef RIVE_ARENA_GUARD_STATICS
+// Linked with --wrap for each of these, so that the allocations made while
+// initializing a function-local static, which must outlive whatever arena was
+// current when it was first reached, go to the heap instead.
+extern "C" {
+int __real___cxa_guard_acquire(uint64_t *guard);
+void __real___cxa_guard_release(uint64_t *guard);
+void __real___cxa_guard_abort(uint64_t *guard);
+
+int __wrap___cxa_guard_acquire(uint64_t *guard) {
+  int initialize = __real___cxa_guard_acquire(guard);
+  if (initialize != 0) {
+    staticInitDepth++;
+  }
+  return initialize;
+}
+
+void __wrap___cxa_guard_release(uint64_t *guard) {
+  staticInitDepth--;
+  __real___cxa_guard_release(guard);
+}
+
+void __wrap___cxa_guard_abort(uint64_t *guard) {
+  staticInitDepth--;
+  __real___cxa_guard_abort(guard);
+}
+}
+#endif
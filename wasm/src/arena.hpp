@@ -0,0 +1,100 @@
+#ifndef _RIVE_ARENA_HPP_
+#define _RIVE_ARENA_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bump allocator backing whole object graphs, like an imported file's
+// definitions or an artboard instance's components, which rive-cpp builds
+// from many small allocations through operator new.
+//
+// While a Scope is alive, operator new on its thread allocates from the
+// scope's arena (see operator_new.cpp), except for allocations over a quarter
+// of a chunk, which stay on the heap. Deleting an object living in an arena
+// runs its destructor but frees nothing, except for the arena's owner:
+// deleting it releases the whole arena once its destructor deleted everything
+// else. Arenas are made with make().
+//
+// Scratch freed while building, like a vector's buffer before it grew, stays
+// in the arena until then; only the most recent allocation is given back.
+// Up to 16 released chunks are kept for later arenas, the rest returned to the
+// heap; until kept chunks are reused, deleting anything in them aborts instead
+// of corrupting the heap.
+//
+// Only what the build itself makes belongs in the arena. Calls out to JS from
+// within a scope (like a JS render factory) open a null Scope, so that what
+// they allocate stays on the heap, and, where the link wraps
+// __cxa_guard_acquire (RIVE_ARENA_GUARD_STATICS), so does whatever
+// function-local statics first reached while building allocate.
+class Arena {
+public:
+  static const size_t chunkSize = 64 * 1024;
+
+  // Routes allocations on the calling thread to arena for its lifetime;
+  // null routes them to the heap.
+  class Scope {
+  private:
+    Arena *m_Previous;
+
+  public:
+    explicit Scope(Arena *arena);
+    ~Scope();
+  };
+
+private:
+  struct Chunk;
+  Chunk *m_Chunks = nullptr;
+  // Where the next allocation goes in the first chunk.
+  uint8_t *m_Next = nullptr;
+  uint8_t *m_End = nullptr;
+  // The most recent allocation, given back if it's deleted while building.
+  uint8_t *m_Last = nullptr;
+  const void *m_Owner = nullptr;
+  size_t m_Capacity = 0;
+
+  Arena() = default;
+  ~Arena();
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  void *allocate(size_t size);
+  // Adds a chunk, returning where its room for allocations starts.
+  void *addChunk();
+
+public:
+  // Calls build, allocating everything it makes on this thread from a new
+  // arena which is released when the object it returns is deleted, or right
+  // away if it returns null. The returned object must be allocated with a
+  // plain new within build.
+  template <typename Build> static auto make(Build build) -> decltype(build()) {
+    Arena *arena = new Arena();
+    decltype(build()) object;
+    {
+      Scope scope(arena);
+      object = build();
+    }
+    if (object == nullptr) {
+      delete arena;
+    } else {
+      arena->m_Owner = object;
+    }
+    return object;
+  }
+
+  // For operator new and delete: allocates from the calling thread's arena,
+  // returning null if no scope is alive, and ends the life of memory
+  // allocated from any arena, returning false if ptr isn't from one.
+  static void *allocateScoped(size_t size);
+  static bool deallocate(void *ptr);
+
+  // Whether ptr was allocated from an arena that's still alive.
+  static bool contains(const void *ptr);
+
+  // Bytes held by arenas still alive, for stats; chunks kept for reuse
+  // aren't counted.
+  static size_t totalCapacity();
+  // Bytes of released chunks kept for reuse.
+  static size_t pooledCapacity();
+};
+
+#endif
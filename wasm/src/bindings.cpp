@@ -1,3 +1,5 @@
+#include "advance_batch.hpp"
+#include "animation_bake.hpp"
 #include "animation/animation.hpp"
 #include "animation/animation_state.hpp"
 #include "animation/any_state.hpp"
@@ -10,19 +12,30 @@
 #include "animation/state_machine_instance.hpp"
 #include "animation/state_machine_number.hpp"
 #include "animation/state_machine_trigger.hpp"
+#include "arena.hpp"
 #include "artboard.hpp"
 #include "bones/bone.hpp"
 #include "bones/root_bone.hpp"
+#include "command_buffer_renderer.hpp"
 #include "component.hpp"
 #include "core.hpp"
 #include "core/binary_reader.hpp"
+#include "damage_tracker.hpp"
+#include "event_ring.hpp"
 #include "file.hpp"
+#include "file_importer.hpp"
+#include "flat_geometry.hpp"
+#include "frame_stats.hpp"
+#include "hit_tester.hpp"
 #include "layout.hpp"
 #include "math/mat2d.hpp"
+#include "mesh_renderer.hpp"
 #include "node.hpp"
 #include "renderer.hpp"
 #include "shapes/cubic_vertex.hpp"
 #include "shapes/path.hpp"
+#include "software_renderer.hpp"
+#include "thread_pool.hpp"
 #include "transform_component.hpp"
 #include <emscripten.h>
 #include <emscripten/bind.h>
@@ -46,6 +59,56 @@ const uint16_t stateMachineNumberTypeKey =
 const uint16_t stateMachineTriggerTypeKey =
     rive::StateMachineTriggerBase::typeKey;
 
+class RenderPathWrapper : public wrapper<RecordingRenderPath> {
+private:
+  uint32_t m_SyncedVersion = 0;
+
+public:
+  EMSCRIPTEN_WRAPPER(RenderPathWrapper);
+
+  // Verbs are recorded in wasm memory as rive-cpp builds the path and are only
+  // pushed to JS when the path is used and its geometry actually changed, in
+  // which case contiguous verbs are handed over as a single typed array view.
+  void sync() {
+    uint32_t version = validate();
+    if (version == m_SyncedVersion) {
+      return;
+    }
+    m_SyncedVersion = version;
+    for (auto subPath : m_SubPaths) {
+      static_cast<RenderPathWrapper *>(subPath)->sync();
+    }
+
+    call<void>("reset");
+    call<void>("fillRule", m_FillRule);
+    const uint32_t *words = m_Commands.data();
+    size_t index = 0, runStart = 0, length = m_Commands.size();
+    while (index < length) {
+      auto verb = (PathVerb)words[index];
+      if (verb != PathVerb::addPath) {
+        index += 1 + pathVerbArgumentCount(verb);
+        continue;
+      }
+      if (index > runStart) {
+        call<void>("addCommands", val(typed_memory_view(index - runStart,
+                                                        words + runStart)));
+      }
+      rive::Mat2D transform;
+      for (int i = 0; i < 6; i++) {
+        transform[i] = m_Commands.floatAt(index + 2 + i);
+      }
+      rive::RenderPath *subPath = m_SubPaths[words[index + 1]];
+      call<void>("addPath", subPath, transform);
+      index += 8;
+      runStart = index;
+    }
+    if (length > runStart) {
+      call<void>("addCommands",
+                 val(typed_memory_view(length - runStart, words + runStart)));
+    }
+  }
+};
+
 class RendererWrapper : public wrapper<rive::Renderer> {
 public:
   EMSCRIPTEN_WRAPPER(RendererWrapper);
@@ -59,95 +122,161 @@ public:
   }
 
   void drawPath(rive::RenderPath *path, rive::RenderPaint *paint) override {
+    static_cast<RenderPathWrapper *>(path)->sync();
     call<void>("drawPath", path, paint);
   }
 
   void clipPath(rive::RenderPath *path) override {
+    static_cast<RenderPathWrapper *>(path)->sync();
     call<void>("clipPath", path);
   }
 };
 
-class RenderPathWrapper : public wrapper<rive::RenderPath> {
+// Paint parameters are kept in wasm memory as well as being forwarded to JS,
+// so that wasm side consumers (e.g. damage tracking) can read them. Only
+// actual changes are forwarded: rive-cpp sets some parameters again as it
+// updates, and rebuilds animated gradients from scratch every frame even when
+// they end up the same. The JS paint starts out with RecordingRenderPaint's
+// defaults.
+class RenderPaintWrapper : public wrapper<RecordingRenderPaint> {
 public:
-  EMSCRIPTEN_WRAPPER(RenderPathWrapper);
-
-  void reset() override { call<void>("reset"); }
+  EMSCRIPTEN_WRAPPER(RenderPaintWrapper);
 
-  void addRenderPath(rive::RenderPath *path,
-                     const rive::Mat2D &transform) override {
-    call<void>("addPath", path, transform);
+  void color(unsigned int value) override {
+    uint32_t version = m_Version;
+    RecordingRenderPaint::color(value);
+    if (m_Version != version) {
+      call<void>("color", value);
+    }
   }
-  void fillRule(rive::FillRule value) override {
-    call<void>("fillRule", value);
+  void thickness(float value) override {
+    uint32_t version = m_Version;
+    RecordingRenderPaint::thickness(value);
+    if (m_Version != version) {
+      call<void>("thickness", value);
+    }
   }
-
-  void moveTo(float x, float y) override { call<void>("moveTo", x, y); }
-  void lineTo(float x, float y) override { call<void>("lineTo", x, y); }
-  void cubicTo(float ox, float oy, float ix, float iy, float x,
-               float y) override {
-    call<void>("cubicTo", ox, oy, ix, iy, x, y);
+  void join(rive::StrokeJoin value) override {
+    uint32_t version = m_Version;
+    RecordingRenderPaint::join(value);
+    if (m_Version != version) {
+      call<void>("join", value);
+    }
+  }
+  void cap(rive::StrokeCap value) override {
+    uint32_t version = m_Version;
+    RecordingRenderPaint::cap(value);
+    if (m_Version != version) {
+      call<void>("cap", value);
+    }
   }
-  void close() override { call<void>("close"); }
-};
-
-class RenderPaintWrapper : public wrapper<rive::RenderPaint> {
-public:
-  EMSCRIPTEN_WRAPPER(RenderPaintWrapper);
-
-  void color(unsigned int value) override { call<void>("color", value); }
-  void thickness(float value) override { call<void>("thickness", value); }
-  void join(rive::StrokeJoin value) override { call<void>("join", value); }
-  void cap(rive::StrokeCap value) override { call<void>("cap", value); }
   void blendMode(rive::BlendMode value) override {
-    call<void>("blendMode", value);
+    uint32_t version = m_Version;
+    RecordingRenderPaint::blendMode(value);
+    if (m_Version != version) {
+      call<void>("blendMode", value);
+    }
   }
 
   void style(rive::RenderPaintStyle value) override {
-    call<void>("style", value);
+    uint32_t version = m_Version;
+    RecordingRenderPaint::style(value);
+    if (m_Version != version) {
+      call<void>("style", value);
+    }
   }
+
+  // Gradients are built in wasm memory and only sent once completed, if
+  // different from the paint's current one.
   void linearGradient(float sx, float sy, float ex, float ey) override {
-    call<void>("linearGradient", sx, sy, ex, ey);
+    RecordingRenderPaint::linearGradient(sx, sy, ex, ey);
   }
   void radialGradient(float sx, float sy, float ex, float ey) override {
-    call<void>("radialGradient", sx, sy, ex, ey);
+    RecordingRenderPaint::radialGradient(sx, sy, ex, ey);
   }
   void addStop(unsigned int color, float stop) override {
-    call<void>("addStop", color, stop);
+    RecordingRenderPaint::addStop(color, stop);
   }
-  void completeGradient() override { call<void>("completeGradient"); }
+  void completeGradient() override {
+    uint32_t version = m_Version;
+    RecordingRenderPaint::completeGradient();
+    if (m_Version == version) {
+      return;
+    }
+    float sx = m_GradientStart[0], sy = m_GradientStart[1];
+    float ex = m_GradientEnd[0], ey = m_GradientEnd[1];
+    if (m_GradientType == GradientType::radial) {
+      call<void>("radialGradient", sx, sy, ex, ey);
+    } else {
+      call<void>("linearGradient", sx, sy, ex, ey);
+    }
+    for (const GradientStop &stop : m_Stops) {
+      call<void>("addStop", stop.color, stop.stop);
+    }
+    call<void>("completeGradient");
+  }
+};
+
+class CommandBufferRendererWrapper : public wrapper<CommandBufferRenderer> {
+public:
+  EMSCRIPTEN_WRAPPER(CommandBufferRendererWrapper);
 };
 
 namespace rive {
+// Paints and paths are made while an artboard is instanced into its arena,
+// but what the JS factory allocates isn't the artboard's to release.
 RenderPaint *makeRenderPaint() {
+  Arena::Scope heap(nullptr);
   val renderPaint =
       val::module_property("renderFactory").call<val>("makeRenderPaint");
   return renderPaint.as<RenderPaint *>(allow_raw_pointers());
 }
 
 RenderPath *makeRenderPath() {
+  Arena::Scope heap(nullptr);
   val renderPath =
       val::module_property("renderFactory").call<val>("makeRenderPath");
   return renderPath.as<RenderPath *>(allow_raw_pointers());
 }
 } // namespace rive
 
+// Wasm code can only read its own linear memory, and a JS ArrayBuffer can't be
+// adopted into it, so the caller's bytes are copied once, straight into the
+// importer's buffer. Callers that don't already hold the whole file avoid
+// buffering it in JS with loadStream or by writing to a FileImporter.
 rive::File *load(emscripten::val byteArray) {
-  std::vector<unsigned char> rv;
+  FileImporter importer;
 
   const auto l = byteArray["byteLength"].as<unsigned>();
-  rv.resize(l);
-
-  emscripten::val memoryView{emscripten::typed_memory_view(l, rv.data())};
+  uint8_t *bytes = importer.buffer(l);
+  if (bytes == nullptr) {
+    return nullptr;
+  }
+  emscripten::val memoryView{emscripten::typed_memory_view(l, bytes)};
   memoryView.call<void>("set", byteArray);
-  auto reader = rive::BinaryReader(rv.data(), rv.size());
-  rive::File *file = nullptr;
-  auto result = rive::File::import(reader, &file);
-  return file;
+  importer.commit(l);
+  return importer.importFile();
 }
 
 EMSCRIPTEN_BINDINGS(RiveWASM) {
   function("load", &load, allow_raw_pointers());
 
+  // Lets JS write a file's bytes straight into wasm memory, e.g. chunk by
+  // chunk from a stream; see loadStream in js/renderer.js.
+  class_<FileImporter>("FileImporter")
+      .constructor<>()
+      .function("reserve", &FileImporter::reserve)
+      .function("buffer",
+                optional_override([](FileImporter &self, size_t size) -> val {
+                  uint8_t *bytes = self.buffer(size);
+                  return bytes == nullptr
+                             ? val::null()
+                             : val(typed_memory_view(size, bytes));
+                }))
+      .function("commit", &FileImporter::commit)
+      .function("length", &FileImporter::length)
+      .function("importFile", &FileImporter::importFile, allow_raw_pointers());
+
 #ifdef ENABLE_QUERY_FLAT_VERTICES
   class_<rive::FlattenedPath>("FlattenedPath")
       .function("length",
@@ -194,6 +323,37 @@ EMSCRIPTEN_BINDINGS(RiveWASM) {
                       ->renderOut()[1];
                 }));
 
+  class_<FlatGeometry>("FlatGeometry")
+      .constructor<>()
+      .function("flattenAll", &FlatGeometry::flattenAll, allow_raw_pointers())
+      .function("selection",
+                optional_override([](FlatGeometry &self, size_t count) -> val {
+                  return val(typed_memory_view(count, self.selection(count)));
+                }))
+      .function("flattenSelection", &FlatGeometry::flattenSelection,
+                allow_raw_pointers())
+      .function("pathCount", &FlatGeometry::pathCount)
+      .function("vertexCount", &FlatGeometry::vertexCount)
+      .function("verbs", optional_override([](FlatGeometry &self) -> val {
+                  return val(
+                      typed_memory_view(self.vertexCount(), self.verbs()));
+                }))
+      .function("points", optional_override([](FlatGeometry &self) -> val {
+                  return val(typed_memory_view(
+                      self.vertexCount() * FlatGeometry::pointStride,
+                      self.points()));
+                }))
+      .function("pathOffsets",
+                optional_override([](FlatGeometry &self) -> val {
+                  return val(typed_memory_view(self.pathCount() + 1,
+                                               self.pathOffsets()));
+                }))
+      .function("pathObjects",
+                optional_override([](FlatGeometry &self) -> val {
+                  return val(typed_memory_view(self.pathCount(),
+                                               self.pathObjects()));
+                }));
+
 #endif
 
   class_<rive::Renderer>("Renderer")
@@ -210,22 +370,108 @@ EMSCRIPTEN_BINDINGS(RiveWASM) {
       .function("align", &rive::Renderer::align)
       .allow_subclass<RendererWrapper>("RendererWrapper");
 
-  class_<rive::RenderPath>("RenderPath")
-      .function("reset", &RenderPathWrapper::reset, pure_virtual(),
-                allow_raw_pointers())
-      .function("addPath", &RenderPathWrapper::addRenderPath, pure_virtual(),
-                allow_raw_pointers())
-      .function("fillRule", &RenderPathWrapper::fillRule, pure_virtual())
-      .function("moveTo", &RenderPathWrapper::moveTo, pure_virtual(),
-                allow_raw_pointers())
-      .function("lineTo", &RenderPathWrapper::lineTo, pure_virtual(),
-                allow_raw_pointers())
-      .function("cubicTo", &RenderPathWrapper::cubicTo, pure_virtual(),
-                allow_raw_pointers())
-      .function("close", &RenderPathWrapper::close, pure_virtual(),
+  class_<DamageTracker, base<rive::Renderer>>("DamageTracker")
+      .constructor<>()
+      .function("invalidate", &DamageTracker::invalidate)
+      .function("isFull", &DamageTracker::isFull)
+      .function("rects", optional_override([](DamageTracker &self) -> val {
+                  return val(typed_memory_view(self.rectCount() * 4,
+                                               self.rects()));
+                }));
+
+  class_<HitTester, base<rive::Renderer>>("HitTester")
+      .constructor<>()
+      .function("drawCount", &HitTester::drawCount);
+
+  // Counts what's drawn through it before forwarding it to its renderer.
+  class_<StatsRecorder, base<rive::Renderer>>("StatsRecorder")
+      .constructor<>()
+      .function("setRenderer",
+                select_overload<void(rive::Renderer *)>(
+                    &StatsRecorder::renderer),
                 allow_raw_pointers())
+      .function("beginDraw", &StatsRecorder::beginDraw)
+      .function("endFrame", &StatsRecorder::endFrame)
+      .function("last", &StatsRecorder::last);
+
+  class_<CommandBufferRenderer, base<rive::Renderer>>("CommandBufferRenderer")
+      .function("commands",
+                optional_override([](CommandBufferRenderer &self) -> val {
+                  const CommandBuffer &commands = self.commands();
+                  return val(
+                      typed_memory_view(commands.size(), commands.data()));
+                }))
+      .function("clear", &CommandBufferRenderer::clear)
+      .allow_subclass<CommandBufferRendererWrapper>(
+          "CommandBufferRendererWrapper");
+
+  // Renders on the CPU into RGBA pixels in wasm memory; the file must have
+  // been loaded with the software render factory.
+  class_<SoftwareRenderer, base<rive::Renderer>>("SoftwareRenderer")
+      .constructor<int, int>()
+      .function("width", &SoftwareRenderer::width)
+      .function("height", &SoftwareRenderer::height)
+      .function("resize", &SoftwareRenderer::resize)
+      .function("clear", &SoftwareRenderer::clear)
+      .function("pixels", optional_override([](SoftwareRenderer &self) -> val {
+                  return val(
+                      typed_memory_view(self.byteLength(), self.pixels()));
+                }))
+      .function("unpremultipliedPixels",
+                optional_override([](SoftwareRenderer &self) -> val {
+                  return val(typed_memory_view(self.byteLength(),
+                                               self.unpremultipliedPixels()));
+                }));
+
+  // Tessellates into triangle meshes for a GPU backend; the file must have
+  // been loaded with the software render factory.
+  class_<MeshRenderer, base<rive::Renderer>>("MeshRenderer")
+      .constructor<>()
+      .function("clear", &MeshRenderer::clear)
+      .function("vertexCount", &MeshRenderer::vertexCount)
+      .function("indexCount", &MeshRenderer::indexCount)
+      .function("drawCount", &MeshRenderer::drawCount)
+      .function("stopCount", &MeshRenderer::stopCount)
+      .function("vertices", optional_override([](MeshRenderer &self) -> val {
+                  return val(typed_memory_view(self.vertexCount() * 2,
+                                               self.vertices()));
+                }))
+      .function("indices", optional_override([](MeshRenderer &self) -> val {
+                  return val(
+                      typed_memory_view(self.indexCount(), self.indices()));
+                }))
+      .function("draws", optional_override([](MeshRenderer &self) -> val {
+                  return val(typed_memory_view(
+                      self.drawCount() * MeshRenderer::drawStride,
+                      self.draws()));
+                }))
+      .function("drawFloats",
+                optional_override([](MeshRenderer &self) -> val {
+                  return val(typed_memory_view(
+                      self.drawCount() * MeshRenderer::drawFloatStride,
+                      self.drawFloats()));
+                }))
+      .function("stopColors",
+                optional_override([](MeshRenderer &self) -> val {
+                  return val(
+                      typed_memory_view(self.stopCount(), self.stopColors()));
+                }))
+      .function("stopOffsets",
+                optional_override([](MeshRenderer &self) -> val {
+                  return val(
+                      typed_memory_view(self.stopCount(), self.stopOffsets()));
+                }));
+
+  class_<rive::RenderPath>("RenderPath")
       .allow_subclass<RenderPathWrapper>("RenderPathWrapper");
 
+  class_<CommandBufferRenderPath, base<rive::RenderPath>>(
+      "CommandBufferRenderPath")
+      .constructor<>();
+
+  class_<SoftwareRenderPath, base<rive::RenderPath>>("SoftwareRenderPath")
+      .constructor<>();
+
   enum_<rive::RenderPaintStyle>("RenderPaintStyle")
       .value("fill", rive::RenderPaintStyle::fill)
       .value("stroke", rive::RenderPaintStyle::stroke);
@@ -286,6 +532,13 @@ EMSCRIPTEN_BINDINGS(RiveWASM) {
                 pure_virtual(), allow_raw_pointers())
       .allow_subclass<RenderPaintWrapper>("RenderPaintWrapper");
 
+  class_<CommandBufferRenderPaint, base<rive::RenderPaint>>(
+      "CommandBufferRenderPaint")
+      .constructor<>();
+
+  class_<SoftwareRenderPaint, base<rive::RenderPaint>>("SoftwareRenderPaint")
+      .constructor<>();
+
   class_<rive::Mat2D>("Mat2D")
       .property("xx", &rive::Mat2D::xx)
       .property("xy", &rive::Mat2D::xy)
@@ -330,6 +583,52 @@ EMSCRIPTEN_BINDINGS(RiveWASM) {
 #endif
       .property("name", select_overload<const std::string &() const>(
                             &rive::Artboard::name))
+      // Draws the artboard into the tracker, returning the number of damaged
+      // rectangles since the last call.
+      .function("damage",
+                optional_override([](rive::Artboard &self,
+                                     DamageTracker *tracker) -> size_t {
+                  tracker->beginFrame();
+                  self.draw(tracker);
+                  return tracker->endFrame();
+                }),
+                allow_raw_pointers())
+      // Draws the artboard into the tester, refitting its hierarchy to what
+      // changed; call once per frame that hit tests.
+      .function("updateHitTester",
+                optional_override([](rive::Artboard &self, HitTester *tester) {
+                  tester->update(&self);
+                }),
+                allow_raw_pointers())
+      // Object index of the topmost shape at x, y in canvas pixels, or -1.
+      .function("hitTest",
+                optional_override([](rive::Artboard &self, HitTester *tester,
+                                     float x, float y) -> int32_t {
+                  if (!tester->isUpdatedFrom(&self)) {
+                    tester->update(&self);
+                  }
+                  return tester->hitTest(x, y);
+                }),
+                allow_raw_pointers())
+      .function("objectName",
+                optional_override(
+                    [](rive::Artboard &self, size_t index) -> std::string {
+                      const auto &objects = self.objects();
+                      auto object =
+                          index < objects.size() ? objects[index] : nullptr;
+                      if (object == nullptr ||
+                          !object->is<rive::Component>()) {
+                        return "";
+                      }
+                      return object->as<rive::Component>()->name();
+                    }))
+      // Instances share the file's definitions and are owned by the caller;
+      // each gets an arena of its own, released when it's deleted.
+      .function("instance",
+                optional_override([](rive::Artboard &self) -> rive::Artboard * {
+                  return Arena::make([&self]() { return self.instance(); });
+                }),
+                allow_raw_pointers())
       .function("advance", &rive::Artboard::advance)
       .function("draw", &rive::Artboard::draw, allow_raw_pointers())
       .function("transformComponent",
@@ -441,25 +740,93 @@ EMSCRIPTEN_BINDINGS(RiveWASM) {
                 allow_raw_pointers())
       .function("stateChangedCount",
                 &rive::StateMachineInstance::stateChangedCount)
-      .function(
-          "stateChangedNameByIndex",
-          optional_override([](rive::StateMachineInstance &self,
-                               size_t index) -> std::string {
-            const rive::LayerState *state = self.stateChangedByIndex(index);
-            if (state != nullptr)
-              switch (state->coreType()) {
-              case rive::AnimationState::typeKey:
-                return state->as<rive::AnimationState>()->animation()->name();
-              case rive::EntryState::typeKey:
-                return "entry";
-              case rive::ExitState::typeKey:
-                return "exit";
-              case rive::AnyState::typeKey:
-                return "any";
-              }
-            return "unknown";
-          }),
-          allow_raw_pointers());
+      .function("stateChangedNameByIndex",
+                optional_override([](rive::StateMachineInstance &self,
+                                     size_t index) -> std::string {
+                  return layerStateName(self.stateChangedByIndex(index));
+                }),
+                allow_raw_pointers());
+
+  class_<AnimationBake>("AnimationBake")
+      .constructor<rive::Artboard *, rive::LinearAnimation *, float>()
+      .function("fps", &AnimationBake::fps)
+      .function("frameCount", &AnimationBake::frameCount)
+      .function("propertyCount", &AnimationBake::propertyCount)
+      .function("unbakedCount", &AnimationBake::unbakedCount)
+      .function("byteSize", &AnimationBake::byteSize)
+      .function("appliesTo", &AnimationBake::appliesTo, allow_raw_pointers())
+      .function("apply", &AnimationBake::apply, allow_raw_pointers());
+
+  class_<BatchedArtboard>("BatchedArtboard")
+      .constructor<rive::Artboard *>()
+      .function("setArtboard",
+                select_overload<void(rive::Artboard *)>(
+                    &BatchedArtboard::artboard),
+                allow_raw_pointers())
+      .function("addAnimation", &BatchedArtboard::addAnimation,
+                allow_raw_pointers())
+      .function("removeAnimation", &BatchedArtboard::removeAnimation,
+                allow_raw_pointers())
+      .function("playAnimation", &BatchedArtboard::playAnimation,
+                allow_raw_pointers())
+      .function("scrubAnimation", &BatchedArtboard::scrubAnimation,
+                allow_raw_pointers())
+      .function("bakeAnimation", &BatchedArtboard::bakeAnimation,
+                allow_raw_pointers())
+      .function("addStateMachine", &BatchedArtboard::addStateMachine,
+                allow_raw_pointers())
+      .function("removeStateMachine", &BatchedArtboard::removeStateMachine,
+                allow_raw_pointers())
+      .function("playStateMachine", &BatchedArtboard::playStateMachine,
+                allow_raw_pointers())
+      .function("inputWrites",
+                optional_override([](BatchedArtboard &self,
+                                     rive::StateMachineInstance *instance,
+                                     size_t count) -> val {
+                  float *pairs = self.inputWrites(instance, count);
+                  return pairs == nullptr
+                             ? val::null()
+                             : val(typed_memory_view(count * 2, pairs));
+                }),
+                allow_raw_pointers())
+      .function("applyInputWrites", &BatchedArtboard::applyInputWrites,
+                allow_raw_pointers())
+      .function("setStats",
+                select_overload<void(StatsRecorder *)>(&BatchedArtboard::stats),
+                allow_raw_pointers())
+      .function("advance", &BatchedArtboard::advance)
+      .function("events", optional_override([](BatchedArtboard &self) -> val {
+                  return val(typed_memory_view(
+                      EventRing::capacity * EventRing::stride,
+                      self.events().events()));
+                }))
+      .function("eventsWritten",
+                optional_override([](BatchedArtboard &self) {
+                  return self.events().written();
+                }))
+      .function("eventName",
+                optional_override(
+                    [](BatchedArtboard &self, uint32_t id) -> std::string {
+                      return self.events().name(id);
+                    }));
+
+  class_<AdvanceBatch>("AdvanceBatch")
+      .constructor<>()
+      .function("add", &AdvanceBatch::add, allow_raw_pointers())
+      .function("remove", &AdvanceBatch::remove)
+      .function("elapsed", optional_override([](AdvanceBatch &self) -> val {
+                  return val(typed_memory_view(self.size(), self.elapsed()));
+                }))
+      .function("results", optional_override([](AdvanceBatch &self) -> val {
+                  return val(typed_memory_view(self.size(), self.results()));
+                }))
+      .function("threadCount",
+                select_overload<size_t() const>(&AdvanceBatch::threadCount))
+      .function("setThreadCount",
+                select_overload<void(size_t)>(&AdvanceBatch::threadCount))
+      .class_function("hardwareThreadCount",
+                      &ThreadPool::hardwareThreadCount)
+      .function("advance", &AdvanceBatch::advance);
 
   class_<rive::SMIInput>("SMIInput")
       .property("type", &rive::SMIInput::inputCoreType)
@@ -531,4 +898,15 @@ EMSCRIPTEN_BINDINGS(RiveWASM) {
       .field("minY", &rive::AABB::minY)
       .field("maxX", &rive::AABB::maxX)
       .field("maxY", &rive::AABB::maxY);
+
+  value_object<FrameStats>("FrameStats")
+      .field("pathsDrawn", &FrameStats::pathsDrawn)
+      .field("pathVerbs", &FrameStats::pathVerbs)
+      .field("clips", &FrameStats::clips)
+      .field("saveDepth", &FrameStats::saveDepth)
+      .field("gradientsRebuilt", &FrameStats::gradientsRebuilt)
+      .field("pathsRebuilt", &FrameStats::pathsRebuilt)
+      .field("advanceMicros", &FrameStats::advanceMicros)
+      .field("applyMicros", &FrameStats::applyMicros)
+      .field("drawMicros", &FrameStats::drawMicros);
 }
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef _RIVE_COMMAND_BUFFER_HPP_
+#define _RIVE_COMMAND_BUFFER_HPP_
+
+#include "math/mat2d.hpp"
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+
+// Growable stream of 32 bit words. Opcodes, ids and enum values are written as
+// unsigned integers and arguments as floats, bit-cast into the same words so
+// that JS can read the stream through a Uint32Array and a Float32Array viewing
+// the same range of the wasm heap.
+class CommandBuffer {
+private:
+  std::vector<uint32_t> m_Words;
+
+public:
+  void clear() { m_Words.clear(); }
+  bool empty() const { return m_Words.empty(); }
+  size_t size() const { return m_Words.size(); }
+  const uint32_t *data() const { return m_Words.data(); }
+
+  uint32_t operator[](size_t index) const { return m_Words[index]; }
+  uint32_t &operator[](size_t index) { return m_Words[index]; }
+
+  void writeUint(uint32_t value) { m_Words.push_back(value); }
+
+  void writeFloat(float value) { m_Words.push_back(floatToWord(value)); }
+
+  void writeMatrix(const rive::Mat2D &matrix) {
+    for (int i = 0; i < 6; i++) {
+      writeFloat(matrix[i]);
+    }
+  }
+
+  void append(const uint32_t *words, size_t count) {
+    m_Words.insert(m_Words.end(), words, words + count);
+  }
+
+  float floatAt(size_t index) const { return wordToFloat(m_Words[index]); }
+
+  static uint32_t floatToWord(float value) {
+    uint32_t word;
+    std::memcpy(&word, &value, sizeof(word));
+    return word;
+  }
+
+  static float wordToFloat(uint32_t word) {
+    float value;
+    std::memcpy(&value, &word, sizeof(value));
+    return value;
+  }
+};
+
+#endif
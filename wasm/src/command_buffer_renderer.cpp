@@ -0,0 +1,134 @@
+#include "command_buffer_renderer.hpp"
+
+// Ids are recycled so that JS can keep its per-id caches in dense arrays. A
+// recycled id always starts at a version the renderer hasn't seen for it, so
+// its definition is written before it's next drawn.
+class IdPool {
+private:
+  std::vector<uint32_t> m_Free;
+  uint32_t m_Next = 0;
+
+public:
+  uint32_t acquire() {
+    if (m_Free.empty()) {
+      return m_Next++;
+    }
+    uint32_t id = m_Free.back();
+    m_Free.pop_back();
+    return id;
+  }
+  void release(uint32_t id) { m_Free.push_back(id); }
+};
+
+static IdPool pathIds;
+static IdPool paintIds;
+static uint32_t nextRendererId = 1;
+
+CommandBufferRenderPath::CommandBufferRenderPath()
+    : CommandBufferResource(pathIds.acquire()) {}
+
+CommandBufferRenderPath::~CommandBufferRenderPath() { pathIds.release(id()); }
+
+CommandBufferRenderPaint::CommandBufferRenderPaint()
+    : CommandBufferResource(paintIds.acquire()) {}
+
+CommandBufferRenderPaint::~CommandBufferRenderPaint() {
+  paintIds.release(id());
+}
+
+CommandBufferRenderer::CommandBufferRenderer() : m_Id(nextRendererId++) {}
+
+void CommandBufferRenderer::save() {
+  m_Stream.writeUint((uint32_t)DrawOp::save);
+}
+
+void CommandBufferRenderer::restore() {
+  m_Stream.writeUint((uint32_t)DrawOp::restore);
+}
+
+void CommandBufferRenderer::transform(const rive::Mat2D &transform) {
+  m_Stream.writeUint((uint32_t)DrawOp::transform);
+  m_Stream.writeMatrix(transform);
+}
+
+void CommandBufferRenderer::drawPath(rive::RenderPath *path,
+                                     rive::RenderPaint *paint) {
+  auto bufferedPath = static_cast<CommandBufferRenderPath *>(path);
+  auto bufferedPaint = static_cast<CommandBufferRenderPaint *>(paint);
+  writePath(bufferedPath);
+  writePaint(bufferedPaint);
+  m_Stream.writeUint((uint32_t)DrawOp::drawPath);
+  m_Stream.writeUint(bufferedPath->id());
+  m_Stream.writeUint(bufferedPaint->id());
+}
+
+void CommandBufferRenderer::clipPath(rive::RenderPath *path) {
+  auto bufferedPath = static_cast<CommandBufferRenderPath *>(path);
+  writePath(bufferedPath);
+  m_Stream.writeUint((uint32_t)DrawOp::clipPath);
+  m_Stream.writeUint(bufferedPath->id());
+}
+
+void CommandBufferRenderer::writePath(CommandBufferRenderPath *path) {
+  uint32_t version = path->validate();
+  if (!path->needsEmit(m_Id, version)) {
+    return;
+  }
+  const auto &subPaths = path->subPaths();
+  // Sub paths must be defined before the path that composes them.
+  for (auto subPath : subPaths) {
+    writePath(static_cast<CommandBufferRenderPath *>(subPath));
+  }
+
+  m_Stream.writeUint((uint32_t)DrawOp::updatePath);
+  m_Stream.writeUint(path->id());
+  m_Stream.writeUint((uint32_t)path->fillRule());
+  size_t countIndex = m_Stream.size();
+  m_Stream.writeUint(0);
+
+  const CommandBuffer &commands = path->commands();
+  size_t index = 0, length = commands.size();
+  while (index < length) {
+    auto verb = (PathVerb)commands[index];
+    if (verb == PathVerb::addPath) {
+      auto subPath =
+          static_cast<CommandBufferRenderPath *>(subPaths[commands[index + 1]]);
+      m_Stream.writeUint((uint32_t)PathVerb::addPath);
+      m_Stream.writeUint(subPath->id());
+      m_Stream.append(commands.data() + index + 2, 6);
+      index += 8;
+    } else {
+      size_t count = 1 + pathVerbArgumentCount(verb);
+      m_Stream.append(commands.data() + index, count);
+      index += count;
+    }
+  }
+  m_Stream[countIndex] = (uint32_t)(m_Stream.size() - countIndex - 1);
+  path->emitted(m_Id, version);
+}
+
+void CommandBufferRenderer::writePaint(CommandBufferRenderPaint *paint) {
+  if (!paint->needsEmit(m_Id, paint->version())) {
+    return;
+  }
+  m_Stream.writeUint((uint32_t)DrawOp::updatePaint);
+  m_Stream.writeUint(paint->id());
+  m_Stream.writeUint((uint32_t)paint->style());
+  m_Stream.writeUint(paint->color());
+  m_Stream.writeFloat(paint->thickness());
+  m_Stream.writeUint((uint32_t)paint->join());
+  m_Stream.writeUint((uint32_t)paint->cap());
+  m_Stream.writeUint((uint32_t)paint->blendMode());
+  m_Stream.writeUint((uint32_t)paint->gradientType());
+  m_Stream.writeFloat(paint->gradientStart()[0]);
+  m_Stream.writeFloat(paint->gradientStart()[1]);
+  m_Stream.writeFloat(paint->gradientEnd()[0]);
+  m_Stream.writeFloat(paint->gradientEnd()[1]);
+  const auto &stops = paint->stops();
+  m_Stream.writeUint((uint32_t)stops.size());
+  for (const auto &stop : stops) {
+    m_Stream.writeUint(stop.color);
+    m_Stream.writeFloat(stop.stop);
+  }
+  paint->emitted(m_Id, paint->version());
+}
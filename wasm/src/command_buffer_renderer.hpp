@@ -0,0 +1,94 @@
+#ifndef _RIVE_COMMAND_BUFFER_RENDERER_HPP_
+#define _RIVE_COMMAND_BUFFER_RENDERER_HPP_
+
+#include "command_buffer.hpp"
+#include "recording_render_paint.hpp"
+#include "recording_render_path.hpp"
+#include "renderer.hpp"
+
+// Opcodes written to a CommandBufferRenderer's stream, followed by:
+//  save, restore:  nothing
+//  transform:      xx, xy, yx, yy, tx, ty
+//  drawPath:       path id, paint id
+//  clipPath:       path id
+//  updatePath:     path id, fill rule, word count, path verbs (addPath verbs
+//                  reference the sub path by id rather than by index)
+//  updatePaint:    paint id, style, color, thickness, join, cap, blend mode,
+//                  gradient type, sx, sy, ex, ey, stop count, (color, stop)*
+// Keep in sync with the replay loop in js/renderer.js.
+enum class DrawOp : uint32_t {
+  save = 0,
+  restore = 1,
+  transform = 2,
+  drawPath = 3,
+  clipPath = 4,
+  updatePath = 5,
+  updatePaint = 6
+};
+
+// Tracks which renderer last received an object's definition and at which
+// version, so that definitions are only re-sent when they changed.
+class CommandBufferResource {
+private:
+  uint32_t m_Id;
+  uint32_t m_EmittedRenderer = 0;
+  uint32_t m_EmittedVersion = 0;
+
+protected:
+  explicit CommandBufferResource(uint32_t id) : m_Id(id) {}
+
+public:
+  uint32_t id() const { return m_Id; }
+  bool needsEmit(uint32_t renderer, uint32_t version) const {
+    return m_EmittedRenderer != renderer || m_EmittedVersion != version;
+  }
+  void emitted(uint32_t renderer, uint32_t version) {
+    m_EmittedRenderer = renderer;
+    m_EmittedVersion = version;
+  }
+};
+
+class CommandBufferRenderPath : public RecordingRenderPath,
+                                public CommandBufferResource {
+public:
+  CommandBufferRenderPath();
+  ~CommandBufferRenderPath();
+};
+
+class CommandBufferRenderPaint : public RecordingRenderPaint,
+                                 public CommandBufferResource {
+public:
+  CommandBufferRenderPaint();
+  ~CommandBufferRenderPaint();
+};
+
+// Renderer that writes a whole frame into a packed command stream in wasm
+// memory. Paths and paints are referenced by id and their definitions are only
+// written when they changed since this renderer last saw them. JS replays the
+// stream in one pass, so a frame costs a single wasm/JS crossing instead of one
+// per verb. Only works with paths and paints made by the command buffer render
+// factory.
+class CommandBufferRenderer : public rive::Renderer {
+private:
+  CommandBuffer m_Stream;
+  uint32_t m_Id;
+
+  void writePath(CommandBufferRenderPath *path);
+  void writePaint(CommandBufferRenderPaint *paint);
+
+public:
+  CommandBufferRenderer();
+
+  void save() override;
+  void restore() override;
+  void transform(const rive::Mat2D &transform) override;
+  void drawPath(rive::RenderPath *path, rive::RenderPaint *paint) override;
+  void clipPath(rive::RenderPath *path) override;
+
+  const CommandBuffer &commands() const { return m_Stream; }
+
+  // Discards the recorded commands once they've been replayed.
+  void clear() { m_Stream.clear(); }
+};
+
+#endif
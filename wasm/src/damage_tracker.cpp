@@ -0,0 +1,180 @@
+#include "damage_tracker.hpp"
+#include "flat_path.hpp"
+#include "fnv_hash.hpp"
+#include "recording_render_paint.hpp"
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+
+// Beyond this many rectangles, clipping to them costs more than redrawing
+// everything saves.
+static const size_t maxDamageRects = 16;
+
+void DamageTracker::save() {
+  if (m_InFrame) {
+    m_Stack.push_back(m_State);
+  }
+}
+
+void DamageTracker::restore() {
+  if (m_InFrame && !m_Stack.empty()) {
+    m_State = m_Stack.back();
+    m_Stack.pop_back();
+  }
+}
+
+void DamageTracker::transform(const rive::Mat2D &transform) {
+  if (!m_InFrame) {
+    m_View = transform;
+    m_IsInvalid = true;
+    return;
+  }
+  rive::Mat2D result;
+  rive::Mat2D::multiply(result, m_State.transform, transform);
+  m_State.transform = result;
+}
+
+DamageTracker::Rect DamageTracker::deviceBounds(const PathBounds &bounds,
+                                                float outset) const {
+  const rive::Mat2D &m = m_State.transform;
+  float minX = bounds.minX - outset, minY = bounds.minY - outset;
+  float maxX = bounds.maxX + outset, maxY = bounds.maxY + outset;
+  const float corners[8] = {minX, minY, maxX, minY, maxX, maxY, minX, maxY};
+  Rect rect = {FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX};
+  for (int i = 0; i < 8; i += 2) {
+    float x = m[0] * corners[i] + m[2] * corners[i + 1] + m[4];
+    float y = m[1] * corners[i] + m[3] * corners[i + 1] + m[5];
+    rect.minX = std::min(rect.minX, x);
+    rect.minY = std::min(rect.minY, y);
+    rect.maxX = std::max(rect.maxX, x);
+    rect.maxY = std::max(rect.maxY, y);
+  }
+  // Leave room for anti-aliasing and snap to whole pixels.
+  rect.minX = floorf(std::max(rect.minX, m_State.clip.minX) - 1.0f);
+  rect.minY = floorf(std::max(rect.minY, m_State.clip.minY) - 1.0f);
+  rect.maxX = ceilf(std::min(rect.maxX, m_State.clip.maxX) + 1.0f);
+  rect.maxY = ceilf(std::min(rect.maxY, m_State.clip.maxY) + 1.0f);
+  return rect;
+}
+
+void DamageTracker::drawPath(rive::RenderPath *path,
+                             rive::RenderPaint *paint) {
+  if (!m_InFrame) {
+    return;
+  }
+  // Our factories only hand out recording paths and paints.
+  auto recordedPath = static_cast<RecordingRenderPath *>(path);
+  auto recordedPaint = static_cast<RecordingRenderPaint *>(paint);
+  uint32_t version = recordedPath->validate();
+  const PathBounds &bounds = recordedPath->bounds();
+  if (bounds.isEmpty()) {
+    return;
+  }
+
+  float outset = 0.0f;
+  if (recordedPaint->style() == rive::RenderPaintStyle::stroke) {
+    float halfThickness = recordedPaint->thickness() / 2.0f;
+    if (recordedPaint->join() == rive::StrokeJoin::miter) {
+      outset = halfThickness * miterLimit;
+    } else if (recordedPaint->cap() == rive::StrokeCap::square) {
+      outset = halfThickness * (float)M_SQRT2;
+    } else {
+      outset = halfThickness;
+    }
+  }
+
+  uint64_t signature = hashPointer(fnvOffsetBasis, recordedPath);
+  signature = hashWord(signature, version);
+  signature = hashPointer(signature, recordedPaint);
+  signature = hashWord(signature, recordedPaint->version());
+  signature = hashMatrix(signature, m_State.transform);
+  signature = hashWord(signature, (uint32_t)m_State.clipHash);
+  signature = hashWord(signature, (uint32_t)(m_State.clipHash >> 32));
+  m_Items.push_back({signature, deviceBounds(bounds, outset)});
+}
+
+void DamageTracker::clipPath(rive::RenderPath *path) {
+  if (!m_InFrame) {
+    return;
+  }
+  auto recordedPath = static_cast<RecordingRenderPath *>(path);
+  uint32_t version = recordedPath->validate();
+  const PathBounds &bounds = recordedPath->bounds();
+  Rect rect = bounds.isEmpty() ? Rect{0.0f, 0.0f, 0.0f, 0.0f}
+                               : deviceBounds(bounds, 0.0f);
+  m_State.clip = {std::max(rect.minX, m_State.clip.minX),
+                  std::max(rect.minY, m_State.clip.minY),
+                  std::min(rect.maxX, m_State.clip.maxX),
+                  std::min(rect.maxY, m_State.clip.maxY)};
+  uint64_t hash = hashPointer(m_State.clipHash, recordedPath);
+  hash = hashWord(hash, version);
+  m_State.clipHash = hashMatrix(hash, m_State.transform);
+}
+
+void DamageTracker::beginFrame() {
+  m_InFrame = true;
+  m_Stack.clear();
+  m_Items.clear();
+  m_State.transform = m_View;
+  m_State.clip = {-FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX};
+  m_State.clipHash = fnvOffsetBasis;
+}
+
+// Keeps the damaged rectangles disjoint as they're added: a new rectangle
+// absorbs every one it overlaps, and those the grown rectangle then overlaps.
+// Past maxDamageRects the whole canvas is damaged instead.
+void DamageTracker::addDamage(Rect rect) {
+  if (m_IsFull || !(rect.minX < rect.maxX && rect.minY < rect.maxY)) {
+    return;
+  }
+  size_t i = 0;
+  while (i < m_Damage.size()) {
+    const Rect &other = m_Damage[i];
+    if (rect.minX > other.maxX || other.minX > rect.maxX ||
+        rect.minY > other.maxY || other.minY > rect.maxY) {
+      i++;
+      continue;
+    }
+    rect = {std::min(rect.minX, other.minX), std::min(rect.minY, other.minY),
+            std::max(rect.maxX, other.maxX), std::max(rect.maxY, other.maxY)};
+    m_Damage[i] = m_Damage.back();
+    m_Damage.pop_back();
+    // The grown rectangle may now reach ones already passed.
+    i = 0;
+  }
+  if (m_Damage.size() == maxDamageRects) {
+    m_IsFull = true;
+    m_Damage.clear();
+    return;
+  }
+  m_Damage.push_back(rect);
+}
+
+size_t DamageTracker::endFrame() {
+  m_InFrame = false;
+  m_Damage.clear();
+  m_IsFull = m_IsInvalid;
+  m_IsInvalid = false;
+  if (!m_IsFull) {
+    // Draws are matched up by order; anything drawn differently, or not at
+    // all in one of the frames, damages where it was and where it is now.
+    size_t count = std::max(m_Items.size(), m_PreviousItems.size());
+    for (size_t i = 0; i < count && !m_IsFull; i++) {
+      bool isCurrent = i < m_Items.size();
+      bool isPrevious = i < m_PreviousItems.size();
+      if (isCurrent && isPrevious &&
+          m_Items[i].signature == m_PreviousItems[i].signature) {
+        continue;
+      }
+      if (isCurrent) {
+        addDamage(m_Items[i].bounds);
+      }
+      if (isPrevious) {
+        addDamage(m_PreviousItems[i].bounds);
+      }
+    }
+  }
+  std::swap(m_Items, m_PreviousItems);
+  m_Items.clear();
+  return m_Damage.size();
+}
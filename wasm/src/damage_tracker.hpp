@@ -0,0 +1,77 @@
+#ifndef _RIVE_DAMAGE_TRACKER_HPP_
+#define _RIVE_DAMAGE_TRACKER_HPP_
+
+#include "math/mat2d.hpp"
+#include "recording_render_path.hpp"
+#include "renderer.hpp"
+#include <stdint.h>
+#include <vector>
+
+// Works out which parts of the canvas changed between two frames. An artboard
+// is drawn into the tracker, which records the device space bounds of every
+// draw along with a signature of what was drawn (path and paint versions,
+// transform and clip). Draws whose signature changed since the previous frame
+// damage both their old and new bounds; a backend then only needs to clear
+// and redraw the damaged rectangles.
+//
+// Outside of a frame, transform() sets the view transform, so calling align()
+// positions the tracker like the renderer it shadows; this also invalidates
+// the whole canvas.
+class DamageTracker : public rive::Renderer {
+private:
+  struct Rect {
+    float minX, minY, maxX, maxY;
+  };
+  struct DrawItem {
+    uint64_t signature;
+    Rect bounds;
+  };
+  struct State {
+    rive::Mat2D transform;
+    Rect clip;
+    uint64_t clipHash;
+  };
+
+  rive::Mat2D m_View;
+  State m_State;
+  std::vector<State> m_Stack;
+  std::vector<DrawItem> m_Items;
+  std::vector<DrawItem> m_PreviousItems;
+  std::vector<Rect> m_Damage;
+  bool m_InFrame = false;
+  bool m_IsInvalid = true;
+  bool m_IsFull = true;
+
+  Rect deviceBounds(const PathBounds &bounds, float outset) const;
+  void addDamage(Rect rect);
+
+public:
+  void save() override;
+  void restore() override;
+  void transform(const rive::Mat2D &transform) override;
+  void drawPath(rive::RenderPath *path, rive::RenderPaint *paint) override;
+  void clipPath(rive::RenderPath *path) override;
+
+  // Damages the whole canvas on the next frame, e.g. after it was cleared.
+  void invalidate() { m_IsInvalid = true; }
+
+  // Call before drawing a frame into the tracker.
+  void beginFrame();
+
+  // Call after drawing a frame into the tracker; returns the number of
+  // damaged rectangles.
+  size_t endFrame();
+
+  // Whether the last frame damaged the whole canvas, in which case there are
+  // no rectangles: it was invalidated, or damaged in more places than are
+  // worth redrawing separately.
+  bool isFull() const { return m_IsFull; }
+
+  // Damaged rectangles as minX, minY, maxX, maxY in device pixels.
+  const float *rects() const {
+    return reinterpret_cast<const float *>(m_Damage.data());
+  }
+  size_t rectCount() const { return m_Damage.size(); }
+};
+
+#endif
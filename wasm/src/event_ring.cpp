@@ -0,0 +1,73 @@
+#include "event_ring.hpp"
+#include "animation/animation_state.hpp"
+#include "animation/any_state.hpp"
+#include "animation/entry_state.hpp"
+#include "animation/exit_state.hpp"
+
+std::string layerStateName(const rive::LayerState *state) {
+  if (state != nullptr) {
+    switch (state->coreType()) {
+    case rive::AnimationState::typeKey: {
+      auto animation = state->as<rive::AnimationState>()->animation();
+      if (animation != nullptr) {
+        return animation->name();
+      }
+      break;
+    }
+    case rive::EntryState::typeKey:
+      return "entry";
+    case rive::ExitState::typeKey:
+      return "exit";
+    case rive::AnyState::typeKey:
+      return "any";
+    }
+  }
+  return "unknown";
+}
+
+uint32_t EventRing::intern(const std::string &name) {
+  auto found = m_NameIds.find(name);
+  if (found != m_NameIds.end()) {
+    return found->second;
+  }
+  auto id = (uint32_t)m_Names.size();
+  m_Names.push_back(name);
+  m_NameIds.emplace(name, id);
+  return id;
+}
+
+void EventRing::write(EventType type, uint32_t nameId) {
+  uint32_t *event = &m_Events[(m_Written % capacity) * stride];
+  event[0] = (uint32_t)type;
+  event[1] = nameId;
+  m_Written++;
+}
+
+void EventRing::stateChanged(const rive::LayerState *state) {
+  auto found = m_ObjectIds.find(state);
+  uint32_t id;
+  if (found != m_ObjectIds.end()) {
+    id = found->second;
+  } else {
+    id = intern(layerStateName(state));
+    m_ObjectIds.emplace(state, id);
+  }
+  write(EventType::stateChanged, id);
+}
+
+void EventRing::looped(const rive::LinearAnimation *animation) {
+  auto found = m_ObjectIds.find(animation);
+  uint32_t id;
+  if (found != m_ObjectIds.end()) {
+    id = found->second;
+  } else {
+    id = intern(animation == nullptr ? "" : animation->name());
+    m_ObjectIds.emplace(animation, id);
+  }
+  write(EventType::looped, id);
+}
+
+const std::string &EventRing::name(uint32_t id) const {
+  static const std::string none;
+  return id < m_Names.size() ? m_Names[id] : none;
+}
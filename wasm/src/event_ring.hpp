@@ -0,0 +1,60 @@
+#ifndef _RIVE_EVENT_RING_HPP_
+#define _RIVE_EVENT_RING_HPP_
+
+#include "animation/layer_state.hpp"
+#include "animation/linear_animation.hpp"
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class EventType : uint32_t {
+  // A state machine layer entered the state named by the event.
+  stateChanged = 0,
+  // The named animation looped (or reversed, when it ping pongs).
+  looped = 1
+};
+
+// Events of advances, written into a fixed size ring in wasm memory which JS
+// reads through a typed array view instead of asking every instance what
+// happened after each advance. Event n, counting every event ever written,
+// takes the stride words from (n % capacity) * stride: its EventType and the
+// id of its name.
+//
+// Names are interned, so an id always stands for the same name and JS only
+// has to look it up with name() the first time it sees it. Ids are looked up
+// by the state or animation they name, so writing events doesn't allocate
+// once each of them was seen. JS keeps count of the events it read; when it
+// falls more than capacity behind written(), the oldest ones are lost.
+class EventRing {
+public:
+  static const uint32_t stride = 2;
+  static const uint32_t capacity = 256;
+
+private:
+  std::vector<uint32_t> m_Events;
+  uint32_t m_Written = 0;
+  std::vector<std::string> m_Names;
+  std::unordered_map<std::string, uint32_t> m_NameIds;
+  std::unordered_map<const void *, uint32_t> m_ObjectIds;
+
+  uint32_t intern(const std::string &name);
+  void write(EventType type, uint32_t nameId);
+
+public:
+  EventRing() : m_Events(capacity * stride) {}
+
+  void stateChanged(const rive::LayerState *state);
+  void looped(const rive::LinearAnimation *animation);
+
+  const uint32_t *events() const { return m_Events.data(); }
+  uint32_t written() const { return m_Written; }
+  // The name of id, or an empty string if there's no such id.
+  const std::string &name(uint32_t id) const;
+};
+
+// Name of a state machine layer's state: its animation's for animation
+// states, otherwise "entry", "exit", "any" or "unknown".
+std::string layerStateName(const rive::LayerState *state);
+
+#endif
@@ -0,0 +1,55 @@
+#include "file_importer.hpp"
+#include "arena.hpp"
+#include "core/binary_reader.hpp"
+#include <algorithm>
+#include <stdlib.h>
+
+bool FileImporter::grow(size_t capacity) {
+  if (capacity <= m_Capacity) {
+    return true;
+  }
+  auto bytes = static_cast<uint8_t *>(realloc(m_Bytes, capacity));
+  if (bytes == nullptr) {
+    return false;
+  }
+  m_Bytes = bytes;
+  m_Capacity = capacity;
+  return true;
+}
+
+void FileImporter::release() {
+  free(m_Bytes);
+  m_Bytes = nullptr;
+  m_Capacity = 0;
+  m_Length = 0;
+  m_Available = 0;
+}
+
+void FileImporter::reserve(size_t size) { grow(size); }
+
+uint8_t *FileImporter::buffer(size_t size) {
+  size_t needed = m_Length + size;
+  if (needed > m_Capacity && !grow(std::max(needed, m_Capacity * 2))) {
+    m_Available = m_Length;
+    return nullptr;
+  }
+  m_Available = needed;
+  return m_Bytes + m_Length;
+}
+
+void FileImporter::commit(size_t size) {
+  m_Length = std::min(m_Length + size, m_Available);
+}
+
+rive::File *FileImporter::importFile() {
+  // The file's definitions all go in one arena, released with the file.
+  rive::File *file = Arena::make([this]() {
+    rive::File *file = nullptr;
+    auto reader = rive::BinaryReader(m_Bytes, m_Length);
+    rive::File::import(reader, &file);
+    return file;
+  });
+  // The imported file doesn't reference the data it was read from.
+  release();
+  return file;
+}
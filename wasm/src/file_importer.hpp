@@ -0,0 +1,54 @@
+#ifndef _RIVE_FILE_IMPORTER_HPP_
+#define _RIVE_FILE_IMPORTER_HPP_
+
+#include "file.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+// Accumulates .riv data in wasm memory so that JS can write a file's bytes
+// straight into the buffer the importer reads from, as they arrive, instead
+// of gathering them in a JS buffer and copying that into wasm afterwards.
+//
+// Views handed out by buffer() are invalidated by anything that may grow wasm
+// memory, so they must be written to immediately.
+//
+// The buffer is malloc'd rather than a vector so that growing it neither
+// zero-fills bytes about to be overwritten nor lands in an arena.
+class FileImporter {
+private:
+  uint8_t *m_Bytes = nullptr;
+  size_t m_Capacity = 0;
+  size_t m_Length = 0;
+  // End of the room made by the last call to buffer().
+  size_t m_Available = 0;
+
+  bool grow(size_t capacity);
+  void release();
+
+public:
+  FileImporter() = default;
+  FileImporter(const FileImporter &) = delete;
+  FileImporter &operator=(const FileImporter &) = delete;
+  ~FileImporter() { release(); }
+
+  // Reserves room for the expected size of the file, avoiding reallocations
+  // while it's written.
+  void reserve(size_t size);
+
+  // Makes room for size more bytes and returns where they should be written,
+  // or null if there's no memory for them. Capacity at least doubles whenever
+  // it grows, so files of unknown size are written in amortized linear time.
+  uint8_t *buffer(size_t size);
+
+  // Marks size bytes written to the last buffer as part of the file.
+  void commit(size_t size);
+
+  size_t length() const { return m_Length; }
+
+  // Imports the accumulated bytes and releases them; the importer can be
+  // reused for another file afterwards. Returns null if the data isn't a valid
+  // file.
+  rive::File *importFile();
+};
+
+#endif
@@ -0,0 +1,71 @@
+#include "flat_geometry.hpp"
+
+#ifdef ENABLE_QUERY_FLAT_VERTICES
+
+#include "shapes/cubic_vertex.hpp"
+#include "shapes/path.hpp"
+
+void FlatGeometry::clear() {
+  m_Verbs.clear();
+  m_Points.clear();
+  m_PathOffsets.clear();
+  m_PathObjects.clear();
+  m_PathOffsets.push_back(0);
+}
+
+void FlatGeometry::addPath(rive::Artboard *artboard, uint32_t objectIndex,
+                           bool transformToParent) {
+  const auto &objects = artboard->objects();
+  if (objectIndex >= objects.size()) {
+    return;
+  }
+  auto object = objects[objectIndex];
+  if (object == nullptr || !object->is<rive::Path>()) {
+    return;
+  }
+  rive::FlattenedPath *flat =
+      object->as<rive::Path>()->makeFlat(transformToParent);
+  for (auto vertex : flat->vertices()) {
+    float x = vertex->x(), y = vertex->y();
+    if (vertex->is<rive::CubicVertex>()) {
+      auto cubic = vertex->as<rive::CubicVertex>();
+      const auto &in = cubic->renderIn();
+      const auto &out = cubic->renderOut();
+      m_Verbs.push_back((uint8_t)FlatVerb::cubic);
+      m_Points.insert(m_Points.end(), {x, y, in[0], in[1], out[0], out[1]});
+    } else {
+      m_Verbs.push_back((uint8_t)FlatVerb::point);
+      m_Points.insert(m_Points.end(), {x, y, x, y, x, y});
+    }
+  }
+  delete flat;
+  m_PathOffsets.push_back((uint32_t)m_Verbs.size());
+  m_PathObjects.push_back(objectIndex);
+}
+
+void FlatGeometry::flattenAll(rive::Artboard *artboard,
+                              bool transformToParent) {
+  clear();
+  size_t count = artboard->objects().size();
+  for (size_t i = 0; i < count; i++) {
+    addPath(artboard, (uint32_t)i, transformToParent);
+  }
+}
+
+uint32_t *FlatGeometry::selection(size_t count) {
+  m_Selection.resize(count);
+  return m_Selection.data();
+}
+
+void FlatGeometry::flattenSelection(rive::Artboard *artboard, size_t count,
+                                    bool transformToParent) {
+  clear();
+  if (count > m_Selection.size()) {
+    count = m_Selection.size();
+  }
+  for (size_t i = 0; i < count; i++) {
+    addPath(artboard, m_Selection[i], transformToParent);
+  }
+}
+
+#endif
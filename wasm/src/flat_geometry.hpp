@@ -0,0 +1,67 @@
+#ifndef _RIVE_FLAT_GEOMETRY_HPP_
+#define _RIVE_FLAT_GEOMETRY_HPP_
+
+#ifdef ENABLE_QUERY_FLAT_VERTICES
+
+#include "artboard.hpp"
+#include <stdint.h>
+#include <vector>
+
+// Kinds of vertex in FlatGeometry's verbs.
+enum class FlatVerb : uint8_t { point = 0, cubic = 1 };
+
+// The flattened vertices of many paths of an artboard, packed into a few
+// contiguous arrays that JS reads through typed array views of wasm memory,
+// rather than one call per vertex property. Path i's vertices are those from
+// pathOffsets()[i] up to pathOffsets()[i + 1]; vertex v has verbs()[v] and
+// the six floats from points()[v * 6]: x, y, in x, in y, out x, out y (in and
+// out repeat x and y for plain points).
+//
+// The packed buffers keep their memory between flattens, so they stop
+// growing once they're large enough; each path is still flattened through a
+// temporary FlattenedPath (Path::makeFlat), which handles corner radii and
+// the parent transform. Views must be fetched again after each flatten,
+// which may move them.
+class FlatGeometry {
+public:
+  static const uint32_t pointStride = 6;
+
+private:
+  std::vector<uint8_t> m_Verbs;
+  std::vector<float> m_Points;
+  std::vector<uint32_t> m_PathOffsets;
+  std::vector<uint32_t> m_PathObjects;
+  std::vector<uint32_t> m_Selection;
+
+  void clear();
+  void addPath(rive::Artboard *artboard, uint32_t objectIndex,
+               bool transformToParent);
+
+public:
+  FlatGeometry() { clear(); }
+
+  // Flattens every path of the artboard, replacing the previous contents.
+  void flattenAll(rive::Artboard *artboard, bool transformToParent);
+
+  // Makes room for count artboard object indices and returns where JS should
+  // write them, for flattenSelection.
+  uint32_t *selection(size_t count);
+  // Flattens the paths at the first count indices written to selection(),
+  // skipping indices that aren't paths.
+  void flattenSelection(rive::Artboard *artboard, size_t count,
+                        bool transformToParent);
+
+  size_t pathCount() const { return m_PathObjects.size(); }
+  size_t vertexCount() const { return m_Verbs.size(); }
+
+  const uint8_t *verbs() const { return m_Verbs.data(); }
+  const float *points() const { return m_Points.data(); }
+  // pathCount() + 1 offsets into the vertices.
+  const uint32_t *pathOffsets() const { return m_PathOffsets.data(); }
+  // Artboard object index of each path.
+  const uint32_t *pathObjects() const { return m_PathObjects.data(); }
+};
+
+#endif
+
+#endif
@@ -0,0 +1,376 @@
+#include "flat_path.hpp"
+#include <algorithm>
+#include <math.h>
+
+// Bounds the number of lines a single cubic is split into.
+static const int maxCubicSegments = 128;
+
+static const float pi = 3.14159265358979f;
+
+void FlatPath::endContour() {
+  uint32_t start = contourEnds.empty() ? 0 : contourEnds.back();
+  if (points.size() > start) {
+    contourEnds.push_back((uint32_t)points.size());
+    contourClosed.push_back(0);
+  }
+}
+
+void FlatPath::moveTo(float x, float y) {
+  endContour();
+  points.push_back({x, y});
+}
+
+static bool equalPoints(FlatPoint a, FlatPoint b) {
+  return a.x == b.x && a.y == b.y;
+}
+
+void FlatPath::lineTo(float x, float y) {
+  uint32_t start = contourEnds.empty() ? 0 : contourEnds.back();
+  size_t count = points.size() - start;
+  if (count > 0 && equalPoints(points.back(), {x, y})) {
+    // Only a contour's first line is kept when it has no length, in case
+    // it stays the only one.
+    if (count == 1) {
+      points.push_back({x, y});
+    }
+    return;
+  }
+  if (count == 2 && equalPoints(points[start], points[start + 1])) {
+    points.back() = {x, y};
+    return;
+  }
+  points.push_back({x, y});
+}
+
+void FlatPath::close() {
+  uint32_t start = contourEnds.empty() ? 0 : contourEnds.back();
+  if (points.size() > start) {
+    contourEnds.push_back((uint32_t)points.size());
+    contourClosed.push_back(1);
+  }
+}
+
+// Scale a transform applies to lengths, the larger of its axes'.
+static float transformScale(const rive::Mat2D &transform) {
+  float x = transform[0] * transform[0] + transform[1] * transform[1];
+  float y = transform[2] * transform[2] + transform[3] * transform[3];
+  return sqrtf(std::max(x, y));
+}
+
+float deviceTolerance(const rive::Mat2D &transform) {
+  return flatness / std::max(transformScale(transform), minScale);
+}
+
+static FlatPoint transformPoint(const float *m, float x, float y) {
+  return {m[0] * x + m[2] * y + m[4], m[1] * x + m[3] * y + m[5]};
+}
+
+static void flattenCubic(FlatPath &result, FlatPoint p0, FlatPoint p1,
+                         FlatPoint p2, FlatPoint p3, float tolerance) {
+  // Wang's formula: the number of lines needed to stay within tolerance of
+  // the curve follows from its second differences.
+  float d1x = p0.x - 2.0f * p1.x + p2.x, d1y = p0.y - 2.0f * p1.y + p2.y;
+  float d2x = p1.x - 2.0f * p2.x + p3.x, d2y = p1.y - 2.0f * p2.y + p3.y;
+  float dd = sqrtf(std::max(d1x * d1x + d1y * d1y, d2x * d2x + d2y * d2y));
+  int segments = (int)ceilf(sqrtf(0.75f * dd / tolerance));
+  segments = std::min(std::max(segments, 1), maxCubicSegments);
+
+  float step = 1.0f / segments;
+  for (int i = 1; i < segments; i++) {
+    float t = i * step, u = 1.0f - t;
+    float a = u * u * u, b = 3.0f * u * u * t, c = 3.0f * u * t * t,
+          d = t * t * t;
+    result.lineTo(a * p0.x + b * p1.x + c * p2.x + d * p3.x,
+                  a * p0.y + b * p1.y + c * p2.y + d * p3.y);
+  }
+  result.lineTo(p3.x, p3.y);
+}
+
+// Flattens path's commands, transformed by m, into result and returns the
+// current point they end at.
+static FlatPoint flatten(RecordingRenderPath *path, const float *m,
+                         float tolerance, FlatPath &result) {
+  const CommandBuffer &commands = path->commands();
+  // Where the current contour started, and where lines continue from.
+  FlatPoint start = {0.0f, 0.0f}, current = start;
+  size_t index = 0, length = commands.size();
+  while (index < length) {
+    auto verb = (PathVerb)commands[index];
+    // Lines after a close or an added path start a new contour from the
+    // current point.
+    if ((verb == PathVerb::line || verb == PathVerb::cubic) &&
+        !result.contourOpen()) {
+      start = current;
+      result.moveTo(current.x, current.y);
+    }
+    switch (verb) {
+    case PathVerb::move:
+      current = transformPoint(m, commands.floatAt(index + 1),
+                               commands.floatAt(index + 2));
+      start = current;
+      result.moveTo(current.x, current.y);
+      break;
+    case PathVerb::line:
+      current = transformPoint(m, commands.floatAt(index + 1),
+                               commands.floatAt(index + 2));
+      result.lineTo(current.x, current.y);
+      break;
+    case PathVerb::cubic: {
+      FlatPoint out = transformPoint(m, commands.floatAt(index + 1),
+                                     commands.floatAt(index + 2));
+      FlatPoint in = transformPoint(m, commands.floatAt(index + 3),
+                                    commands.floatAt(index + 4));
+      FlatPoint to = transformPoint(m, commands.floatAt(index + 5),
+                                    commands.floatAt(index + 6));
+      flattenCubic(result, current, out, in, to, tolerance);
+      current = to;
+      break;
+    }
+    case PathVerb::close:
+      result.close();
+      current = start;
+      break;
+    case PathVerb::addPath: {
+      float s[6];
+      for (int i = 0; i < 6; i++) {
+        s[i] = commands.floatAt(index + 2 + i);
+      }
+      const float sub[6] = {m[0] * s[0] + m[2] * s[1],
+                            m[1] * s[0] + m[3] * s[1],
+                            m[0] * s[2] + m[2] * s[3],
+                            m[1] * s[2] + m[3] * s[3],
+                            m[0] * s[4] + m[2] * s[5] + m[4],
+                            m[1] * s[4] + m[3] * s[5] + m[5]};
+      result.endContour();
+      current =
+          flatten(path->subPaths()[commands[index + 1]], sub, tolerance, result);
+      break;
+    }
+    }
+    index += 1 + pathVerbArgumentCount(verb);
+  }
+  result.endContour();
+  return current;
+}
+
+void flattenPath(RecordingRenderPath *path, float tolerance,
+                 FlatPath &result) {
+  static const float identity[6] = {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+  flatten(path, identity, tolerance, result);
+}
+
+// Adds a closed polygon, reversed if needed so that all polygons added to a
+// stroke wind the same way and fill as their union under nonZero.
+static void addPolygon(FlatPath &result, const FlatPoint *points,
+                       size_t count) {
+  float area = 0.0f;
+  for (size_t i = 0, j = count - 1; i < count; j = i++) {
+    area += points[j].x * points[i].y - points[i].x * points[j].y;
+  }
+  if (area == 0.0f) {
+    return;
+  }
+  if (area > 0.0f) {
+    result.moveTo(points[0].x, points[0].y);
+    for (size_t i = 1; i < count; i++) {
+      result.lineTo(points[i].x, points[i].y);
+    }
+  } else {
+    result.moveTo(points[count - 1].x, points[count - 1].y);
+    for (size_t i = count - 1; i-- > 0;) {
+      result.lineTo(points[i].x, points[i].y);
+    }
+  }
+  result.close();
+}
+
+// Appends points on an arc around center, from angle through sweep radians.
+// The points sit slightly outside the arc, so that each segment covers as much
+// as the sector of the arc it replaces instead of cutting its corner off.
+static void addArc(std::vector<FlatPoint> &points, FlatPoint center,
+                   float radius, float angle, float sweep, float tolerance) {
+  float step = 2.0f * acosf(std::max(-1.0f, 1.0f - tolerance / radius));
+  int segments = step > 0.0f ? (int)ceilf(fabsf(sweep) / step) : 1;
+  segments = std::min(std::max(segments, 1), maxCubicSegments);
+  float theta = fabsf(sweep) / segments;
+  if (theta > 0.0f && theta < pi) {
+    radius *= sqrtf(theta / sinf(theta));
+  }
+  for (int i = 0; i <= segments; i++) {
+    float a = angle + sweep * i / segments;
+    points.push_back(
+        {center.x + cosf(a) * radius, center.y + sinf(a) * radius});
+  }
+}
+
+static bool direction(FlatPoint from, FlatPoint to, FlatPoint &result) {
+  float dx = to.x - from.x, dy = to.y - from.y;
+  float length = sqrtf(dx * dx + dy * dy);
+  if (length == 0.0f) {
+    return false;
+  }
+  result = {dx / length, dy / length};
+  return true;
+}
+
+static void addJoin(FlatPath &result, std::vector<FlatPoint> &scratch,
+                    FlatPoint point, FlatPoint d0, FlatPoint d1,
+                    float halfWidth, rive::StrokeJoin join, float tolerance) {
+  float cross = d0.x * d1.y - d0.y * d1.x;
+  float dot = d0.x * d1.x + d0.y * d1.y;
+  if (fabsf(cross) < 1e-6f && dot > 0.0f) {
+    return;
+  }
+  // The join fills the gap on the outside of the turn.
+  float side = cross > 0.0f ? -1.0f : 1.0f;
+  FlatPoint n0 = {-d0.y * halfWidth * side, d0.x * halfWidth * side};
+  FlatPoint n1 = {-d1.y * halfWidth * side, d1.x * halfWidth * side};
+  FlatPoint a = {point.x + n0.x, point.y + n0.y};
+  FlatPoint b = {point.x + n1.x, point.y + n1.y};
+
+  scratch.clear();
+  scratch.push_back(point);
+  switch (join) {
+  case rive::StrokeJoin::round: {
+    float start = atan2f(n0.y, n0.x);
+    float sweep = atan2f(n0.x * n1.y - n0.y * n1.x, n0.x * n1.x + n0.y * n1.y);
+    addArc(scratch, point, halfWidth, start, sweep, tolerance);
+    break;
+  }
+  case rive::StrokeJoin::miter: {
+    FlatPoint half;
+    if (direction({0.0f, 0.0f}, {n0.x + n1.x, n0.y + n1.y}, half)) {
+      // Cosine of half the angle between the two normals.
+      float cosHalf = (half.x * n0.x + half.y * n0.y) / halfWidth;
+      if (cosHalf * miterLimit > 1.0f) {
+        float length = halfWidth / cosHalf;
+        scratch.push_back(a);
+        scratch.push_back({point.x + half.x * length, point.y + half.y * length});
+        scratch.push_back(b);
+        break;
+      }
+    }
+    scratch.push_back(a);
+    scratch.push_back(b);
+    break;
+  }
+  default:
+    scratch.push_back(a);
+    scratch.push_back(b);
+    break;
+  }
+  addPolygon(result, scratch.data(), scratch.size());
+}
+
+// Adds the dot a zero-length contour strokes to with round or square caps.
+static void addDot(FlatPath &result, std::vector<FlatPoint> &scratch,
+                   FlatPoint point, float halfWidth, rive::StrokeCap cap,
+                   float tolerance) {
+  scratch.clear();
+  switch (cap) {
+  case rive::StrokeCap::round:
+    addArc(scratch, point, halfWidth, 0.0f, 2.0f * pi, tolerance);
+    // The arc ends where it started.
+    scratch.pop_back();
+    break;
+  case rive::StrokeCap::square:
+    scratch.push_back({point.x - halfWidth, point.y - halfWidth});
+    scratch.push_back({point.x + halfWidth, point.y - halfWidth});
+    scratch.push_back({point.x + halfWidth, point.y + halfWidth});
+    scratch.push_back({point.x - halfWidth, point.y + halfWidth});
+    break;
+  default:
+    return;
+  }
+  addPolygon(result, scratch.data(), scratch.size());
+}
+
+static void addCap(FlatPath &result, std::vector<FlatPoint> &scratch,
+                   FlatPoint point, FlatPoint d, float halfWidth,
+                   rive::StrokeCap cap, bool isStart, float tolerance) {
+  // Caps extend away from the contour: backwards at its start.
+  if (isStart) {
+    d = {-d.x, -d.y};
+  }
+  FlatPoint n = {-d.y * halfWidth, d.x * halfWidth};
+  scratch.clear();
+  switch (cap) {
+  case rive::StrokeCap::round:
+    scratch.push_back(point);
+    addArc(scratch, point, halfWidth, atan2f(n.y, n.x), -pi, tolerance);
+    break;
+  case rive::StrokeCap::square: {
+    FlatPoint e = {d.x * halfWidth, d.y * halfWidth};
+    scratch.push_back({point.x + n.x, point.y + n.y});
+    scratch.push_back({point.x + n.x + e.x, point.y + n.y + e.y});
+    scratch.push_back({point.x - n.x + e.x, point.y - n.y + e.y});
+    scratch.push_back({point.x - n.x, point.y - n.y});
+    break;
+  }
+  default:
+    return;
+  }
+  addPolygon(result, scratch.data(), scratch.size());
+}
+
+void strokePath(const FlatPath &path, float thickness, rive::StrokeJoin join,
+                rive::StrokeCap cap, float tolerance, FlatPath &result) {
+  float halfWidth = thickness * 0.5f;
+  if (halfWidth <= 0.0f) {
+    return;
+  }
+  std::vector<FlatPoint> scratch;
+  for (size_t contour = 0; contour < path.contourCount(); contour++) {
+    const FlatPoint *points = path.points.data() + path.contourStart(contour);
+    size_t count = path.contourEnds[contour] - path.contourStart(contour);
+    bool closed = path.contourClosed[contour] != 0;
+    if (count == 2 && equalPoints(points[0], points[1])) {
+      addDot(result, scratch, points[0], halfWidth, cap, tolerance);
+      continue;
+    }
+    if (closed && count > 1 && points[count - 1].x == points[0].x &&
+        points[count - 1].y == points[0].y) {
+      count--;
+    }
+    if (count < 2) {
+      continue;
+    }
+
+    size_t segments = closed ? count : count - 1;
+    for (size_t i = 0; i < segments; i++) {
+      FlatPoint a = points[i], b = points[(i + 1) % count], d;
+      if (!direction(a, b, d)) {
+        continue;
+      }
+      FlatPoint n = {-d.y * halfWidth, d.x * halfWidth};
+      const FlatPoint quad[4] = {{a.x + n.x, a.y + n.y},
+                                 {b.x + n.x, b.y + n.y},
+                                 {b.x - n.x, b.y - n.y},
+                                 {a.x - n.x, a.y - n.y}};
+      addPolygon(result, quad, 4);
+    }
+
+    size_t first = closed ? 0 : 1, last = closed ? count : count - 1;
+    for (size_t i = first; i < last; i++) {
+      FlatPoint previous = points[(i + count - 1) % count];
+      FlatPoint next = points[(i + 1) % count];
+      FlatPoint d0, d1;
+      if (direction(previous, points[i], d0) &&
+          direction(points[i], next, d1)) {
+        addJoin(result, scratch, points[i], d0, d1, halfWidth, join,
+                tolerance);
+      }
+    }
+
+    if (!closed) {
+      FlatPoint d;
+      if (direction(points[0], points[1], d)) {
+        addCap(result, scratch, points[0], d, halfWidth, cap, true, tolerance);
+      }
+      if (direction(points[count - 2], points[count - 1], d)) {
+        addCap(result, scratch, points[count - 1], d, halfWidth, cap, false,
+               tolerance);
+      }
+    }
+  }
+}
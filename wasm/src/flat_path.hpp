@@ -0,0 +1,69 @@
+#ifndef _RIVE_FLAT_PATH_HPP_
+#define _RIVE_FLAT_PATH_HPP_
+
+#include "math/mat2d.hpp"
+#include "recording_render_path.hpp"
+#include "shapes/paint/stroke_cap.hpp"
+#include "shapes/paint/stroke_join.hpp"
+#include <stdint.h>
+#include <vector>
+
+struct FlatPoint {
+  float x, y;
+};
+
+// A path flattened to straight lines: the points of all of its contours, with
+// where each contour ends and whether it was closed. Consecutive points are
+// distinct, except in a contour of two equal points: a zero-length line,
+// which strokes draw as a dot.
+struct FlatPath {
+  std::vector<FlatPoint> points;
+  // Index one past each contour's last point.
+  std::vector<uint32_t> contourEnds;
+  std::vector<uint8_t> contourClosed;
+
+  void clear() {
+    points.clear();
+    contourEnds.clear();
+    contourClosed.clear();
+  }
+  size_t contourCount() const { return contourEnds.size(); }
+  uint32_t contourStart(size_t contour) const {
+    return contour == 0 ? 0 : contourEnds[contour - 1];
+  }
+  // Whether points were added since the last contour ended.
+  bool contourOpen() const {
+    return points.size() > contourStart(contourCount());
+  }
+
+  void moveTo(float x, float y);
+  void lineTo(float x, float y);
+  void close();
+  // Ends the current contour, if any, leaving it open.
+  void endContour();
+};
+
+// Canvas' default miter limit, bounding how far a miter join can reach.
+static const float miterLimit = 10.0f;
+
+// Paths are flattened to within a quarter of a device pixel.
+static const float flatness = 0.25f;
+
+// Transforms scaling below this are treated as degenerate.
+static const float minScale = 1e-6f;
+
+// Tolerance, in the path's own space, keeping paths drawn with transform
+// within flatness of their curves on the device.
+float deviceTolerance(const rive::Mat2D &transform);
+
+// Appends the path's contours, with sub paths placed by their addPath
+// matrices, to result. Cubics are split into lines that stray at most
+// tolerance from the curve.
+void flattenPath(RecordingRenderPath *path, float tolerance, FlatPath &result);
+
+// Appends the outline of a stroke along path to result, as closed polygons
+// which all wind the same way; fill them with the nonZero rule.
+void strokePath(const FlatPath &path, float thickness, rive::StrokeJoin join,
+                rive::StrokeCap cap, float tolerance, FlatPath &result);
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef _RIVE_FNV_HASH_HPP_
+#define _RIVE_FNV_HASH_HPP_
+
+#include "math/mat2d.hpp"
+#include <stdint.h>
+#include <string.h>
+
+// 64 bit FNV-1a, fed one 32 bit word at a time; used to hash recorded paths
+// and to sign draws so that they can be compared with the previous frame's.
+static const uint64_t fnvOffsetBasis = 0xcbf29ce484222325ULL;
+static const uint64_t fnvPrime = 0x100000001b3ULL;
+
+inline uint64_t hashWord(uint64_t hash, uint32_t word) {
+  return (hash ^ word) * fnvPrime;
+}
+
+inline uint64_t hashPointer(uint64_t hash, const void *pointer) {
+  uint64_t value = (uint64_t)(uintptr_t)pointer;
+  return hashWord(hashWord(hash, (uint32_t)value), (uint32_t)(value >> 32));
+}
+
+inline uint64_t hashMatrix(uint64_t hash, const rive::Mat2D &matrix) {
+  for (int i = 0; i < 6; i++) {
+    uint32_t word;
+    float value = matrix[i];
+    memcpy(&word, &value, sizeof(word));
+    hash = hashWord(hash, word);
+  }
+  return hash;
+}
+
+#endif
@@ -0,0 +1,54 @@
+#include "frame_stats.hpp"
+#include "recording_render_path.hpp"
+#include <algorithm>
+
+void StatsRecorder::beginDraw() {
+  m_Depth = 0;
+  m_DrawStart = StatsClock::now();
+}
+
+void StatsRecorder::endFrame() {
+  m_Current.drawMicros += elapsedMicros(m_DrawStart, StatsClock::now());
+  m_Last = m_Current;
+  m_Current = FrameStats();
+}
+
+void StatsRecorder::save() {
+  m_Depth++;
+  m_Current.saveDepth = std::max(m_Current.saveDepth, m_Depth);
+  if (m_Renderer != nullptr) {
+    m_Renderer->save();
+  }
+}
+
+void StatsRecorder::restore() {
+  if (m_Depth > 0) {
+    m_Depth--;
+  }
+  if (m_Renderer != nullptr) {
+    m_Renderer->restore();
+  }
+}
+
+void StatsRecorder::transform(const rive::Mat2D &transform) {
+  if (m_Renderer != nullptr) {
+    m_Renderer->transform(transform);
+  }
+}
+
+void StatsRecorder::drawPath(rive::RenderPath *path,
+                             rive::RenderPaint *paint) {
+  m_Current.pathsDrawn++;
+  m_Current.pathVerbs += static_cast<RecordingRenderPath *>(path)->verbCount();
+  if (m_Renderer != nullptr) {
+    m_Renderer->drawPath(path, paint);
+  }
+}
+
+void StatsRecorder::clipPath(rive::RenderPath *path) {
+  m_Current.clips++;
+  m_Current.pathVerbs += static_cast<RecordingRenderPath *>(path)->verbCount();
+  if (m_Renderer != nullptr) {
+    m_Renderer->clipPath(path);
+  }
+}
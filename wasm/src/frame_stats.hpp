@@ -0,0 +1,92 @@
+#ifndef _RIVE_FRAME_STATS_HPP_
+#define _RIVE_FRAME_STATS_HPP_
+
+#include "math/mat2d.hpp"
+#include "renderer.hpp"
+#include <chrono>
+#include <stdint.h>
+
+// What one frame of an artboard cost.
+struct FrameStats {
+  uint32_t pathsDrawn = 0;
+  // Verbs in the paths drawn and clipped with, including their sub paths'.
+  uint32_t pathVerbs = 0;
+  uint32_t clips = 0;
+  // Deepest save/restore nesting reached while drawing.
+  uint32_t saveDepth = 0;
+  uint32_t gradientsRebuilt = 0;
+  // Paths rebuilt by the artboard's components while advancing.
+  uint32_t pathsRebuilt = 0;
+  // Advancing animations, state machines and the artboard.
+  float advanceMicros = 0.0f;
+  // Applying animations and state machines to the artboard.
+  float applyMicros = 0.0f;
+  float drawMicros = 0.0f;
+};
+
+using StatsClock = std::chrono::steady_clock;
+
+inline float elapsedMicros(StatsClock::time_point from,
+                           StatsClock::time_point to) {
+  return std::chrono::duration<float, std::micro>(to - from).count();
+}
+
+// Collects FrameStats for an artboard. It only takes part in a frame while
+// stats are wanted: BatchedArtboard times its advance into it, and the
+// artboard is drawn through it, wrapped around the real renderer, to count
+// what's drawn. Without a recorder nothing is measured at all.
+class StatsRecorder : public rive::Renderer {
+private:
+  rive::Renderer *m_Renderer = nullptr;
+  FrameStats m_Current;
+  FrameStats m_Last;
+  uint32_t m_Depth = 0;
+  StatsClock::time_point m_DrawStart;
+
+public:
+  // The renderer draws are forwarded to.
+  rive::Renderer *renderer() const { return m_Renderer; }
+  void renderer(rive::Renderer *value) { m_Renderer = value; }
+
+  // Stats of the frame in progress.
+  FrameStats &current() { return m_Current; }
+  // Stats of the last completed frame.
+  const FrameStats &last() const { return m_Last; }
+
+  // Call before drawing; the time until endFrame() is counted as drawing.
+  void beginDraw();
+  // Completes the frame, making its stats available from last().
+  void endFrame();
+
+  void save() override;
+  void restore() override;
+  void transform(const rive::Mat2D &transform) override;
+  void drawPath(rive::RenderPath *path, rive::RenderPaint *paint) override;
+  void clipPath(rive::RenderPath *path) override;
+};
+
+// Adds the time between laps to FrameStats fields. Does nothing, not even
+// reading the clock, when there are no stats to record into.
+class StatsTimer {
+private:
+  FrameStats *m_Stats;
+  StatsClock::time_point m_Last;
+
+public:
+  explicit StatsTimer(FrameStats *stats) : m_Stats(stats) {
+    if (m_Stats != nullptr) {
+      m_Last = StatsClock::now();
+    }
+  }
+
+  void lap(float FrameStats::*field) {
+    if (m_Stats == nullptr) {
+      return;
+    }
+    auto now = StatsClock::now();
+    m_Stats->*field += elapsedMicros(m_Last, now);
+    m_Last = now;
+  }
+};
+
+#endif
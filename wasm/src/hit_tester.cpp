@@ -0,0 +1,351 @@
+#include "hit_tester.hpp"
+#include "fnv_hash.hpp"
+#include "shapes/path_composer.hpp"
+#include "shapes/shape.hpp"
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+
+// Most draws a leaf holds.
+static const uint32_t leafSize = 4;
+
+// Neutral for unions, and containing no point.
+static const float emptyRect[4] = {FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+// Winding number of the contours of path around x, y, each contour closed.
+static int winding(const FlatPath &path, float x, float y) {
+  int winding = 0;
+  for (size_t contour = 0; contour < path.contourCount(); contour++) {
+    uint32_t start = path.contourStart(contour);
+    uint32_t end = path.contourEnds[contour];
+    for (uint32_t i = start; i < end; i++) {
+      const FlatPoint &a = path.points[i];
+      const FlatPoint &b = path.points[i + 1 < end ? i + 1 : start];
+      float side = (b.x - a.x) * (y - a.y) - (x - a.x) * (b.y - a.y);
+      if (a.y <= y) {
+        if (b.y > y && side > 0.0f) {
+          winding++;
+        }
+      } else if (b.y <= y && side < 0.0f) {
+        winding--;
+      }
+    }
+  }
+  return winding;
+}
+
+void HitTester::save() {
+  if (m_InUpdate) {
+    m_Stack.push_back(m_State);
+  }
+}
+
+void HitTester::restore() {
+  if (m_InUpdate && !m_Stack.empty()) {
+    m_State = m_Stack.back();
+    m_Stack.pop_back();
+  }
+}
+
+void HitTester::transform(const rive::Mat2D &transform) {
+  if (!m_InUpdate) {
+    m_View = transform;
+    // Every draw moves, so the hierarchy goes too, and the artboard must be
+    // drawn again before hit testing it.
+    m_Draws.clear();
+    m_Nodes.clear();
+    m_Order.clear();
+    m_DrawLeaves.clear();
+    m_NeedsBuild = true;
+    m_Artboard = nullptr;
+    return;
+  }
+  rive::Mat2D result;
+  rive::Mat2D::multiply(result, m_State.transform, transform);
+  m_State.transform = result;
+}
+
+HitTester::Rect HitTester::deviceBounds(const PathBounds &bounds, float outset,
+                                        const rive::Mat2D &m) const {
+  if (bounds.isEmpty()) {
+    return {emptyRect[0], emptyRect[1], emptyRect[2], emptyRect[3]};
+  }
+  float minX = bounds.minX - outset, minY = bounds.minY - outset;
+  float maxX = bounds.maxX + outset, maxY = bounds.maxY + outset;
+  const float corners[8] = {minX, minY, maxX, minY, maxX, maxY, minX, maxY};
+  Rect rect = {FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX};
+  for (int i = 0; i < 8; i += 2) {
+    float x = m[0] * corners[i] + m[2] * corners[i + 1] + m[4];
+    float y = m[1] * corners[i] + m[3] * corners[i + 1] + m[5];
+    rect.minX = std::min(rect.minX, x);
+    rect.minY = std::min(rect.minY, y);
+    rect.maxX = std::max(rect.maxX, x);
+    rect.maxY = std::max(rect.maxY, y);
+  }
+  return {std::max(rect.minX, m_State.clipBounds.minX),
+          std::max(rect.minY, m_State.clipBounds.minY),
+          std::min(rect.maxX, m_State.clipBounds.maxX),
+          std::min(rect.maxY, m_State.clipBounds.maxY)};
+}
+
+void HitTester::drawPath(rive::RenderPath *path, rive::RenderPaint *paint) {
+  if (!m_InUpdate) {
+    return;
+  }
+  // Our factories only hand out recording paths and paints.
+  auto recordedPath = static_cast<RecordingRenderPath *>(path);
+  auto recordedPaint = static_cast<RecordingRenderPaint *>(paint);
+  uint32_t version = recordedPath->validate();
+  uint64_t signature = hashPointer(fnvOffsetBasis, recordedPath);
+  signature = hashWord(signature, version);
+  signature = hashPointer(signature, recordedPaint);
+  signature = hashWord(signature, recordedPaint->version());
+  signature = hashMatrix(signature, m_State.transform);
+  signature = hashWord(signature, (uint32_t)m_State.clipHash);
+  signature = hashWord(signature, (uint32_t)(m_State.clipHash >> 32));
+
+  size_t index = m_DrawIndex++;
+  if (index < m_Draws.size() && m_Draws[index].signature == signature) {
+    // Clips are numbered anew each update.
+    m_Draws[index].clip = m_State.clip;
+    return;
+  }
+
+  float outset = 0.0f;
+  if (recordedPaint->style() == rive::RenderPaintStyle::stroke) {
+    float halfThickness = recordedPaint->thickness() / 2.0f;
+    if (recordedPaint->join() == rive::StrokeJoin::miter) {
+      outset = halfThickness * miterLimit;
+    } else if (recordedPaint->cap() == rive::StrokeCap::square) {
+      outset = halfThickness * (float)M_SQRT2;
+    } else {
+      outset = halfThickness;
+    }
+  }
+  auto object = m_PathObjects.find(path);
+  Draw draw = {signature,
+               recordedPath,
+               recordedPaint,
+               m_State.transform,
+               m_State.clip,
+               object == m_PathObjects.end() ? -1 : object->second,
+               deviceBounds(recordedPath->bounds(), outset, m_State.transform)};
+  if (index < m_Draws.size()) {
+    m_Draws[index] = draw;
+    m_Dirty.push_back((uint32_t)index);
+  } else {
+    m_Draws.push_back(draw);
+    m_NeedsBuild = true;
+  }
+}
+
+void HitTester::clipPath(rive::RenderPath *path) {
+  if (!m_InUpdate) {
+    return;
+  }
+  auto recordedPath = static_cast<RecordingRenderPath *>(path);
+  uint32_t version = recordedPath->validate();
+  Rect rect = deviceBounds(recordedPath->bounds(), 0.0f, m_State.transform);
+  m_State.clipBounds = rect;
+  m_Clips.push_back({recordedPath, m_State.transform, m_State.clip});
+  m_State.clip = (int32_t)m_Clips.size() - 1;
+  uint64_t hash = hashPointer(m_State.clipHash, recordedPath);
+  hash = hashWord(hash, version);
+  m_State.clipHash = hashMatrix(hash, m_State.transform);
+}
+
+// Shapes draw their paths through their path composer, in local or world
+// space depending on the paint.
+void HitTester::mapObjects(rive::Artboard *artboard) {
+  const auto &objects = artboard->objects();
+  if (artboard == m_Artboard && objects.size() == m_ObjectCount) {
+    return;
+  }
+  m_Artboard = artboard;
+  m_ObjectCount = objects.size();
+  m_PathObjects.clear();
+  m_Draws.clear();
+  for (size_t i = 0; i < objects.size(); i++) {
+    rive::Core *object = objects[i];
+    if (object == nullptr || !object->is<rive::Shape>()) {
+      continue;
+    }
+    rive::PathComposer *composer = object->as<rive::Shape>()->pathComposer();
+    if (composer == nullptr) {
+      continue;
+    }
+    m_PathObjects[composer->localPath()] = (int32_t)i;
+    m_PathObjects[composer->worldPath()] = (int32_t)i;
+  }
+}
+
+// Splits draws at the median of their centers along the longer axis of the
+// centers' extent.
+uint32_t HitTester::build(uint32_t first, uint32_t count, int32_t parent) {
+  uint32_t node = (uint32_t)m_Nodes.size();
+  Rect bounds = {emptyRect[0], emptyRect[1], emptyRect[2], emptyRect[3]};
+  Rect centers = bounds;
+  for (uint32_t i = first; i < first + count; i++) {
+    const Rect &rect = m_Draws[m_Order[i]].bounds;
+    bounds = bounds.united(rect);
+    float x = (rect.minX + rect.maxX) / 2.0f;
+    float y = (rect.minY + rect.maxY) / 2.0f;
+    centers = centers.united({x, y, x, y});
+  }
+  m_Nodes.push_back({bounds, parent, first, count});
+  if (count <= leafSize) {
+    for (uint32_t i = first; i < first + count; i++) {
+      m_DrawLeaves[m_Order[i]] = node;
+    }
+    return node;
+  }
+
+  bool alongX = centers.maxX - centers.minX >= centers.maxY - centers.minY;
+  auto begin = m_Order.begin() + first;
+  uint32_t half = count / 2;
+  std::nth_element(begin, begin + half, begin + count,
+                   [this, alongX](uint32_t a, uint32_t b) {
+                     const Rect &ra = m_Draws[a].bounds;
+                     const Rect &rb = m_Draws[b].bounds;
+                     return alongX ? ra.minX + ra.maxX < rb.minX + rb.maxX
+                                   : ra.minY + ra.maxY < rb.minY + rb.maxY;
+                   });
+  m_Nodes[node].count = 0;
+  build(first, half, (int32_t)node);
+  m_Nodes[node].first = build(first + half, count - half, (int32_t)node);
+  return node;
+}
+
+// Walks up from the leaves of changed draws, stopping where bounds no longer
+// change.
+void HitTester::refit() {
+  for (uint32_t draw : m_Dirty) {
+    int32_t node = (int32_t)m_DrawLeaves[draw];
+    while (node >= 0) {
+      Node &current = m_Nodes[node];
+      Rect bounds;
+      if (current.count > 0) {
+        bounds = {emptyRect[0], emptyRect[1], emptyRect[2], emptyRect[3]};
+        uint32_t end = current.first + current.count;
+        for (uint32_t i = current.first; i < end; i++) {
+          bounds = bounds.united(m_Draws[m_Order[i]].bounds);
+        }
+      } else {
+        bounds = m_Nodes[node + 1].bounds.united(m_Nodes[current.first].bounds);
+      }
+      if (bounds.minX == current.bounds.minX &&
+          bounds.minY == current.bounds.minY &&
+          bounds.maxX == current.bounds.maxX &&
+          bounds.maxY == current.bounds.maxY) {
+        break;
+      }
+      current.bounds = bounds;
+      node = current.parent;
+    }
+  }
+}
+
+void HitTester::update(rive::Artboard *artboard) {
+  mapObjects(artboard);
+  m_InUpdate = true;
+  m_Stack.clear();
+  m_Clips.clear();
+  m_Dirty.clear();
+  m_DrawIndex = 0;
+  m_State.transform = m_View;
+  m_State.clip = -1;
+  m_State.clipBounds = {-FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX};
+  m_State.clipHash = fnvOffsetBasis;
+  artboard->draw(this);
+  m_InUpdate = false;
+
+  if (m_DrawIndex != m_Draws.size()) {
+    m_Draws.resize(m_DrawIndex);
+    m_NeedsBuild = true;
+  }
+  if (!m_NeedsBuild) {
+    refit();
+    return;
+  }
+  m_NeedsBuild = false;
+  m_Nodes.clear();
+  m_Order.resize(m_Draws.size());
+  m_DrawLeaves.resize(m_Draws.size());
+  for (size_t i = 0; i < m_Order.size(); i++) {
+    m_Order[i] = (uint32_t)i;
+  }
+  if (!m_Draws.empty()) {
+    build(0, (uint32_t)m_Draws.size(), -1);
+  }
+}
+
+bool HitTester::contains(RecordingRenderPath *path,
+                         const rive::Mat2D &transform,
+                         const RecordingRenderPaint *paint, float x, float y) {
+  rive::Mat2D inverse;
+  if (!rive::Mat2D::invert(inverse, transform)) {
+    return false;
+  }
+  float localX = inverse[0] * x + inverse[2] * y + inverse[4];
+  float localY = inverse[1] * x + inverse[3] * y + inverse[5];
+  float tolerance = deviceTolerance(transform);
+  m_Flat.clear();
+  flattenPath(path, tolerance, m_Flat);
+  if (paint != nullptr && paint->style() == rive::RenderPaintStyle::stroke) {
+    m_Stroke.clear();
+    strokePath(m_Flat, paint->thickness(), paint->join(), paint->cap(),
+               tolerance, m_Stroke);
+    return winding(m_Stroke, localX, localY) != 0;
+  }
+  int count = winding(m_Flat, localX, localY);
+  return path->fillRule() == rive::FillRule::evenOdd ? (count & 1) != 0
+                                                      : count != 0;
+}
+
+bool HitTester::hits(const Draw &draw, float x, float y) {
+  if (!contains(draw.path, draw.transform, draw.paint, x, y)) {
+    return false;
+  }
+  for (int32_t clip = draw.clip; clip >= 0; clip = m_Clips[clip].parent) {
+    if (!contains(m_Clips[clip].path, m_Clips[clip].transform, nullptr, x, y)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int32_t HitTester::hitTest(float x, float y) {
+  m_Candidates.clear();
+  m_Traversal.clear();
+  if (!m_Nodes.empty()) {
+    m_Traversal.push_back(0);
+  }
+  while (!m_Traversal.empty()) {
+    const Node &node = m_Nodes[m_Traversal.back()];
+    uint32_t index = m_Traversal.back();
+    m_Traversal.pop_back();
+    if (!node.bounds.contains(x, y)) {
+      continue;
+    }
+    if (node.count == 0) {
+      m_Traversal.push_back(index + 1);
+      m_Traversal.push_back(node.first);
+      continue;
+    }
+    for (uint32_t i = node.first; i < node.first + node.count; i++) {
+      uint32_t draw = m_Order[i];
+      if (m_Draws[draw].object >= 0 && m_Draws[draw].bounds.contains(x, y)) {
+        m_Candidates.push_back(draw);
+      }
+    }
+  }
+  // Later draws are on top.
+  std::sort(m_Candidates.begin(), m_Candidates.end(),
+            [](uint32_t a, uint32_t b) { return a > b; });
+  for (uint32_t draw : m_Candidates) {
+    if (hits(m_Draws[draw], x, y)) {
+      return m_Draws[draw].object;
+    }
+  }
+  return -1;
+}
@@ -0,0 +1,135 @@
+#ifndef _RIVE_HIT_TESTER_HPP_
+#define _RIVE_HIT_TESTER_HPP_
+
+#include "artboard.hpp"
+#include "flat_path.hpp"
+#include "math/mat2d.hpp"
+#include "recording_render_paint.hpp"
+#include "recording_render_path.hpp"
+#include "renderer.hpp"
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+// Finds the shape drawn at a point of the canvas. An artboard is drawn into
+// the tester, which records every draw with its transform, paint and clips,
+// and keeps a bounding volume hierarchy over their device space bounds. Hit
+// tests descend it and test the draws under the point, topmost first, against
+// their actual geometry: the point is mapped back through the inverse of the
+// draw's transform and tested against the flattened fill (with its fill rule)
+// or stroke, and against every clip applying to the draw.
+//
+// Like DamageTracker, draws are matched up with the previous update's by
+// order: only those whose signature changed get new bounds, refitting the
+// nodes above them, and the hierarchy is only rebuilt when the number of
+// draws changes. Outside of an update, transform() sets the view transform,
+// so calling align() positions the tester like the renderer it shadows.
+class HitTester : public rive::Renderer {
+private:
+  struct Rect {
+    float minX, minY, maxX, maxY;
+
+    bool contains(float x, float y) const {
+      return x >= minX && x <= maxX && y >= minY && y <= maxY;
+    }
+    Rect united(const Rect &other) const {
+      return {minX < other.minX ? minX : other.minX,
+              minY < other.minY ? minY : other.minY,
+              maxX > other.maxX ? maxX : other.maxX,
+              maxY > other.maxY ? maxY : other.maxY};
+    }
+  };
+  struct Clip {
+    RecordingRenderPath *path;
+    rive::Mat2D transform;
+    // Index of the clip this one is nested in, or -1.
+    int32_t parent;
+  };
+  struct Draw {
+    uint64_t signature;
+    RecordingRenderPath *path;
+    RecordingRenderPaint *paint;
+    rive::Mat2D transform;
+    int32_t clip;
+    // Artboard object index of the shape drawing, or -1.
+    int32_t object;
+    Rect bounds;
+  };
+  struct State {
+    rive::Mat2D transform;
+    int32_t clip;
+    Rect clipBounds;
+    uint64_t clipHash;
+  };
+  // Nodes are stored depth first, so a node's first child follows it. Leaves
+  // refer to count draws from first in m_Order.
+  struct Node {
+    Rect bounds;
+    int32_t parent;
+    // Index of the second child, or of the first draw for leaves.
+    uint32_t first;
+    // Zero for inner nodes.
+    uint32_t count;
+  };
+
+  rive::Mat2D m_View;
+  State m_State;
+  std::vector<State> m_Stack;
+  std::vector<Clip> m_Clips;
+  std::vector<Draw> m_Draws;
+  std::vector<Node> m_Nodes;
+  // Draw indices, grouped by leaf.
+  std::vector<uint32_t> m_Order;
+  // Leaf of each draw.
+  std::vector<uint32_t> m_DrawLeaves;
+  std::vector<uint32_t> m_Dirty;
+  std::vector<uint32_t> m_Candidates;
+  std::vector<uint32_t> m_Traversal;
+  FlatPath m_Flat;
+  FlatPath m_Stroke;
+
+  // Shape object index by render path, for the artboard last updated from.
+  const rive::Artboard *m_Artboard = nullptr;
+  size_t m_ObjectCount = 0;
+  std::unordered_map<const rive::RenderPath *, int32_t> m_PathObjects;
+
+  // Index of the next draw of the current update.
+  size_t m_DrawIndex = 0;
+  bool m_InUpdate = false;
+  bool m_NeedsBuild = true;
+
+  Rect deviceBounds(const PathBounds &bounds, float outset,
+                    const rive::Mat2D &transform) const;
+  void mapObjects(rive::Artboard *artboard);
+  uint32_t build(uint32_t first, uint32_t count, int32_t parent);
+  void refit();
+  bool contains(RecordingRenderPath *path, const rive::Mat2D &transform,
+                const RecordingRenderPaint *paint, float x, float y);
+  bool hits(const Draw &draw, float x, float y);
+
+public:
+  void save() override;
+  void restore() override;
+  void transform(const rive::Mat2D &transform) override;
+  void drawPath(rive::RenderPath *path, rive::RenderPaint *paint) override;
+  void clipPath(rive::RenderPath *path) override;
+
+  // Draws artboard into the tester, refitting the hierarchy to what changed
+  // since the last update. Call after the artboard advanced and before hit
+  // testing it.
+  void update(rive::Artboard *artboard);
+
+  // Whether update() was last called with artboard, and the view transform
+  // hasn't changed since.
+  bool isUpdatedFrom(const rive::Artboard *artboard) const {
+    return m_Artboard == artboard;
+  }
+
+  // Artboard object index of the topmost shape drawn at x, y in device
+  // pixels (the space the tester was aligned to), or -1 if there's none.
+  int32_t hitTest(float x, float y);
+
+  size_t drawCount() const { return m_Draws.size(); }
+};
+
+#endif
@@ -0,0 +1,42 @@
+#include "input_writes.hpp"
+#include "animation/state_machine_bool.hpp"
+#include "animation/state_machine_input_instance.hpp"
+#include "animation/state_machine_number.hpp"
+#include "animation/state_machine_trigger.hpp"
+
+float *InputWrites::pairs(size_t count) {
+  if (m_Pairs.size() < count * 2) {
+    m_Pairs.resize(count * 2);
+  }
+  return m_Pairs.data();
+}
+
+size_t InputWrites::apply(rive::StateMachineInstance *instance,
+                          size_t count) const {
+  count = count * 2 > m_Pairs.size() ? m_Pairs.size() / 2 : count;
+  size_t inputCount = instance->inputCount();
+  size_t applied = 0;
+  for (size_t i = 0; i < count; i++) {
+    float index = m_Pairs[i * 2];
+    float value = m_Pairs[i * 2 + 1];
+    if (!(index >= 0.0f && index < (float)inputCount)) {
+      continue;
+    }
+    rive::SMIInput *input = instance->input((size_t)index);
+    switch (input->inputCoreType()) {
+    case rive::StateMachineBoolBase::typeKey:
+      static_cast<rive::SMIBool *>(input)->value(value != 0.0f);
+      break;
+    case rive::StateMachineNumberBase::typeKey:
+      static_cast<rive::SMINumber *>(input)->value(value);
+      break;
+    case rive::StateMachineTriggerBase::typeKey:
+      static_cast<rive::SMITrigger *>(input)->fire();
+      break;
+    default:
+      continue;
+    }
+    applied++;
+  }
+  return applied;
+}
@@ -0,0 +1,28 @@
+#ifndef _RIVE_INPUT_WRITES_HPP_
+#define _RIVE_INPUT_WRITES_HPP_
+
+#include "animation/state_machine_instance.hpp"
+#include <stddef.h>
+#include <vector>
+
+// State machine input values written by JS in bulk, as (input index, value)
+// float pairs, and applied to an instance in a single call instead of going
+// through an SMIInput wrapper per input and per value. Bools are set to
+// whether the value isn't 0, numbers to the value, and triggers fire
+// whatever it is.
+class InputWrites {
+private:
+  std::vector<float> m_Pairs;
+
+public:
+  // Room for count pairs, valid until the next call. Grows as needed and is
+  // reused afterwards.
+  float *pairs(size_t count);
+
+  // Applies the first count pairs in order, so the last write to an input
+  // wins. Indices past the instance's inputs are skipped; returns the number
+  // of writes applied.
+  size_t apply(rive::StateMachineInstance *instance, size_t count) const;
+};
+
+#endif
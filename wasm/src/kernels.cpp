@@ -0,0 +1,248 @@
+#include "kernels.hpp"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+static uint32_t mul255(uint32_t a, uint32_t b) {
+  uint32_t value = a * b + 128;
+  return (value + (value >> 8)) >> 8;
+}
+
+static uint8_t foldedCoverage(float winding) {
+  // Fold the winding so that odd windings are inside and even ones out.
+  float alpha = fabsf(winding);
+  alpha -= 2.0f * floorf(alpha * 0.5f);
+  if (alpha > 1.0f) {
+    alpha = 2.0f - alpha;
+  }
+  return (uint8_t)(alpha * 255.0f + 0.5f);
+}
+
+static uint8_t clampedCoverage(float winding) {
+  return (uint8_t)(std::min(fabsf(winding), 1.0f) * 255.0f + 0.5f);
+}
+
+static void blendPixel(uint8_t *pixel, uint32_t color, uint32_t c) {
+  uint32_t r = color & 0xFF, g = (color >> 8) & 0xFF, b = (color >> 16) & 0xFF,
+           a = color >> 24;
+  if (c != 255) {
+    r = mul255(r, c);
+    g = mul255(g, c);
+    b = mul255(b, c);
+    a = mul255(a, c);
+  }
+  uint32_t inverse = 255 - a;
+  pixel[0] = (uint8_t)(r + mul255(pixel[0], inverse));
+  pixel[1] = (uint8_t)(g + mul255(pixel[1], inverse));
+  pixel[2] = (uint8_t)(b + mul255(pixel[2], inverse));
+  pixel[3] = (uint8_t)(a + mul255(pixel[3], inverse));
+}
+
+PathBounds transformPointsScalar(const rive::Mat2D &transform,
+                                 const FlatPoint *points, size_t count,
+                                 FlatPoint *out) {
+  const float *m = &transform[0];
+  PathBounds bounds = {INFINITY, INFINITY, -INFINITY, -INFINITY};
+  for (size_t i = 0; i < count; i++) {
+    float x = m[0] * points[i].x + m[2] * points[i].y + m[4];
+    float y = m[1] * points[i].x + m[3] * points[i].y + m[5];
+    out[i] = {x, y};
+    bounds.minX = std::min(bounds.minX, x);
+    bounds.minY = std::min(bounds.minY, y);
+    bounds.maxX = std::max(bounds.maxX, x);
+    bounds.maxY = std::max(bounds.maxY, y);
+  }
+  return bounds;
+}
+
+bool resolveCoverageScalar(float *deltas, int count, rive::FillRule fillRule,
+                           uint8_t *coverage) {
+  float winding = 0.0f;
+  uint32_t any = 0;
+  if (fillRule == rive::FillRule::evenOdd) {
+    for (int x = 0; x < count; x++) {
+      winding += deltas[x];
+      deltas[x] = 0.0f;
+      uint8_t value = foldedCoverage(winding);
+      coverage[x] = value;
+      any |= value;
+    }
+  } else {
+    for (int x = 0; x < count; x++) {
+      winding += deltas[x];
+      deltas[x] = 0.0f;
+      uint8_t value = clampedCoverage(winding);
+      coverage[x] = value;
+      any |= value;
+    }
+  }
+  return any != 0;
+}
+
+void blendSrcOverScalar(uint8_t *pixels, const uint32_t *colors, size_t step,
+                        const uint8_t *coverage, int count) {
+  for (int i = 0; i < count; i++, pixels += 4) {
+    if (coverage[i] != 0) {
+      blendPixel(pixels, colors[i * step], coverage[i]);
+    }
+  }
+}
+
+#ifdef __wasm_simd128__
+
+PathBounds transformPoints(const rive::Mat2D &transform,
+                           const FlatPoint *points, size_t count,
+                           FlatPoint *out) {
+  const float *m = &transform[0];
+  // Points are interleaved, two to a vector: (x0, y0, x1, y1).
+  v128_t scaleX = wasm_f32x4_make(m[0], m[1], m[0], m[1]);
+  v128_t scaleY = wasm_f32x4_make(m[2], m[3], m[2], m[3]);
+  v128_t translate = wasm_f32x4_make(m[4], m[5], m[4], m[5]);
+  v128_t min = wasm_f32x4_splat(INFINITY);
+  v128_t max = wasm_f32x4_splat(-INFINITY);
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    v128_t xy = wasm_v128_load(points + i);
+    v128_t x = wasm_i32x4_shuffle(xy, xy, 0, 0, 2, 2);
+    v128_t y = wasm_i32x4_shuffle(xy, xy, 1, 1, 3, 3);
+    v128_t result = wasm_f32x4_add(
+        wasm_f32x4_add(wasm_f32x4_mul(scaleX, x), wasm_f32x4_mul(scaleY, y)),
+        translate);
+    wasm_v128_store(out + i, result);
+    min = wasm_f32x4_min(min, result);
+    max = wasm_f32x4_max(max, result);
+  }
+  PathBounds bounds = {
+      std::min(wasm_f32x4_extract_lane(min, 0), wasm_f32x4_extract_lane(min, 2)),
+      std::min(wasm_f32x4_extract_lane(min, 1), wasm_f32x4_extract_lane(min, 3)),
+      std::max(wasm_f32x4_extract_lane(max, 0), wasm_f32x4_extract_lane(max, 2)),
+      std::max(wasm_f32x4_extract_lane(max, 1), wasm_f32x4_extract_lane(max, 3))};
+  for (; i < count; i++) {
+    float x = m[0] * points[i].x + m[2] * points[i].y + m[4];
+    float y = m[1] * points[i].x + m[3] * points[i].y + m[5];
+    out[i] = {x, y};
+    bounds.minX = std::min(bounds.minX, x);
+    bounds.minY = std::min(bounds.minY, y);
+    bounds.maxX = std::max(bounds.maxX, x);
+    bounds.maxY = std::max(bounds.maxY, y);
+  }
+  return bounds;
+}
+
+bool resolveCoverage(float *deltas, int count, rive::FillRule fillRule,
+                     uint8_t *coverage) {
+  bool evenOdd = fillRule == rive::FillRule::evenOdd;
+  v128_t zero = wasm_f32x4_splat(0.0f);
+  v128_t one = wasm_f32x4_splat(1.0f);
+  v128_t two = wasm_f32x4_splat(2.0f);
+  v128_t half = wasm_f32x4_splat(0.5f);
+  v128_t scale = wasm_f32x4_splat(255.0f);
+  v128_t winding = zero;
+  v128_t any = wasm_i32x4_splat(0);
+  int x = 0;
+  for (; x + 4 <= count; x += 4) {
+    // Prefix sum of four deltas in two shifted adds, on top of the running
+    // winding carried over in every lane.
+    v128_t sum = wasm_v128_load(deltas + x);
+    sum = wasm_f32x4_add(sum, wasm_i32x4_shuffle(zero, sum, 0, 4, 5, 6));
+    sum = wasm_f32x4_add(sum, wasm_i32x4_shuffle(zero, sum, 0, 1, 4, 5));
+    sum = wasm_f32x4_add(sum, winding);
+    winding = wasm_i32x4_shuffle(sum, sum, 3, 3, 3, 3);
+    wasm_v128_store(deltas + x, zero);
+
+    v128_t alpha = wasm_f32x4_abs(sum);
+    if (evenOdd) {
+      alpha = wasm_f32x4_sub(
+          alpha, wasm_f32x4_mul(
+                     two, wasm_f32x4_floor(wasm_f32x4_mul(alpha, half))));
+      alpha = wasm_f32x4_min(alpha, wasm_f32x4_sub(two, alpha));
+    } else {
+      alpha = wasm_f32x4_min(alpha, one);
+    }
+    v128_t value = wasm_i32x4_trunc_sat_f32x4(
+        wasm_f32x4_add(wasm_f32x4_mul(alpha, scale), half));
+    v128_t shorts = wasm_u16x8_narrow_i32x4(value, value);
+    v128_t bytes = wasm_u8x16_narrow_i16x8(shorts, shorts);
+    uint32_t packed = (uint32_t)wasm_i32x4_extract_lane(bytes, 0);
+    memcpy(coverage + x, &packed, sizeof(packed));
+    any = wasm_v128_or(any, bytes);
+  }
+  float last = wasm_f32x4_extract_lane(winding, 0);
+  uint32_t anyScalar = (uint32_t)wasm_i32x4_extract_lane(any, 0);
+  for (; x < count; x++) {
+    last += deltas[x];
+    deltas[x] = 0.0f;
+    uint8_t value = evenOdd ? foldedCoverage(last) : clampedCoverage(last);
+    coverage[x] = value;
+    anyScalar |= value;
+  }
+  return anyScalar != 0;
+}
+
+void blendSrcOver(uint8_t *pixels, const uint32_t *colors, size_t step,
+                  const uint8_t *coverage, int count) {
+  v128_t rounding = wasm_i16x8_splat(128);
+  v128_t opaque = wasm_i16x8_splat(255);
+  v128_t solid = wasm_i32x4_splat((int32_t)colors[0]);
+  int i = 0;
+  for (; i + 4 <= count; i += 4, pixels += 16) {
+    uint32_t covered;
+    memcpy(&covered, coverage + i, sizeof(covered));
+    if (covered == 0) {
+      continue;
+    }
+    v128_t color = step == 0 ? solid : wasm_v128_load(colors + i * step);
+    // Each pixel's coverage repeated for its four channels.
+    v128_t c = wasm_i32x4_make((int32_t)covered, 0, 0, 0);
+    c = wasm_i8x16_shuffle(c, c, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3,
+                           3);
+    v128_t destination = wasm_v128_load(pixels);
+    v128_t halves[2];
+    for (int half = 0; half < 2; half++) {
+      v128_t s = half == 0 ? wasm_u16x8_extend_low_u8x16(color)
+                           : wasm_u16x8_extend_high_u8x16(color);
+      v128_t w = half == 0 ? wasm_u16x8_extend_low_u8x16(c)
+                           : wasm_u16x8_extend_high_u8x16(c);
+      v128_t d = half == 0 ? wasm_u16x8_extend_low_u8x16(destination)
+                           : wasm_u16x8_extend_high_u8x16(destination);
+      // mul255 on 16 bit lanes; products and the rounding fit in them.
+      v128_t p = wasm_i16x8_add(wasm_i16x8_mul(s, w), rounding);
+      s = wasm_u16x8_shr(wasm_i16x8_add(p, wasm_u16x8_shr(p, 8)), 8);
+      v128_t inverse = wasm_i16x8_sub(
+          opaque, wasm_i16x8_shuffle(s, s, 3, 3, 3, 3, 7, 7, 7, 7));
+      p = wasm_i16x8_add(wasm_i16x8_mul(d, inverse), rounding);
+      d = wasm_u16x8_shr(wasm_i16x8_add(p, wasm_u16x8_shr(p, 8)), 8);
+      halves[half] = wasm_i16x8_add(s, d);
+    }
+    wasm_v128_store(pixels, wasm_u8x16_narrow_i16x8(halves[0], halves[1]));
+  }
+  for (; i < count; i++, pixels += 4) {
+    if (coverage[i] != 0) {
+      blendPixel(pixels, colors[i * step], coverage[i]);
+    }
+  }
+}
+
+#else
+
+PathBounds transformPoints(const rive::Mat2D &transform,
+                           const FlatPoint *points, size_t count,
+                           FlatPoint *out) {
+  return transformPointsScalar(transform, points, count, out);
+}
+
+bool resolveCoverage(float *deltas, int count, rive::FillRule fillRule,
+                     uint8_t *coverage) {
+  return resolveCoverageScalar(deltas, count, fillRule, coverage);
+}
+
+void blendSrcOver(uint8_t *pixels, const uint32_t *colors, size_t step,
+                  const uint8_t *coverage, int count) {
+  blendSrcOverScalar(pixels, colors, step, coverage, count);
+}
+
+#endif
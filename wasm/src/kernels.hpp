@@ -0,0 +1,42 @@
+#ifndef _RIVE_KERNELS_HPP_
+#define _RIVE_KERNELS_HPP_
+
+#include "command_path.hpp"
+#include "flat_path.hpp"
+#include "math/mat2d.hpp"
+#include "recording_render_path.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+// The software renderer's per point and per pixel loops. Builds compiled with
+// -msimd128 process several points or pixels per wasm SIMD instruction; all
+// others run the scalar versions, which produce the same results (coverage
+// may differ in the lowest bit, as rows are summed in a different order).
+
+// Transforms count points into out and returns the bounds of the results.
+PathBounds transformPoints(const rive::Mat2D &transform,
+                           const FlatPoint *points, size_t count,
+                           FlatPoint *out);
+
+// Sums a row of signed area deltas from the left into 8 bit coverage under
+// fillRule, zeroing the deltas as it goes. Returns false if the whole row is
+// uncovered.
+bool resolveCoverage(float *deltas, int count, rive::FillRule fillRule,
+                     uint8_t *coverage);
+
+// Composites premultiplied RGBA colors (a single one if step is 0) over a row
+// of premultiplied RGBA pixels with srcOver, weighted by coverage.
+void blendSrcOver(uint8_t *pixels, const uint32_t *colors, size_t step,
+                  const uint8_t *coverage, int count);
+
+// The scalar versions, which the above call in builds without SIMD; exposed
+// so that the SIMD ones can be checked against them.
+PathBounds transformPointsScalar(const rive::Mat2D &transform,
+                                 const FlatPoint *points, size_t count,
+                                 FlatPoint *out);
+bool resolveCoverageScalar(float *deltas, int count, rive::FillRule fillRule,
+                           uint8_t *coverage);
+void blendSrcOverScalar(uint8_t *pixels, const uint32_t *colors, size_t step,
+                        const uint8_t *coverage, int count);
+
+#endif
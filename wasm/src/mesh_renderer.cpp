@@ -0,0 +1,111 @@
+#include "mesh_renderer.hpp"
+#include <algorithm>
+
+MeshRenderer::MeshRenderer() { m_State.clip = UINT32_MAX; }
+
+void MeshRenderer::clear() {
+  m_State = State();
+  m_State.clip = UINT32_MAX;
+  m_Stack.clear();
+  m_Vertices.clear();
+  m_Indices.clear();
+  m_Draws.clear();
+  m_DrawFloats.clear();
+  m_StopColors.clear();
+  m_StopOffsets.clear();
+}
+
+void MeshRenderer::save() { m_Stack.push_back(m_State); }
+
+void MeshRenderer::restore() {
+  if (m_Stack.empty()) {
+    return;
+  }
+  m_State = m_Stack.back();
+  m_Stack.pop_back();
+}
+
+void MeshRenderer::transform(const rive::Mat2D &transform) {
+  rive::Mat2D result;
+  rive::Mat2D::multiply(result, m_State.transform, transform);
+  m_State.transform = result;
+}
+
+bool MeshRenderer::addDraw(const FlatPath &path, rive::FillRule fillRule,
+                           float tolerance, MeshPaint type,
+                           const RecordingRenderPaint *paint) {
+  size_t vertexCount = m_Vertices.size();
+  uint32_t firstIndex = (uint32_t)m_Indices.size();
+  m_Tessellator.fill(path, fillRule, tolerance, m_Vertices, m_Indices);
+  uint32_t indexCount = (uint32_t)m_Indices.size() - firstIndex;
+  if (indexCount == 0 && type != MeshPaint::clip) {
+    m_Vertices.resize(vertexCount);
+    return false;
+  }
+
+  uint32_t color = 0, blendMode = 0;
+  uint32_t firstStop = (uint32_t)m_StopColors.size(), stopCount = 0;
+  float gradient[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+  if (paint != nullptr) {
+    color = paint->color();
+    blendMode = (uint32_t)paint->blendMode();
+    if (type != MeshPaint::color) {
+      for (const GradientStop &stop : paint->stops()) {
+        m_StopColors.push_back(stop.color);
+        m_StopOffsets.push_back(stop.stop);
+      }
+      stopCount = (uint32_t)paint->stops().size();
+      std::copy(paint->gradientStart(), paint->gradientStart() + 2, gradient);
+      std::copy(paint->gradientEnd(), paint->gradientEnd() + 2, gradient + 2);
+    }
+  }
+  uint32_t record[drawStride] = {firstIndex, indexCount, m_State.clip,
+                                 (uint32_t)type, color, blendMode,
+                                 firstStop, stopCount};
+  m_Draws.insert(m_Draws.end(), record, record + drawStride);
+  for (int i = 0; i < 6; i++) {
+    m_DrawFloats.push_back(m_State.transform[i]);
+  }
+  m_DrawFloats.insert(m_DrawFloats.end(), gradient, gradient + 4);
+  return true;
+}
+
+void MeshRenderer::drawPath(rive::RenderPath *path, rive::RenderPaint *paint) {
+  auto softwarePath = static_cast<SoftwareRenderPath *>(path);
+  auto meshPaint = static_cast<RecordingRenderPaint *>(paint);
+  MeshPaint type;
+  switch (meshPaint->gradientType()) {
+  case GradientType::linear:
+    type = MeshPaint::linear;
+    break;
+  case GradientType::radial:
+    type = MeshPaint::radial;
+    break;
+  default:
+    // Transparent colors leave the frame as is, whatever the blend mode.
+    if ((meshPaint->color() >> 24) == 0) {
+      return;
+    }
+    type = MeshPaint::color;
+    break;
+  }
+
+  float tolerance = deviceTolerance(m_State.transform);
+  if (meshPaint->style() == rive::RenderPaintStyle::stroke) {
+    addDraw(softwarePath->stroke(tolerance, meshPaint->thickness(),
+                                 meshPaint->join(), meshPaint->cap()),
+            rive::FillRule::nonZero, tolerance, type, meshPaint);
+  } else {
+    addDraw(softwarePath->fill(tolerance), softwarePath->fillRule(), tolerance,
+            type, meshPaint);
+  }
+}
+
+void MeshRenderer::clipPath(rive::RenderPath *path) {
+  auto softwarePath = static_cast<SoftwareRenderPath *>(path);
+  float tolerance = deviceTolerance(m_State.transform);
+  uint32_t clip = (uint32_t)drawCount();
+  addDraw(softwarePath->fill(tolerance), softwarePath->fillRule(), tolerance,
+          MeshPaint::clip, nullptr);
+  m_State.clip = clip;
+}
@@ -0,0 +1,90 @@
+#ifndef _RIVE_MESH_RENDERER_HPP_
+#define _RIVE_MESH_RENDERER_HPP_
+
+#include "math/mat2d.hpp"
+#include "recording_render_paint.hpp"
+#include "renderer.hpp"
+#include "software_renderer.hpp"
+#include "tessellator.hpp"
+#include <stdint.h>
+#include <vector>
+
+// How a MeshRenderer draw is shaded.
+enum class MeshPaint : uint32_t { clip = 0, color = 1, linear = 2, radial = 3 };
+
+// Tessellates what's drawn into triangle meshes for a GPU backend (WebGL or
+// WebGPU) to draw, leaving no tessellation to JS. Only works with paths and
+// paints made by the software render factory, whose paths keep their
+// flattened outlines between frames.
+//
+// A frame's meshes share one vertex and one index buffer, reused from frame
+// to frame. Each draw covers a range of the indices and comes with a record
+// of drawStride uint32s:
+//   first index, index count, clip, paint, ARGB color, blend mode,
+//   first stop, stop count
+// and one of drawFloatStride floats:
+//   transform (6), gradient start (2), gradient end (2)
+// Vertices are in the space of the draw's path, which its transform maps to
+// the device. Clip is the index of the clip draw the draw is masked by, or
+// UINT32_MAX; clip draws are masked by their enclosing clip the same way.
+// Gradient draws' stops are those from first stop in stopColors() and
+// stopOffsets().
+//
+// Paths are flattened within a quarter of a device pixel, so what's drawn
+// scaled up by align() gets finer meshes.
+class MeshRenderer : public rive::Renderer {
+public:
+  static const uint32_t drawStride = 8;
+  static const uint32_t drawFloatStride = 10;
+
+private:
+  struct State {
+    rive::Mat2D transform;
+    uint32_t clip;
+  };
+
+  State m_State;
+  std::vector<State> m_Stack;
+  Tessellator m_Tessellator;
+  std::vector<float> m_Vertices;
+  std::vector<uint32_t> m_Indices;
+  std::vector<uint32_t> m_Draws;
+  std::vector<float> m_DrawFloats;
+  std::vector<uint32_t> m_StopColors;
+  std::vector<float> m_StopOffsets;
+
+  // Tessellates path and records it as a draw, returning false if it drew
+  // nothing, in which case it's dropped unless it's a clip.
+  bool addDraw(const FlatPath &path, rive::FillRule fillRule, float tolerance,
+               MeshPaint type, const RecordingRenderPaint *paint);
+
+public:
+  MeshRenderer();
+
+  // Starts a new frame, dropping the last one's meshes but keeping their
+  // memory.
+  void clear();
+
+  size_t vertexCount() const { return m_Vertices.size() / 2; }
+  size_t indexCount() const { return m_Indices.size(); }
+  size_t drawCount() const { return m_Draws.size() / drawStride; }
+  size_t stopCount() const { return m_StopColors.size(); }
+
+  // x and y of each vertex.
+  const float *vertices() const { return m_Vertices.data(); }
+  // Three per triangle.
+  const uint32_t *indices() const { return m_Indices.data(); }
+  const uint32_t *draws() const { return m_Draws.data(); }
+  const float *drawFloats() const { return m_DrawFloats.data(); }
+  // ARGB, like paint colors.
+  const uint32_t *stopColors() const { return m_StopColors.data(); }
+  const float *stopOffsets() const { return m_StopOffsets.data(); }
+
+  void save() override;
+  void restore() override;
+  void transform(const rive::Mat2D &transform) override;
+  void drawPath(rive::RenderPath *path, rive::RenderPaint *paint) override;
+  void clipPath(rive::RenderPath *path) override;
+};
+
+#endif
@@ -0,0 +1,31 @@
+#include "arena.hpp"
+#include <new>
+#include <stdlib.h>
+
+// Replaces the global allocation functions so that objects built within an
+// Arena::Scope come from its arena; everything else uses the heap as before.
+
+void *operator new(size_t size) {
+  void *memory = Arena::allocateScoped(size);
+  if (memory == nullptr) {
+    memory = malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+      abort();
+    }
+  }
+  return memory;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void *memory) noexcept {
+  if (!Arena::deallocate(memory)) {
+    free(memory);
+  }
+}
+
+void operator delete[](void *memory) noexcept { operator delete(memory); }
+void operator delete(void *memory, size_t) noexcept { operator delete(memory); }
+void operator delete[](void *memory, size_t) noexcept {
+  operator delete(memory);
+}
@@ -0,0 +1,122 @@
+#include "rasterizer.hpp"
+#include "kernels.hpp"
+#include <algorithm>
+#include <math.h>
+
+PixelRect PixelRect::intersect(const PixelRect &other) const {
+  return {std::max(minX, other.minX), std::max(minY, other.minY),
+          std::min(maxX, other.maxX), std::min(maxY, other.maxY)};
+}
+
+void Rasterizer::begin(const PixelRect &bounds) {
+  m_Bounds = bounds;
+  // Two extra columns take the area of lines on (or just past) the right edge.
+  m_Stride = (size_t)bounds.width() + 2;
+  size_t size = m_Stride * (size_t)bounds.height();
+  // Rows are cleared as they're resolved, so the buffer is all zeros here.
+  if (m_Accumulation.size() < size) {
+    m_Accumulation.resize(size, 0.0f);
+  }
+}
+
+void Rasterizer::addLine(float x0, float y0, float x1, float y1) {
+  x0 -= m_Bounds.minX;
+  x1 -= m_Bounds.minX;
+  y0 -= m_Bounds.minY;
+  y1 -= m_Bounds.minY;
+  if (y0 == y1) {
+    return;
+  }
+  float width = (float)m_Bounds.width();
+
+  // Split the line where it leaves the bounds horizontally; the pieces outside
+  // are clamped onto the edge, where they still add their winding.
+  float splits[4];
+  int count = 0;
+  splits[count++] = 0.0f;
+  if ((x0 < 0.0f) != (x1 < 0.0f)) {
+    splits[count++] = -x0 / (x1 - x0);
+  }
+  if ((x0 > width) != (x1 > width)) {
+    splits[count++] = (width - x0) / (x1 - x0);
+  }
+  splits[count++] = 1.0f;
+  if (count == 4 && splits[1] > splits[2]) {
+    std::swap(splits[1], splits[2]);
+  }
+  for (int i = 0; i + 1 < count; i++) {
+    float ta = splits[i], tb = splits[i + 1];
+    float xa = x0 + (x1 - x0) * ta, ya = y0 + (y1 - y0) * ta;
+    float xb = x0 + (x1 - x0) * tb, yb = y0 + (y1 - y0) * tb;
+    accumulate(std::min(std::max(xa, 0.0f), width), ya,
+               std::min(std::max(xb, 0.0f), width), yb);
+  }
+}
+
+void Rasterizer::accumulate(float x0, float y0, float x1, float y1) {
+  if (y0 == y1) {
+    return;
+  }
+  float direction = 1.0f;
+  if (y0 > y1) {
+    std::swap(x0, x1);
+    std::swap(y0, y1);
+    direction = -1.0f;
+  }
+  float width = (float)m_Bounds.width();
+  float dxdy = (x1 - x0) / (y1 - y0);
+  float x = x0;
+  int start = 0;
+  if (y0 < 0.0f) {
+    x -= y0 * dxdy;
+  } else {
+    start = (int)y0;
+  }
+  x = std::min(std::max(x, 0.0f), width);
+  int end = std::min(m_Bounds.height(), (int)ceilf(y1));
+  for (int y = start; y < end; y++) {
+    float *row = m_Accumulation.data() + (size_t)y * m_Stride;
+    float dy = std::min((float)(y + 1), y1) - std::max((float)y, y0);
+    float next = std::min(std::max(x + dxdy * dy, 0.0f), width);
+    float d = dy * direction;
+    float left = std::min(x, next), right = std::max(x, next);
+    float leftFloor = floorf(left), rightCeil = ceilf(right);
+    int leftIndex = (int)leftFloor, rightIndex = (int)rightCeil;
+    if (rightIndex <= leftIndex + 1) {
+      // Within a single pixel column: split the area by the line's midpoint.
+      float middle = 0.5f * (x + next) - leftFloor;
+      row[leftIndex] += d - d * middle;
+      row[leftIndex + 1] += d * middle;
+    } else {
+      float slope = 1.0f / (right - left);
+      float leftFraction = left - leftFloor;
+      float firstArea = 0.5f * slope * (1.0f - leftFraction) * (1.0f - leftFraction);
+      float rightFraction = right - rightCeil + 1.0f;
+      float lastArea = 0.5f * slope * rightFraction * rightFraction;
+      row[leftIndex] += d * firstArea;
+      if (rightIndex == leftIndex + 2) {
+        row[leftIndex + 1] += d * (1.0f - firstArea - lastArea);
+      } else {
+        float secondArea = slope * (1.5f - leftFraction);
+        row[leftIndex + 1] += d * (secondArea - firstArea);
+        for (int i = leftIndex + 2; i < rightIndex - 1; i++) {
+          row[i] += d * slope;
+        }
+        float area = secondArea + (rightIndex - leftIndex - 3) * slope;
+        row[rightIndex - 1] += d * (1.0f - area - lastArea);
+      }
+      row[rightIndex] += d * lastArea;
+    }
+    x = next;
+  }
+}
+
+bool Rasterizer::resolveRow(int row, rive::FillRule fillRule,
+                            uint8_t *coverage) {
+  float *values = m_Accumulation.data() + (size_t)row * m_Stride;
+  int width = m_Bounds.width();
+  bool any = resolveCoverage(values, width, fillRule, coverage);
+  values[width] = 0.0f;
+  values[width + 1] = 0.0f;
+  return any;
+}
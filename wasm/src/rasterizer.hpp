@@ -0,0 +1,45 @@
+#ifndef _RIVE_RASTERIZER_HPP_
+#define _RIVE_RASTERIZER_HPP_
+
+#include "command_path.hpp"
+#include <stdint.h>
+#include <vector>
+
+// Integer pixel rectangle, empty when min reaches max.
+struct PixelRect {
+  int minX, minY, maxX, maxY;
+
+  bool isEmpty() const { return minX >= maxX || minY >= maxY; }
+  int width() const { return maxX - minX; }
+  int height() const { return maxY - minY; }
+  PixelRect intersect(const PixelRect &other) const;
+};
+
+// Scanline anti-aliased coverage of polygons within a pixel rectangle. Each
+// line adds the exact area it covers in every pixel it crosses (signed by its
+// direction) to an accumulation buffer; summing a row from the left then
+// yields the winding of each pixel, weighted by coverage, which the fill rule
+// turns into an alpha value. Lines outside the rectangle are clamped to its
+// edges, so everything to their left is still accounted for.
+class Rasterizer {
+private:
+  PixelRect m_Bounds = {0, 0, 0, 0};
+  size_t m_Stride = 0;
+  std::vector<float> m_Accumulation;
+
+  void accumulate(float x0, float y0, float x1, float y1);
+
+public:
+  // Starts rasterizing into bounds, in device pixels.
+  void begin(const PixelRect &bounds);
+  const PixelRect &bounds() const { return m_Bounds; }
+
+  void addLine(float x0, float y0, float x1, float y1);
+
+  // Writes the coverage of a row of the bounds (0 being its top row), from 0
+  // to 255, into coverage and clears the row for the next polygon. Returns
+  // false if the whole row is empty.
+  bool resolveRow(int row, rive::FillRule fillRule, uint8_t *coverage);
+};
+
+#endif
@@ -0,0 +1,100 @@
+#include "recording_render_paint.hpp"
+#include <algorithm>
+
+// Number of gradients completed by any paint on this thread, sampled by
+// StatsRecorder.
+static thread_local uint32_t gradientCount = 0;
+
+uint32_t RecordingRenderPaint::completedGradientCount() {
+  return gradientCount;
+}
+
+void RecordingRenderPaint::style(rive::RenderPaintStyle value) {
+  if (value != m_Style) {
+    m_Style = value;
+    m_Version++;
+  }
+}
+
+void RecordingRenderPaint::color(unsigned int value) {
+  if (value != m_Color || m_GradientType != GradientType::none) {
+    m_Color = value;
+    m_GradientType = GradientType::none;
+    m_Version++;
+  }
+}
+
+void RecordingRenderPaint::thickness(float value) {
+  if (value != m_Thickness) {
+    m_Thickness = value;
+    m_Version++;
+  }
+}
+
+void RecordingRenderPaint::join(rive::StrokeJoin value) {
+  if (value != m_Join) {
+    m_Join = value;
+    m_Version++;
+  }
+}
+
+void RecordingRenderPaint::cap(rive::StrokeCap value) {
+  if (value != m_Cap) {
+    m_Cap = value;
+    m_Version++;
+  }
+}
+
+void RecordingRenderPaint::blendMode(rive::BlendMode value) {
+  if (value != m_BlendMode) {
+    m_BlendMode = value;
+    m_Version++;
+  }
+}
+
+void RecordingRenderPaint::beginGradient(GradientType type, float sx, float sy,
+                                         float ex, float ey) {
+  m_NextGradientType = type;
+  m_NextGradientStart[0] = sx;
+  m_NextGradientStart[1] = sy;
+  m_NextGradientEnd[0] = ex;
+  m_NextGradientEnd[1] = ey;
+  m_NextStops.clear();
+}
+
+void RecordingRenderPaint::linearGradient(float sx, float sy, float ex,
+                                          float ey) {
+  beginGradient(GradientType::linear, sx, sy, ex, ey);
+}
+
+void RecordingRenderPaint::radialGradient(float sx, float sy, float ex,
+                                          float ey) {
+  beginGradient(GradientType::radial, sx, sy, ex, ey);
+}
+
+void RecordingRenderPaint::addStop(unsigned int color, float stop) {
+  m_NextStops.push_back({color, stop});
+}
+
+void RecordingRenderPaint::completeGradient() {
+  gradientCount++;
+  bool same = m_NextGradientType == m_GradientType &&
+              m_NextGradientStart[0] == m_GradientStart[0] &&
+              m_NextGradientStart[1] == m_GradientStart[1] &&
+              m_NextGradientEnd[0] == m_GradientEnd[0] &&
+              m_NextGradientEnd[1] == m_GradientEnd[1] &&
+              m_NextStops.size() == m_Stops.size();
+  for (size_t i = 0; same && i < m_Stops.size(); i++) {
+    same = m_NextStops[i].color == m_Stops[i].color &&
+           m_NextStops[i].stop == m_Stops[i].stop;
+  }
+  if (same) {
+    return;
+  }
+  m_GradientType = m_NextGradientType;
+  std::copy(m_NextGradientStart, m_NextGradientStart + 2, m_GradientStart);
+  std::copy(m_NextGradientEnd, m_NextGradientEnd + 2, m_GradientEnd);
+  // Swapped rather than copied, the next gradient clears it anyway.
+  m_Stops.swap(m_NextStops);
+  m_Version++;
+}
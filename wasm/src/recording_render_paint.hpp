@@ -0,0 +1,73 @@
+#ifndef _RIVE_RECORDING_RENDER_PAINT_HPP_
+#define _RIVE_RECORDING_RENDER_PAINT_HPP_
+
+#include "renderer.hpp"
+#include <stdint.h>
+#include <vector>
+
+enum class GradientType : uint32_t { none = 0, linear = 1, radial = 2 };
+
+struct GradientStop {
+  unsigned int color;
+  float stop;
+};
+
+// A RenderPaint that stores its parameters so that backends living in wasm
+// can read them back when the paint is used. Setting a parameter to the value
+// it already has, or rebuilding the same gradient, leaves the version as is.
+class RecordingRenderPaint : public rive::RenderPaint {
+protected:
+  rive::RenderPaintStyle m_Style = rive::RenderPaintStyle::fill;
+  unsigned int m_Color = 0xFF000000;
+  float m_Thickness = 1.0f;
+  rive::StrokeJoin m_Join = rive::StrokeJoin::miter;
+  rive::StrokeCap m_Cap = rive::StrokeCap::butt;
+  rive::BlendMode m_BlendMode = rive::BlendMode::srcOver;
+  GradientType m_GradientType = GradientType::none;
+  float m_GradientStart[2] = {0.0f, 0.0f};
+  float m_GradientEnd[2] = {0.0f, 0.0f};
+  std::vector<GradientStop> m_Stops;
+  uint32_t m_Version = 1;
+
+private:
+  // The gradient being built, until it's completed.
+  GradientType m_NextGradientType = GradientType::none;
+  float m_NextGradientStart[2] = {0.0f, 0.0f};
+  float m_NextGradientEnd[2] = {0.0f, 0.0f};
+  std::vector<GradientStop> m_NextStops;
+
+  void beginGradient(GradientType type, float sx, float sy, float ex,
+                     float ey);
+
+public:
+  void style(rive::RenderPaintStyle value) override;
+  void color(unsigned int value) override;
+  void thickness(float value) override;
+  void join(rive::StrokeJoin value) override;
+  void cap(rive::StrokeCap value) override;
+  void blendMode(rive::BlendMode value) override;
+  void linearGradient(float sx, float sy, float ex, float ey) override;
+  void radialGradient(float sx, float sy, float ex, float ey) override;
+  void addStop(unsigned int color, float stop) override;
+  void completeGradient() override;
+
+  rive::RenderPaintStyle style() const { return m_Style; }
+  unsigned int color() const { return m_Color; }
+  float thickness() const { return m_Thickness; }
+  rive::StrokeJoin join() const { return m_Join; }
+  rive::StrokeCap cap() const { return m_Cap; }
+  rive::BlendMode blendMode() const { return m_BlendMode; }
+  GradientType gradientType() const { return m_GradientType; }
+  const float *gradientStart() const { return m_GradientStart; }
+  const float *gradientEnd() const { return m_GradientEnd; }
+  const std::vector<GradientStop> &stops() const { return m_Stops; }
+
+  // Changes whenever any of the paint's parameters may have changed.
+  uint32_t version() const { return m_Version; }
+
+  // Total number of gradients built by any paint on the calling thread, for
+  // stats.
+  static uint32_t completedGradientCount();
+};
+
+#endif
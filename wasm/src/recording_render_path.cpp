@@ -0,0 +1,162 @@
+#include "recording_render_path.hpp"
+#include "fnv_hash.hpp"
+#include <algorithm>
+#include <float.h>
+
+// Number of times any path was rebuilt on this thread, sampled by
+// StatsRecorder around an artboard's advance, which stays on one thread.
+static thread_local uint32_t rebuildCount = 0;
+
+uint32_t RecordingRenderPath::rebuiltCount() { return rebuildCount; }
+
+void RecordingRenderPath::reset() {
+  rebuildCount++;
+  m_Commands.clear();
+  m_SubPaths.clear();
+  m_IsDirty = true;
+}
+
+uint64_t RecordingRenderPath::computeHash() {
+  uint64_t hash = hashWord(fnvOffsetBasis, (uint32_t)m_FillRule);
+  size_t length = m_Commands.size();
+  const uint32_t *words = m_Commands.data();
+  for (size_t i = 0; i < length; i++) {
+    hash = hashWord(hash, words[i]);
+  }
+  // A composite changes when any of the paths it was built from do.
+  for (auto subPath : m_SubPaths) {
+    subPath->validate();
+    uint64_t subHash = subPath->hash();
+    hash = hashWord(hash, (uint32_t)subHash);
+    hash = hashWord(hash, (uint32_t)(subHash >> 32));
+  }
+  return hash;
+}
+
+uint32_t RecordingRenderPath::validate() {
+  if (m_IsDirty) {
+    m_IsDirty = false;
+    uint64_t hash = computeHash();
+    if (hash != m_Hash) {
+      m_Hash = hash;
+      m_Version++;
+    }
+  }
+  return m_Version;
+}
+
+static void addPoint(PathBounds &bounds, float x, float y) {
+  bounds.minX = std::min(bounds.minX, x);
+  bounds.minY = std::min(bounds.minY, y);
+  bounds.maxX = std::max(bounds.maxX, x);
+  bounds.maxY = std::max(bounds.maxY, y);
+}
+
+void RecordingRenderPath::computeBounds() {
+  m_Bounds = {FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX};
+  size_t index = 0, length = m_Commands.size();
+  while (index < length) {
+    auto verb = (PathVerb)m_Commands[index];
+    if (verb == PathVerb::addPath) {
+      const PathBounds &sub = m_SubPaths[m_Commands[index + 1]]->bounds();
+      if (!sub.isEmpty()) {
+        float m[6];
+        for (int i = 0; i < 6; i++) {
+          m[i] = m_Commands.floatAt(index + 2 + i);
+        }
+        const float corners[8] = {sub.minX, sub.minY, sub.maxX, sub.minY,
+                                  sub.maxX, sub.maxY, sub.minX, sub.maxY};
+        for (int i = 0; i < 8; i += 2) {
+          float x = corners[i], y = corners[i + 1];
+          addPoint(m_Bounds, m[0] * x + m[2] * y + m[4],
+                   m[1] * x + m[3] * y + m[5]);
+        }
+      }
+      index += 8;
+      continue;
+    }
+    size_t count = pathVerbArgumentCount(verb);
+    for (size_t i = 1; i < count; i += 2) {
+      addPoint(m_Bounds, m_Commands.floatAt(index + i),
+               m_Commands.floatAt(index + i + 1));
+    }
+    index += 1 + count;
+  }
+}
+
+const PathBounds &RecordingRenderPath::bounds() {
+  uint32_t version = validate();
+  if (version != m_BoundsVersion) {
+    m_BoundsVersion = version;
+    computeBounds();
+  }
+  return m_Bounds;
+}
+
+void RecordingRenderPath::addRenderPath(rive::RenderPath *path,
+                                        const rive::Mat2D &transform) {
+  // Every RenderPath handed out by our factories records its commands, so
+  // this is safe to downcast without RTTI.
+  m_Commands.writeUint((uint32_t)PathVerb::addPath);
+  m_Commands.writeUint((uint32_t)m_SubPaths.size());
+  m_Commands.writeMatrix(transform);
+  m_SubPaths.push_back(static_cast<RecordingRenderPath *>(path));
+  m_IsDirty = true;
+}
+
+void RecordingRenderPath::fillRule(rive::FillRule value) {
+  if (m_FillRule == value) {
+    return;
+  }
+  m_FillRule = value;
+  m_IsDirty = true;
+}
+
+void RecordingRenderPath::moveTo(float x, float y) {
+  m_Commands.writeUint((uint32_t)PathVerb::move);
+  m_Commands.writeFloat(x);
+  m_Commands.writeFloat(y);
+  m_IsDirty = true;
+}
+
+void RecordingRenderPath::lineTo(float x, float y) {
+  m_Commands.writeUint((uint32_t)PathVerb::line);
+  m_Commands.writeFloat(x);
+  m_Commands.writeFloat(y);
+  m_IsDirty = true;
+}
+
+void RecordingRenderPath::cubicTo(float ox, float oy, float ix, float iy,
+                                  float x, float y) {
+  m_Commands.writeUint((uint32_t)PathVerb::cubic);
+  m_Commands.writeFloat(ox);
+  m_Commands.writeFloat(oy);
+  m_Commands.writeFloat(ix);
+  m_Commands.writeFloat(iy);
+  m_Commands.writeFloat(x);
+  m_Commands.writeFloat(y);
+  m_IsDirty = true;
+}
+
+void RecordingRenderPath::close() {
+  m_Commands.writeUint((uint32_t)PathVerb::close);
+  m_IsDirty = true;
+}
+
+static uint32_t countVerbs(const RecordingRenderPath *path) {
+  const CommandBuffer &commands = path->commands();
+  uint32_t count = 0;
+  size_t index = 0, length = commands.size();
+  while (index < length) {
+    auto verb = (PathVerb)commands[index];
+    if (verb == PathVerb::addPath) {
+      count += countVerbs(path->subPaths()[commands[index + 1]]);
+    } else {
+      count++;
+    }
+    index += 1 + pathVerbArgumentCount(verb);
+  }
+  return count;
+}
+
+uint32_t RecordingRenderPath::verbCount() const { return countVerbs(this); }
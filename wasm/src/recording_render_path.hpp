@@ -0,0 +1,107 @@
+#ifndef _RIVE_RECORDING_RENDER_PATH_HPP_
+#define _RIVE_RECORDING_RENDER_PATH_HPP_
+
+#include "command_buffer.hpp"
+#include "renderer.hpp"
+#include <stdint.h>
+#include <vector>
+
+// Verbs stored in a RecordingRenderPath's command buffer. Each verb is followed
+// by its arguments: two floats for move and line, six floats for cubic, none
+// for close and a sub path index followed by a matrix for addPath.
+enum class PathVerb : uint32_t {
+  move = 0,
+  line = 1,
+  cubic = 2,
+  close = 3,
+  addPath = 4
+};
+
+// Number of argument words that follow a verb in the command buffer.
+inline size_t pathVerbArgumentCount(PathVerb verb) {
+  switch (verb) {
+  case PathVerb::move:
+  case PathVerb::line:
+    return 2;
+  case PathVerb::cubic:
+    return 6;
+  case PathVerb::close:
+    return 0;
+  case PathVerb::addPath:
+    return 7;
+  }
+  return 0;
+}
+
+// Axis aligned bounds of a path's points; empty when min exceeds max.
+struct PathBounds {
+  float minX, minY, maxX, maxY;
+
+  bool isEmpty() const { return minX > maxX || minY > maxY; }
+};
+
+// A RenderPath that keeps the verbs it was built from in wasm memory instead
+// of forwarding each one to a backend as it arrives. Backends read the recorded
+// commands back when the path is drawn or used as a clip.
+//
+// rive-cpp rebuilds paths whenever they're marked dirty, which frequently
+// yields the same geometry as before (static shapes, settled animations). The
+// recorded content is hashed so that the version only changes when the
+// geometry really did, letting backends keep whatever they built from it.
+class RecordingRenderPath : public rive::RenderPath {
+private:
+  uint64_t m_Hash = 0;
+  bool m_IsDirty = false;
+  PathBounds m_Bounds;
+  uint32_t m_BoundsVersion = UINT32_MAX;
+
+  uint64_t computeHash();
+  void computeBounds();
+
+protected:
+  CommandBuffer m_Commands;
+  std::vector<RecordingRenderPath *> m_SubPaths;
+  rive::FillRule m_FillRule = rive::FillRule::nonZero;
+  uint32_t m_Version = 0;
+
+public:
+  void reset() override;
+  void addRenderPath(rive::RenderPath *path,
+                     const rive::Mat2D &transform) override;
+  void fillRule(rive::FillRule value) override;
+  void moveTo(float x, float y) override;
+  void lineTo(float x, float y) override;
+  void cubicTo(float ox, float oy, float ix, float iy, float x,
+               float y) override;
+  void close() override;
+
+  rive::FillRule fillRule() const { return m_FillRule; }
+  const CommandBuffer &commands() const { return m_Commands; }
+
+  // Paths added via addPath, referenced by index from addPath verbs.
+  const std::vector<RecordingRenderPath *> &subPaths() const {
+    return m_SubPaths;
+  }
+
+  // Re-hashes the path (and its sub paths) if it was rebuilt since the last
+  // validation, bumping the version only when the content changed. Call before
+  // reading the version.
+  uint32_t validate();
+
+  // Changes whenever the recorded geometry or fill rule changed.
+  uint32_t version() const { return m_Version; }
+  uint64_t hash() const { return m_Hash; }
+
+  // Bounds of the path's points, including control points and sub paths, in
+  // the path's local space. Cached until the geometry changes.
+  const PathBounds &bounds();
+
+  // Number of verbs in the path, counting those of its sub paths.
+  uint32_t verbCount() const;
+
+  // Total number of times any path has been rebuilt (reset) on the calling
+  // thread, for stats.
+  static uint32_t rebuiltCount();
+};
+
+#endif
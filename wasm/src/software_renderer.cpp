@@ -0,0 +1,488 @@
+#include "software_renderer.hpp"
+#include "kernels.hpp"
+#include <algorithm>
+#include <math.h>
+
+static uint32_t mul255(uint32_t a, uint32_t b) {
+  uint32_t value = a * b + 128;
+  return (value + (value >> 8)) >> 8;
+}
+
+static uint32_t packColor(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+  return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+// Converts an ARGB paint color to packed, premultiplied RGBA.
+static uint32_t premultipliedColor(unsigned int argb) {
+  uint32_t a = argb >> 24;
+  return packColor(mul255((argb >> 16) & 0xFF, a), mul255((argb >> 8) & 0xFF, a),
+                   mul255(argb & 0xFF, a), a);
+}
+
+const FlatPath &SoftwareRenderPath::fill(float tolerance) {
+  uint32_t version = validate();
+  // Anything flattened finer than needed is still good, unless it's much
+  // finer and would cost a lot more to rasterize.
+  if (version != m_FillVersion || m_FillTolerance > tolerance ||
+      m_FillTolerance * 4.0f < tolerance) {
+    m_FillVersion = version;
+    m_FillTolerance = tolerance;
+    m_Fill.clear();
+    flattenPath(this, tolerance, m_Fill);
+  }
+  return m_Fill;
+}
+
+const FlatPath &SoftwareRenderPath::stroke(float tolerance, float thickness,
+                                           rive::StrokeJoin join,
+                                           rive::StrokeCap cap) {
+  const FlatPath &center = fill(tolerance);
+  if (m_StrokeVersion != m_FillVersion ||
+      m_StrokeTolerance != m_FillTolerance || m_StrokeThickness != thickness ||
+      m_StrokeJoin != join || m_StrokeCap != cap) {
+    m_StrokeVersion = m_FillVersion;
+    m_StrokeTolerance = m_FillTolerance;
+    m_StrokeThickness = thickness;
+    m_StrokeJoin = join;
+    m_StrokeCap = cap;
+    m_Stroke.clear();
+    strokePath(center, thickness, join, cap, m_FillTolerance, m_Stroke);
+  }
+  return m_Stroke;
+}
+
+const uint32_t *SoftwareRenderPaint::ramp() {
+  if (m_RampVersion == m_Version) {
+    return m_Ramp;
+  }
+  m_RampVersion = m_Version;
+  if (m_Stops.empty()) {
+    std::fill(m_Ramp, m_Ramp + rampSize, 0);
+    return m_Ramp;
+  }
+  size_t stop = 0, last = m_Stops.size() - 1;
+  for (int i = 0; i < rampSize; i++) {
+    float t = i / (float)(rampSize - 1);
+    while (stop < last && m_Stops[stop + 1].stop < t) {
+      stop++;
+    }
+    unsigned int from = m_Stops[stop].color;
+    unsigned int to = m_Stops[std::min(stop + 1, last)].color;
+    float start = m_Stops[stop].stop;
+    float end = m_Stops[std::min(stop + 1, last)].stop;
+    float f = end > start ? (t - start) / (end - start) : 0.0f;
+    f = std::min(std::max(f, 0.0f), 1.0f);
+    // Interpolated unpremultiplied, like canvas gradients.
+    uint32_t argb = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+      float a = (float)((from >> shift) & 0xFF);
+      float b = (float)((to >> shift) & 0xFF);
+      argb |= (uint32_t)(a + (b - a) * f + 0.5f) << shift;
+    }
+    m_Ramp[i] = premultipliedColor(argb);
+  }
+  return m_Ramp;
+}
+
+// Blend functions on unpremultiplied components, as defined by the W3C
+// compositing spec.
+static float blendChannel(rive::BlendMode mode, float cb, float cs) {
+  switch (mode) {
+  case rive::BlendMode::screen:
+    return cb + cs - cb * cs;
+  case rive::BlendMode::overlay:
+    return blendChannel(rive::BlendMode::hardLight, cs, cb);
+  case rive::BlendMode::darken:
+    return std::min(cb, cs);
+  case rive::BlendMode::lighten:
+    return std::max(cb, cs);
+  case rive::BlendMode::colorDodge:
+    if (cb == 0.0f) {
+      return 0.0f;
+    }
+    return cs >= 1.0f ? 1.0f : std::min(1.0f, cb / (1.0f - cs));
+  case rive::BlendMode::colorBurn:
+    if (cb >= 1.0f) {
+      return 1.0f;
+    }
+    return cs == 0.0f ? 0.0f : 1.0f - std::min(1.0f, (1.0f - cb) / cs);
+  case rive::BlendMode::hardLight:
+    return cs <= 0.5f ? cb * 2.0f * cs
+                      : blendChannel(rive::BlendMode::screen, cb,
+                                     2.0f * cs - 1.0f);
+  case rive::BlendMode::softLight: {
+    if (cs <= 0.5f) {
+      return cb - (1.0f - 2.0f * cs) * cb * (1.0f - cb);
+    }
+    float d = cb <= 0.25f ? ((16.0f * cb - 12.0f) * cb + 4.0f) * cb
+                          : sqrtf(cb);
+    return cb + (2.0f * cs - 1.0f) * (d - cb);
+  }
+  case rive::BlendMode::difference:
+    return fabsf(cb - cs);
+  case rive::BlendMode::exclusion:
+    return cb + cs - 2.0f * cb * cs;
+  case rive::BlendMode::multiply:
+    return cb * cs;
+  default:
+    return cs;
+  }
+}
+
+static float luminosity(const float *c) {
+  return 0.3f * c[0] + 0.59f * c[1] + 0.11f * c[2];
+}
+
+static void setLuminosity(float *c, float l) {
+  float d = l - luminosity(c);
+  for (int i = 0; i < 3; i++) {
+    c[i] += d;
+  }
+  l = luminosity(c);
+  float n = std::min(c[0], std::min(c[1], c[2]));
+  float x = std::max(c[0], std::max(c[1], c[2]));
+  for (int i = 0; i < 3; i++) {
+    if (n < 0.0f) {
+      c[i] = l + (c[i] - l) * l / (l - n);
+    }
+    if (x > 1.0f) {
+      c[i] = l + (c[i] - l) * (1.0f - l) / (x - l);
+    }
+  }
+}
+
+static float saturation(const float *c) {
+  return std::max(c[0], std::max(c[1], c[2])) -
+         std::min(c[0], std::min(c[1], c[2]));
+}
+
+static void setSaturation(float *c, float s) {
+  int min = 0, mid = 1, max = 2;
+  if (c[min] > c[mid]) {
+    std::swap(min, mid);
+  }
+  if (c[mid] > c[max]) {
+    std::swap(mid, max);
+  }
+  if (c[min] > c[mid]) {
+    std::swap(min, mid);
+  }
+  if (c[max] > c[min]) {
+    c[mid] = (c[mid] - c[min]) * s / (c[max] - c[min]);
+    c[max] = s;
+  } else {
+    c[mid] = c[max] = 0.0f;
+  }
+  c[min] = 0.0f;
+}
+
+// Blends whole colors for the non separable modes; result starts out as the
+// source color.
+static void blendColor(rive::BlendMode mode, const float *cb, float *result) {
+  switch (mode) {
+  case rive::BlendMode::hue: {
+    float l = luminosity(cb);
+    setSaturation(result, saturation(cb));
+    setLuminosity(result, l);
+    break;
+  }
+  case rive::BlendMode::saturation: {
+    float s = saturation(result);
+    for (int i = 0; i < 3; i++) {
+      result[i] = cb[i];
+    }
+    setSaturation(result, s);
+    setLuminosity(result, luminosity(cb));
+    break;
+  }
+  case rive::BlendMode::color:
+    setLuminosity(result, luminosity(cb));
+    break;
+  case rive::BlendMode::luminosity: {
+    float l = luminosity(result);
+    for (int i = 0; i < 3; i++) {
+      result[i] = cb[i];
+    }
+    setLuminosity(result, l);
+    break;
+  }
+  default:
+    for (int i = 0; i < 3; i++) {
+      result[i] = blendChannel(mode, cb[i], result[i]);
+    }
+    break;
+  }
+}
+
+// Composites premultiplied colors (a single one if step is 0) over a row of
+// pixels, weighted by coverage.
+static void blendRow(uint8_t *pixels, const uint32_t *colors, size_t step,
+                     const uint8_t *coverage, int count,
+                     rive::BlendMode mode) {
+  if (mode == rive::BlendMode::srcOver) {
+    blendSrcOver(pixels, colors, step, coverage, count);
+    return;
+  }
+
+  const float scale = 1.0f / 255.0f;
+  for (int i = 0; i < count; i++, pixels += 4) {
+    if (coverage[i] == 0) {
+      continue;
+    }
+    uint32_t color = colors[i * step];
+    float c = coverage[i] * scale;
+    float sa = (color >> 24) * scale * c;
+    float da = pixels[3] * scale;
+    if (sa == 0.0f) {
+      continue;
+    }
+    float source[3], backdrop[3], blended[3];
+    for (int j = 0; j < 3; j++) {
+      source[j] = ((color >> (j * 8)) & 0xFF) * scale * c;
+      backdrop[j] = pixels[j] * scale;
+      blended[j] = source[j] / sa;
+    }
+    if (da > 0.0f) {
+      float cb[3] = {backdrop[0] / da, backdrop[1] / da, backdrop[2] / da};
+      blendColor(mode, cb, blended);
+    }
+    for (int j = 0; j < 3; j++) {
+      float value = source[j] * (1.0f - da) + backdrop[j] * (1.0f - sa) +
+                    sa * da * std::min(std::max(blended[j], 0.0f), 1.0f);
+      pixels[j] = (uint8_t)(std::min(value, 1.0f) * 255.0f + 0.5f);
+    }
+    pixels[3] = (uint8_t)((sa + da - sa * da) * 255.0f + 0.5f);
+  }
+}
+
+SoftwareRenderer::SoftwareRenderer(int width, int height) {
+  m_State.clip = -1;
+  resize(width, height);
+}
+
+void SoftwareRenderer::resize(int width, int height) {
+  m_Width = std::max(width, 0);
+  m_Height = std::max(height, 0);
+  m_Pixels.assign((size_t)m_Width * m_Height * 4, 0);
+  // Masks were computed for the old size.
+  m_Stack.clear();
+  m_State.clip = -1;
+  m_ClipCount = 0;
+}
+
+void SoftwareRenderer::clear(unsigned int color) {
+  uint32_t value = premultipliedColor(color);
+  uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8),
+                      (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+  for (size_t i = 0, length = m_Pixels.size(); i < length; i += 4) {
+    m_Pixels[i] = bytes[0];
+    m_Pixels[i + 1] = bytes[1];
+    m_Pixels[i + 2] = bytes[2];
+    m_Pixels[i + 3] = bytes[3];
+  }
+}
+
+const uint8_t *SoftwareRenderer::unpremultipliedPixels() {
+  m_Unpremultiplied.resize(m_Pixels.size());
+  for (size_t i = 0, length = m_Pixels.size(); i < length; i += 4) {
+    uint32_t a = m_Pixels[i + 3];
+    for (int j = 0; j < 3; j++) {
+      m_Unpremultiplied[i + j] =
+          a == 0 ? 0
+                 : (uint8_t)std::min(255u, (m_Pixels[i + j] * 255 + a / 2) / a);
+    }
+    m_Unpremultiplied[i + 3] = (uint8_t)a;
+  }
+  return m_Unpremultiplied.data();
+}
+
+void SoftwareRenderer::save() { m_Stack.push_back(m_State); }
+
+void SoftwareRenderer::restore() {
+  if (m_Stack.empty()) {
+    return;
+  }
+  m_State = m_Stack.back();
+  m_Stack.pop_back();
+  m_ClipCount = (size_t)(m_State.clip + 1);
+}
+
+void SoftwareRenderer::transform(const rive::Mat2D &transform) {
+  rive::Mat2D result;
+  rive::Mat2D::multiply(result, m_State.transform, transform);
+  m_State.transform = result;
+}
+
+PixelRect SoftwareRenderer::drawableBounds() const {
+  PixelRect bounds = {0, 0, m_Width, m_Height};
+  if (m_State.clip >= 0) {
+    bounds = bounds.intersect(m_Clips[m_State.clip].bounds);
+  }
+  return bounds;
+}
+
+bool SoftwareRenderer::rasterize(const FlatPath &path,
+                                 const PixelRect &limit) {
+  if (limit.isEmpty() || path.points.empty()) {
+    return false;
+  }
+  m_Points.resize(path.points.size());
+  PathBounds points = transformPoints(m_State.transform, path.points.data(),
+                                      path.points.size(), m_Points.data());
+  // Clamped while still floats, so that far away geometry can't overflow.
+  PixelRect bounds = {
+      (int)std::max(floorf(points.minX), (float)limit.minX),
+      (int)std::max(floorf(points.minY), (float)limit.minY),
+      (int)std::min(ceilf(points.maxX), (float)limit.maxX),
+      (int)std::min(ceilf(points.maxY), (float)limit.maxY),
+  };
+  if (bounds.isEmpty()) {
+    return false;
+  }
+
+  m_Rasterizer.begin(bounds);
+  for (size_t contour = 0; contour < path.contourCount(); contour++) {
+    uint32_t start = path.contourStart(contour);
+    uint32_t end = path.contourEnds[contour];
+    // Fills are implicitly closed.
+    for (uint32_t i = start, j = end - 1; i < end; j = i++) {
+      m_Rasterizer.addLine(m_Points[j].x, m_Points[j].y, m_Points[i].x,
+                           m_Points[i].y);
+    }
+  }
+  if (m_Coverage.size() < (size_t)bounds.width()) {
+    m_Coverage.resize(bounds.width());
+  }
+  return true;
+}
+
+void SoftwareRenderer::applyClip(int clip, int y, int x, int count,
+                                 uint8_t *coverage) const {
+  if (clip < 0) {
+    return;
+  }
+  const ClipMask &mask = m_Clips[clip];
+  const uint8_t *values =
+      mask.coverage.data() +
+      (size_t)(y - mask.bounds.minY) * mask.bounds.width() +
+      (x - mask.bounds.minX);
+  for (int i = 0; i < count; i++) {
+    coverage[i] = (uint8_t)mul255(coverage[i], values[i]);
+  }
+}
+
+const uint32_t *SoftwareRenderer::shadeRow(SoftwareRenderPaint *paint,
+                                           const rive::Mat2D &inverse, int y,
+                                           int x, int count) {
+  if (m_Colors.size() < (size_t)count) {
+    m_Colors.resize(count);
+  }
+  const uint32_t *ramp = paint->ramp();
+  const int last = SoftwareRenderPaint::rampSize - 1;
+  float sx = paint->gradientStart()[0], sy = paint->gradientStart()[1];
+  float dx = paint->gradientEnd()[0] - sx, dy = paint->gradientEnd()[1] - sy;
+  float lengthSquared = dx * dx + dy * dy;
+  if (lengthSquared == 0.0f) {
+    std::fill(m_Colors.begin(), m_Colors.begin() + count, ramp[last]);
+    return m_Colors.data();
+  }
+
+  // Pixel centers in the gradient's space, stepping along the row.
+  float px = x + 0.5f, py = y + 0.5f;
+  float lx = inverse[0] * px + inverse[2] * py + inverse[4] - sx;
+  float ly = inverse[1] * px + inverse[3] * py + inverse[5] - sy;
+  if (paint->gradientType() == GradientType::linear) {
+    float scale = last / lengthSquared;
+    for (int i = 0; i < count; i++, lx += inverse[0], ly += inverse[1]) {
+      int index = (int)((lx * dx + ly * dy) * scale + 0.5f);
+      m_Colors[i] = ramp[std::min(std::max(index, 0), last)];
+    }
+  } else {
+    float scale = last / sqrtf(lengthSquared);
+    for (int i = 0; i < count; i++, lx += inverse[0], ly += inverse[1]) {
+      int index = (int)(sqrtf(lx * lx + ly * ly) * scale + 0.5f);
+      m_Colors[i] = ramp[std::min(index, last)];
+    }
+  }
+  return m_Colors.data();
+}
+
+void SoftwareRenderer::drawPath(rive::RenderPath *path,
+                                rive::RenderPaint *paint) {
+  auto softwarePath = static_cast<SoftwareRenderPath *>(path);
+  auto softwarePaint = static_cast<SoftwareRenderPaint *>(paint);
+  const rive::Mat2D &transform = m_State.transform;
+  bool isGradient = softwarePaint->gradientType() != GradientType::none;
+  uint32_t color = premultipliedColor(softwarePaint->color());
+  rive::Mat2D inverse;
+  if (isGradient) {
+    if (!rive::Mat2D::invert(inverse, transform)) {
+      return;
+    }
+  } else if ((color >> 24) == 0) {
+    // Transparent colors leave the canvas as is, whatever the blend mode.
+    return;
+  }
+
+  float tolerance = deviceTolerance(transform);
+  rive::FillRule fillRule = softwarePath->fillRule();
+  const FlatPath *outline;
+  if (softwarePaint->style() == rive::RenderPaintStyle::stroke) {
+    outline = &softwarePath->stroke(tolerance, softwarePaint->thickness(),
+                                    softwarePaint->join(),
+                                    softwarePaint->cap());
+    fillRule = rive::FillRule::nonZero;
+  } else {
+    outline = &softwarePath->fill(tolerance);
+  }
+  if (!rasterize(*outline, drawableBounds())) {
+    return;
+  }
+
+  const PixelRect &bounds = m_Rasterizer.bounds();
+  int count = bounds.width();
+  uint8_t *coverage = m_Coverage.data();
+  for (int row = 0; row < bounds.height(); row++) {
+    if (!m_Rasterizer.resolveRow(row, fillRule, coverage)) {
+      continue;
+    }
+    int y = bounds.minY + row;
+    applyClip(m_State.clip, y, bounds.minX, count, coverage);
+    uint8_t *pixels =
+        m_Pixels.data() + ((size_t)y * m_Width + bounds.minX) * 4;
+    if (isGradient) {
+      blendRow(pixels, shadeRow(softwarePaint, inverse, y, bounds.minX, count),
+               1, coverage, count, softwarePaint->blendMode());
+    } else {
+      blendRow(pixels, &color, 0, coverage, count,
+               softwarePaint->blendMode());
+    }
+  }
+}
+
+void SoftwareRenderer::clipPath(rive::RenderPath *path) {
+  auto softwarePath = static_cast<SoftwareRenderPath *>(path);
+  float tolerance = deviceTolerance(m_State.transform);
+  PixelRect limit = drawableBounds();
+  int previous = m_State.clip;
+  if (m_ClipCount == m_Clips.size()) {
+    m_Clips.emplace_back();
+  }
+  m_State.clip = (int)m_ClipCount++;
+  ClipMask &mask = m_Clips[m_State.clip];
+
+  if (!rasterize(softwarePath->fill(tolerance), limit)) {
+    // Nothing remains drawable.
+    mask.bounds = {0, 0, 0, 0};
+    return;
+  }
+  mask.bounds = m_Rasterizer.bounds();
+  int width = mask.bounds.width();
+  mask.coverage.resize((size_t)width * mask.bounds.height());
+  for (int row = 0; row < mask.bounds.height(); row++) {
+    uint8_t *coverage = mask.coverage.data() + (size_t)row * width;
+    m_Rasterizer.resolveRow(row, softwarePath->fillRule(), coverage);
+    applyClip(previous, mask.bounds.minY + row, mask.bounds.minX, width,
+              coverage);
+  }
+}
@@ -0,0 +1,123 @@
+#ifndef _RIVE_SOFTWARE_RENDERER_HPP_
+#define _RIVE_SOFTWARE_RENDERER_HPP_
+
+#include "flat_path.hpp"
+#include "math/mat2d.hpp"
+#include "rasterizer.hpp"
+#include "recording_render_paint.hpp"
+#include "recording_render_path.hpp"
+#include "renderer.hpp"
+#include <stdint.h>
+#include <vector>
+
+// A path that keeps its flattened fill and stroke outline around, rebuilding
+// them only when its geometry, the stroke or the required precision changed.
+class SoftwareRenderPath : public RecordingRenderPath {
+private:
+  FlatPath m_Fill;
+  uint32_t m_FillVersion = UINT32_MAX;
+  float m_FillTolerance = 0.0f;
+
+  FlatPath m_Stroke;
+  uint32_t m_StrokeVersion = UINT32_MAX;
+  float m_StrokeTolerance = 0.0f;
+  float m_StrokeThickness = 0.0f;
+  rive::StrokeJoin m_StrokeJoin = rive::StrokeJoin::miter;
+  rive::StrokeCap m_StrokeCap = rive::StrokeCap::butt;
+
+public:
+  // The path flattened to lines within tolerance, in local space.
+  const FlatPath &fill(float tolerance);
+  // Outline of the path stroked with the given parameters, in local space.
+  const FlatPath &stroke(float tolerance, float thickness,
+                         rive::StrokeJoin join, rive::StrokeCap cap);
+};
+
+// A paint that keeps its gradient as a ramp of colors, rebuilt when the
+// gradient changed.
+class SoftwareRenderPaint : public RecordingRenderPaint {
+public:
+  static const int rampSize = 256;
+
+private:
+  uint32_t m_Ramp[rampSize];
+  uint32_t m_RampVersion = 0;
+
+public:
+  // Premultiplied RGBA colors (red in the low byte) along the gradient.
+  const uint32_t *ramp();
+};
+
+// Renders into an RGBA buffer on the CPU, with anti-aliased scanline
+// rasterization. Only works with paths and paints made by the software render
+// factory.
+//
+// Pixels are stored premultiplied with bytes in RGBA order, which is what
+// canvas' ImageData holds for opaque content; unpremultipliedPixels() converts
+// them when the result has transparency.
+class SoftwareRenderer : public rive::Renderer {
+private:
+  struct State {
+    rive::Mat2D transform;
+    // Index of the clip mask in effect, -1 if unclipped.
+    int clip;
+  };
+  // Coverage of the intersection of the clips applied so far; zero outside
+  // of bounds.
+  struct ClipMask {
+    PixelRect bounds;
+    std::vector<uint8_t> coverage;
+  };
+
+  int m_Width = 0;
+  int m_Height = 0;
+  std::vector<uint8_t> m_Pixels;
+  std::vector<uint8_t> m_Unpremultiplied;
+  State m_State;
+  std::vector<State> m_Stack;
+  // Masks are only ever added after those of the enclosing states, so a
+  // restore drops the ones past the restored state's; their memory is kept
+  // for reuse.
+  std::vector<ClipMask> m_Clips;
+  size_t m_ClipCount = 0;
+  Rasterizer m_Rasterizer;
+  std::vector<FlatPoint> m_Points;
+  std::vector<uint8_t> m_Coverage;
+  std::vector<uint32_t> m_Colors;
+
+  // Pixels the current clip leaves drawable.
+  PixelRect drawableBounds() const;
+  // Starts rasterizing the path, transformed to device space, within limit.
+  // Returns false if it covers none of it; otherwise every row of the
+  // rasterizer's bounds must then be resolved.
+  bool rasterize(const FlatPath &path, const PixelRect &limit);
+  void applyClip(int clip, int y, int x, int count, uint8_t *coverage) const;
+  const uint32_t *shadeRow(SoftwareRenderPaint *paint,
+                           const rive::Mat2D &inverse, int y, int x,
+                           int count);
+
+public:
+  SoftwareRenderer(int width, int height);
+
+  int width() const { return m_Width; }
+  int height() const { return m_Height; }
+  void resize(int width, int height);
+
+  // Fills every pixel with color (ARGB, like paint colors), e.g. 0 to clear
+  // to transparent before drawing a frame.
+  void clear(unsigned int color);
+
+  // Premultiplied RGBA pixels, row by row.
+  const uint8_t *pixels() const { return m_Pixels.data(); }
+  // The pixels converted to straight (unpremultiplied) alpha.
+  const uint8_t *unpremultipliedPixels();
+  size_t byteLength() const { return m_Pixels.size(); }
+
+  void save() override;
+  void restore() override;
+  void transform(const rive::Mat2D &transform) override;
+  void drawPath(rive::RenderPath *path, rive::RenderPaint *paint) override;
+  void clipPath(rive::RenderPath *path) override;
+};
+
+#endif
@@ -0,0 +1,212 @@
+#include "tessellator.hpp"
+#include <algorithm>
+#include <math.h>
+
+float Tessellator::Edge::x(float y) const {
+  if (y <= y0) {
+    return x0;
+  }
+  if (y >= y1) {
+    return x1;
+  }
+  return x0 + (x1 - x0) * (y - y0) / (y1 - y0);
+}
+
+static int sign(float value) { return (value > 0.0f) - (value < 0.0f); }
+
+// Whether the closed polygon turns the same way at every point and goes
+// around only once, so that fanning it from any point covers it exactly.
+static bool isConvex(const FlatPoint *points, size_t count) {
+  int turn = 0, xFlips = 0, yFlips = 0;
+  int firstDx = 0, firstDy = 0, lastDx = 0, lastDy = 0;
+  for (size_t i = 0; i < count; i++) {
+    const FlatPoint &a = points[i];
+    const FlatPoint &b = points[(i + 1) % count];
+    const FlatPoint &c = points[(i + 2) % count];
+    int cross = sign((b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x));
+    if (cross != 0) {
+      if (turn != 0 && cross != turn) {
+        return false;
+      }
+      turn = cross;
+    }
+    int dx = sign(b.x - a.x), dy = sign(b.y - a.y);
+    if (dx != 0) {
+      xFlips += lastDx != 0 && dx != lastDx;
+      firstDx = firstDx == 0 ? dx : firstDx;
+      lastDx = dx;
+    }
+    if (dy != 0) {
+      yFlips += lastDy != 0 && dy != lastDy;
+      firstDy = firstDy == 0 ? dy : firstDy;
+      lastDy = dy;
+    }
+  }
+  xFlips += firstDx != lastDx;
+  yFlips += firstDy != lastDy;
+  return xFlips <= 2 && yFlips <= 2;
+}
+
+void Tessellator::fill(const FlatPath &path, rive::FillRule fillRule,
+                       float tolerance, std::vector<float> &vertices,
+                       std::vector<uint32_t> &indices) {
+  if (path.contourCount() == 1 && path.points.size() >= 3 &&
+      isConvex(path.points.data(), path.points.size())) {
+    uint32_t first = (uint32_t)(vertices.size() / 2);
+    for (const FlatPoint &point : path.points) {
+      vertices.push_back(point.x);
+      vertices.push_back(point.y);
+    }
+    for (uint32_t i = 2; i < path.points.size(); i++) {
+      indices.push_back(first);
+      indices.push_back(first + i - 1);
+      indices.push_back(first + i);
+    }
+    return;
+  }
+
+  // Contours are filled as if closed, whether they are or not.
+  m_Edges.clear();
+  m_Ys.clear();
+  for (size_t contour = 0; contour < path.contourCount(); contour++) {
+    uint32_t start = path.contourStart(contour);
+    uint32_t end = path.contourEnds[contour];
+    if (end - start < 3) {
+      continue;
+    }
+    for (uint32_t i = start; i < end; i++) {
+      FlatPoint a = path.points[i];
+      FlatPoint b = path.points[i + 1 < end ? i + 1 : start];
+      if (a.y == b.y) {
+        continue;
+      }
+      int winding = 1;
+      if (a.y > b.y) {
+        std::swap(a, b);
+        winding = -1;
+      }
+      m_Edges.push_back({a.x, a.y, b.x, b.y, winding, UINT32_MAX, 0.0f,
+                         0.0f, 0.0f});
+      m_Ys.push_back(a.y);
+      m_Ys.push_back(b.y);
+    }
+  }
+  if (m_Edges.empty()) {
+    return;
+  }
+  std::sort(m_Edges.begin(), m_Edges.end(),
+            [](const Edge &a, const Edge &b) { return a.y0 < b.y0; });
+  std::sort(m_Ys.begin(), m_Ys.end());
+  m_Ys.erase(std::unique(m_Ys.begin(), m_Ys.end()), m_Ys.end());
+  sweep(fillRule, tolerance, vertices, indices);
+}
+
+uint32_t Tessellator::vertexAt(Edge *edge, float y, float x,
+                               std::vector<float> &vertices) {
+  if (edge->vertex == UINT32_MAX || edge->vertexY != y) {
+    edge->vertex = (uint32_t)(vertices.size() / 2);
+    edge->vertexY = y;
+    vertices.push_back(x);
+    vertices.push_back(y);
+  }
+  return edge->vertex;
+}
+
+void Tessellator::sweep(rive::FillRule fillRule, float tolerance,
+                        std::vector<float> &vertices,
+                        std::vector<uint32_t> &indices) {
+  // Crossings of less than this are noise, e.g. from edges of a stroke's
+  // overlapping segments that lie on top of each other.
+  float slack = tolerance / 16.0f;
+  size_t next = 0;
+  m_Active.clear();
+  for (size_t i = 0; i + 1 < m_Ys.size(); i++) {
+    float top = m_Ys[i];
+    auto ended = [top](Edge *edge) { return edge->y1 <= top; };
+    m_Active.erase(std::remove_if(m_Active.begin(), m_Active.end(), ended),
+                   m_Active.end());
+    while (next < m_Edges.size() && m_Edges[next].y0 <= top) {
+      m_Active.push_back(&m_Edges[next++]);
+    }
+
+    while (top < m_Ys[i + 1]) {
+      float bottom = m_Ys[i + 1];
+      for (Edge *edge : m_Active) {
+        edge->top = edge->x(top);
+        edge->bottom = edge->x(bottom);
+      }
+      // The order hardly changes from one slab to the next.
+      for (size_t j = 1; j < m_Active.size(); j++) {
+        Edge *edge = m_Active[j];
+        size_t k = j;
+        for (; k > 0; k--) {
+          Edge *previous = m_Active[k - 1];
+          if (previous->top < edge->top ||
+              (previous->top == edge->top &&
+               previous->bottom <= edge->bottom)) {
+            break;
+          }
+          m_Active[k] = previous;
+        }
+        m_Active[k] = edge;
+      }
+
+      // Edges only swap places where neighbours cross, so ending the slab at
+      // the first such crossing keeps the order valid throughout.
+      float crossing = bottom;
+      for (size_t j = 1; j < m_Active.size(); j++) {
+        Edge *left = m_Active[j - 1];
+        Edge *right = m_Active[j];
+        float overlap = left->bottom - right->bottom;
+        if (overlap > slack) {
+          float gap = right->top - left->top;
+          float y = top + (bottom - top) * gap / (gap + overlap);
+          crossing = std::min(crossing, std::max(y, nextafterf(top, bottom)));
+        }
+      }
+      if (crossing < bottom) {
+        bottom = crossing;
+        for (Edge *edge : m_Active) {
+          edge->bottom = edge->x(bottom);
+        }
+      }
+
+      int winding = 0;
+      Edge *left = nullptr;
+      for (Edge *edge : m_Active) {
+        winding += edge->winding;
+        bool inside = fillRule == rive::FillRule::evenOdd ? (winding & 1) != 0
+                                                          : winding != 0;
+        if (inside == (left != nullptr)) {
+          continue;
+        }
+        if (inside) {
+          left = edge;
+          continue;
+        }
+        Edge *right = edge;
+        bool hasTop = right->top > left->top;
+        bool hasBottom = right->bottom > left->bottom;
+        if (hasTop || hasBottom) {
+          uint32_t topLeft = vertexAt(left, top, left->top, vertices);
+          uint32_t topRight = vertexAt(right, top, right->top, vertices);
+          uint32_t bottomLeft = vertexAt(left, bottom, left->bottom, vertices);
+          uint32_t bottomRight =
+              vertexAt(right, bottom, right->bottom, vertices);
+          if (hasTop) {
+            indices.push_back(topLeft);
+            indices.push_back(topRight);
+            indices.push_back(bottomRight);
+          }
+          if (hasBottom) {
+            indices.push_back(topLeft);
+            indices.push_back(bottomRight);
+            indices.push_back(bottomLeft);
+          }
+        }
+        left = nullptr;
+      }
+      top = bottom;
+    }
+  }
+}
@@ -0,0 +1,50 @@
+#ifndef _RIVE_TESSELLATOR_HPP_
+#define _RIVE_TESSELLATOR_HPP_
+
+#include "flat_path.hpp"
+#include <stdint.h>
+#include <vector>
+
+// Triangulates flattened paths into indexed meshes whose triangles don't
+// overlap and cover exactly what the fill rule fills, so they can be drawn in
+// a single pass without a stencil.
+//
+// Single convex contours are fanned from their first point. Anything else is
+// swept top to bottom: every vertex (and every crossing of two edges) starts
+// a new horizontal slab in which the edges keep their order, so walking them
+// left to right while summing their windings yields the filled spans, each
+// one a trapezoid. Vertices are shared where consecutive trapezoids meet
+// along an edge.
+class Tessellator {
+private:
+  struct Edge {
+    float x0, y0, x1, y1;
+    // 1 going down, -1 going up.
+    int winding;
+    // Index of the vertex last emitted along the edge and where.
+    uint32_t vertex;
+    float vertexY;
+    // Where the edge crosses the current slab's top and bottom.
+    float top, bottom;
+
+    float x(float y) const;
+  };
+
+  std::vector<Edge> m_Edges;
+  std::vector<Edge *> m_Active;
+  std::vector<float> m_Ys;
+
+  uint32_t vertexAt(Edge *edge, float y, float x, std::vector<float> &vertices);
+  void sweep(rive::FillRule fillRule, float tolerance,
+             std::vector<float> &vertices, std::vector<uint32_t> &indices);
+
+public:
+  // Appends the triangles filling path to the mesh: x and y pairs to
+  // vertices and three indices per triangle, counting from the start of
+  // vertices, to indices. Edges crossing by less than tolerance (the path's
+  // flattening tolerance) are taken as touching.
+  void fill(const FlatPath &path, rive::FillRule fillRule, float tolerance,
+            std::vector<float> &vertices, std::vector<uint32_t> &indices);
+};
+
+#endif
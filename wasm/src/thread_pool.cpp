@@ -0,0 +1,140 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+
+#ifdef RIVE_USE_THREADS
+
+ThreadPool::ThreadPool(size_t threadCount) {
+  m_Queues.push_back(new Queue());
+  for (size_t i = 0; i < threadCount; i++) {
+    m_Queues.push_back(new Queue());
+  }
+  for (size_t i = 0; i < threadCount; i++) {
+    m_Threads.emplace_back(&ThreadPool::workerMain, this, i + 1);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stopping = true;
+  }
+  m_WorkAvailable.notify_all();
+  for (auto &thread : m_Threads) {
+    thread.join();
+  }
+  for (auto queue : m_Queues) {
+    delete queue;
+  }
+}
+
+size_t ThreadPool::threadCount() const { return m_Threads.size(); }
+
+size_t ThreadPool::hardwareThreadCount() {
+  return std::thread::hardware_concurrency();
+}
+
+bool ThreadPool::takeChunk(size_t queue, Chunk &chunk) {
+  size_t count = m_Queues.size();
+  for (size_t i = 0; i < count; i++) {
+    Queue *from = m_Queues[(queue + i) % count];
+    std::lock_guard<std::mutex> lock(from->mutex);
+    if (from->head == from->chunks.size()) {
+      continue;
+    }
+    if (i == 0) {
+      chunk = from->chunks.back();
+      from->chunks.pop_back();
+    } else {
+      chunk = from->chunks[from->head++];
+    }
+    if (from->head == from->chunks.size()) {
+      from->chunks.clear();
+      from->head = 0;
+    }
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::work(size_t queue) {
+  Chunk chunk;
+  while (takeChunk(queue, chunk)) {
+    // The job was set before any chunk was queued.
+    for (size_t i = chunk.begin; i < chunk.end; i++) {
+      (*m_Job)(i);
+    }
+    m_Remaining.fetch_sub(chunk.end - chunk.begin);
+  }
+}
+
+void ThreadPool::workerMain(size_t queue) {
+  uint64_t generation = 0;
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  while (true) {
+    m_WorkAvailable.wait(lock, [&] {
+      return m_Stopping || m_Generation != generation;
+    });
+    if (m_Stopping) {
+      return;
+    }
+    generation = m_Generation;
+    m_Busy++;
+    lock.unlock();
+    work(queue);
+    lock.lock();
+    if (--m_Busy == 0) {
+      m_WorkDone.notify_all();
+    }
+  }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const Job &job) {
+  if (grain == 0) {
+    grain = 1;
+  }
+  if (m_Threads.empty() || count <= grain) {
+    for (size_t i = 0; i < count; i++) {
+      job(i);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Job = &job;
+    m_Remaining = count;
+    // Deal the chunks out round robin so every thread starts with a share.
+    size_t queueCount = m_Queues.size();
+    size_t index = 0;
+    for (size_t begin = 0; begin < count; begin += grain, index++) {
+      Queue *queue = m_Queues[index % queueCount];
+      std::lock_guard<std::mutex> queueLock(queue->mutex);
+      queue->chunks.push_back({begin, std::min(begin + grain, count)});
+    }
+    m_Generation++;
+  }
+  m_WorkAvailable.notify_all();
+  work(0);
+
+  // Workers still running hold chunks not yet finished; wait for them, and
+  // for every worker to leave work() so that job may go out of scope.
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_WorkDone.wait(lock, [&] { return m_Remaining == 0 && m_Busy == 0; });
+  m_Job = nullptr;
+}
+
+#else
+
+ThreadPool::ThreadPool(size_t) {}
+ThreadPool::~ThreadPool() {}
+
+size_t ThreadPool::threadCount() const { return 0; }
+
+size_t ThreadPool::hardwareThreadCount() { return 0; }
+
+void ThreadPool::parallelFor(size_t count, size_t, const Job &job) {
+  for (size_t i = 0; i < count; i++) {
+    job(i);
+  }
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef _RIVE_THREAD_POOL_HPP_
+#define _RIVE_THREAD_POOL_HPP_
+
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef RIVE_USE_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+// Runs the iterations of a loop across a set of worker threads. Iterations
+// are split into chunks dealt out to per thread queues; a thread works
+// through its own queue from the back and, once that's empty, steals chunks
+// from the front of the others', so uneven iterations still balance out. The
+// calling thread works along and returns once every iteration completed.
+//
+// Threads are only available in builds defining RIVE_USE_THREADS (the
+// threaded wasm build, or native builds); otherwise, or with no threads, the
+// loop simply runs on the calling thread.
+class ThreadPool {
+public:
+  using Job = std::function<void(size_t index)>;
+
+private:
+#ifdef RIVE_USE_THREADS
+  struct Chunk {
+    size_t begin, end;
+  };
+  // Chunks from head on are pending; the owner takes them from the back,
+  // thieves from the head.
+  struct Queue {
+    std::mutex mutex;
+    std::vector<Chunk> chunks;
+    size_t head = 0;
+  };
+
+  std::vector<std::thread> m_Threads;
+  // One queue per worker thread plus one for the calling thread, at 0.
+  std::vector<Queue *> m_Queues;
+  std::mutex m_Mutex;
+  std::condition_variable m_WorkAvailable;
+  std::condition_variable m_WorkDone;
+  uint64_t m_Generation = 0;
+  size_t m_Busy = 0;
+  bool m_Stopping = false;
+  const Job *m_Job = nullptr;
+  std::atomic<size_t> m_Remaining{0};
+
+  bool takeChunk(size_t queue, Chunk &chunk);
+  void work(size_t queue);
+  void workerMain(size_t queue);
+#endif
+
+public:
+  // Starts threadCount worker threads; 0 runs everything on the caller.
+  explicit ThreadPool(size_t threadCount);
+  ~ThreadPool();
+
+  size_t threadCount() const;
+
+  // Threads the hardware runs concurrently, 0 if unknown or in builds
+  // without threads.
+  static size_t hardwareThreadCount();
+
+  // Calls job for every index below count, in chunks of up to grain
+  // consecutive indices, and waits for them all to finish.
+  void parallelFor(size_t count, size_t grain, const Job &job);
+};
+
+#endif